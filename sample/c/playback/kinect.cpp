@@ -180,7 +180,7 @@ inline void kinect::update_frame()
             throw std::runtime_error( "Failed to get capture from device!" );
         }
         else if( result == k4a_wait_result_t::K4A_WAIT_RESULT_TIMEOUT ){
-            this->~kinect();
+            throw std::runtime_error( "Failed to get capture from device (timeout)!" );
         }
     }
     else{
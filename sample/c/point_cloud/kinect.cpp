@@ -121,7 +121,7 @@ void kinect::run()
         show();
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
         if( key == 'q' ){
             break;
@@ -167,7 +167,7 @@ inline void kinect::update_frame()
         throw std::runtime_error( "Failed to get capture from device!" );
     }
     else if( result == k4a_wait_result_t::K4A_WAIT_RESULT_TIMEOUT ){
-        this->~kinect();
+        throw std::runtime_error( "Failed to get capture from device (timeout)!" );
     }
 }
 
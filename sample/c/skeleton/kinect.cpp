@@ -124,7 +124,7 @@ void kinect::run()
         show();
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
         if( key == 'q' ){
             break;
@@ -164,7 +164,7 @@ inline void kinect::update_frame()
         throw std::runtime_error( "Failed to get capture from device!" );
     }
     else if( result == k4a_wait_result_t::K4A_WAIT_RESULT_TIMEOUT ){
-        this->~kinect();
+        throw std::runtime_error( "Failed to get capture from device (timeout)!" );
     }
 }
 
@@ -180,7 +180,7 @@ inline void kinect::update_body_tracking()
         throw std::runtime_error( "Failed to enqueue capture to tracker!" );
     }
     else if( result == k4a_wait_result_t::K4A_WAIT_RESULT_TIMEOUT ){
-        this->~kinect();
+        throw std::runtime_error( "Failed to enqueue capture to tracker (timeout)!" );
     }
 
     // Pop Body Tracking Result
@@ -189,7 +189,7 @@ inline void kinect::update_body_tracking()
         throw std::runtime_error( "Failed to pop result from tracker!" );
     }
     else if( result == k4a_wait_result_t::K4A_WAIT_RESULT_TIMEOUT ){
-        this->~kinect();
+        throw std::runtime_error( "Failed to pop result from tracker (timeout)!" );
     }
 }
 
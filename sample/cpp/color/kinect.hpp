@@ -4,6 +4,9 @@
 #include <k4a/k4a.hpp>
 #include <opencv2/opencv.hpp>
 
+#include "poller.hpp"
+#include "scheduler.hpp"
+
 class kinect
 {
 private:
@@ -12,6 +15,8 @@ private:
     k4a::capture capture;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
 
     // Color
     k4a::image color_image;
@@ -28,7 +33,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -47,7 +52,7 @@ private:
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Color
     void update_color();
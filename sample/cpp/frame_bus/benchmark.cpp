@@ -0,0 +1,130 @@
+#include "benchmark.hpp"
+#include "frame_bus.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Reader Result
+    struct reader_result
+    {
+        uint64_t frames = 0;
+        uint64_t torn_frames = 0;
+        uint64_t bytes = 0;
+        std::vector<double> latencies;
+    };
+
+    // Create Synthetic Image
+    k4a::image create_image( const k4a_image_format_t format, const int32_t width, const int32_t height, const int32_t bytes_per_pixel )
+    {
+        k4a::image image = k4a::image::create( format, width, height, width * bytes_per_pixel );
+        std::memset( image.get_buffer(), 0x5a, image.get_size() );
+        return image;
+    }
+
+    // Get Percentile
+    double percentile( std::vector<double> values, const double p )
+    {
+        if( values.empty() ){
+            return 0.0;
+        }
+
+        const size_t index = std::min( values.size() - 1, static_cast<size_t>( p * values.size() ) );
+        std::nth_element( values.begin(), values.begin() + index, values.end() );
+        return values[index];
+    }
+}
+
+// Benchmark
+void benchmark( const uint32_t readers, const uint32_t frames, const uint32_t fps )
+{
+    // Synthetic Calibration (720p color, NFOV unbinned depth)
+    k4a::calibration calibration = {};
+    calibration.depth_mode       = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    calibration.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    calibration.color_camera_calibration.resolution_width  = 1280;
+    calibration.color_camera_calibration.resolution_height = 720;
+    calibration.depth_camera_calibration.resolution_width  = 640;
+    calibration.depth_camera_calibration.resolution_height = 576;
+
+    // Synthetic Capture
+    k4a::capture capture = k4a::capture::create();
+    capture.set_color_image( create_image( k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32, 1280, 720, 4 ) );
+    capture.set_depth_image( create_image( k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16, 640, 576, 2 ) );
+    capture.set_ir_image( create_image( k4a_image_format_t::K4A_IMAGE_FORMAT_IR16, 640, 576, 2 ) );
+
+    // Create Writer
+    const std::string name = frame_bus::get_name( 0xbe );
+    std::unique_ptr<frame_bus::writer> writer( new frame_bus::writer( name, calibration, std::vector<uint8_t>() ) );
+
+    // Start Readers (each reader consumes frames by copying them out of shared memory)
+    std::atomic<uint32_t> ready( 0 );
+    std::vector<reader_result> results( readers );
+    std::vector<std::thread> threads;
+    for( uint32_t i = 0; i < readers; i++ ){
+        threads.emplace_back( [&, i](){
+            frame_bus::reader reader( name );
+            frame_bus::frame frame;
+            cv::Mat copy[frame_bus::stream::count];
+            ready++;
+
+            reader_result& result = results[i];
+            while( reader.read( frame, std::chrono::milliseconds( 1000 ) ) ){
+                result.latencies.push_back( ( frame_bus::now_nsec() - frame.publish_timestamp_nsec ) / 1000000.0 );
+                for( uint32_t j = 0; j < frame_bus::stream::count; j++ ){
+                    frame.images[j].copyTo( copy[j] );
+                    result.bytes += frame.descriptors[j].size;
+                }
+
+                if( !frame.is_valid() ){
+                    result.torn_frames++;
+                }
+                result.frames++;
+            }
+        } );
+    }
+
+    while( ready < readers ){
+        std::this_thread::yield();
+    }
+
+    // Publish Frames
+    double publish_time = 0.0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( uint32_t i = 0; i < frames; i++ ){
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        writer->publish( capture );
+        publish_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin ).count();
+
+        if( fps ){
+            std::this_thread::sleep_until( start + std::chrono::microseconds( 1000000 / fps ) * ( i + 1 ) );
+        }
+    }
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    const double frame_size = static_cast<double>( capture.get_color_image().get_size() + capture.get_depth_image().get_size() + capture.get_ir_image().get_size() );
+
+    // Stop Readers
+    writer.reset();
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    // Report
+    std::cout << "writer : " << frames << " frames, " << frames / elapsed << " fps, "
+              << frames * frame_size / elapsed / ( 1024.0 * 1024.0 ) << " MB/s, "
+              << publish_time / frames << " ms/publish" << std::endl;
+    for( uint32_t i = 0; i < readers; i++ ){
+        const reader_result& result = results[i];
+        std::cout << "reader " << i << " : " << result.frames << " frames ("
+                  << frames - std::min<uint64_t>( frames, result.frames ) << " skipped, " << result.torn_frames << " torn), "
+                  << result.bytes / elapsed / ( 1024.0 * 1024.0 ) << " MB/s, latency p50 "
+                  << percentile( result.latencies, 0.50 ) << " ms, p99 "
+                  << percentile( result.latencies, 0.99 ) << " ms" << std::endl;
+    }
+}
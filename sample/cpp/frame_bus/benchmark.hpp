@@ -0,0 +1,9 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+
+// Benchmark One Writer and N Readers with Synthetic 720p BGRA + NFOV Depth + IR Frames
+void benchmark( const uint32_t readers, const uint32_t frames = 1000, const uint32_t fps = 0 );
+
+#endif // __BENCHMARK__
@@ -0,0 +1,371 @@
+#include "frame_bus.hpp"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace frame_bus
+{
+    // Round Up to Alignment
+    static inline uint64_t align( const uint64_t size )
+    {
+        return ( size + alignment - 1 ) / alignment * alignment;
+    }
+
+    // Constructor
+    region::region()
+        : data( nullptr ),
+          size( 0 ),
+          owner( false )
+          #ifdef _WIN32
+          , mapping( nullptr )
+          #endif
+    {
+    }
+
+    // Destructor
+    region::~region()
+    {
+        // Close
+        close();
+    }
+
+    // Create
+    void region::create( const std::string& name, const uint64_t size )
+    {
+        this->name = name;
+        this->size = size;
+        owner = true;
+
+        #ifdef _WIN32
+        // Create File Mapping backed by Paging File
+        mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>( size >> 32 ), static_cast<DWORD>( size & 0xffffffff ), name.c_str() );
+        if( !mapping ){
+            throw k4a::error( "Failed to create shared memory!" );
+        }
+
+        data = static_cast<uint8_t*>( MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size ) );
+        #else
+        // Remove Stale Region of Previous Writer
+        shm_unlink( name.c_str() );
+
+        // Create Shared Memory Object
+        const int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666 );
+        if( fd < 0 ){
+            throw k4a::error( "Failed to create shared memory!" );
+        }
+
+        if( ftruncate( fd, static_cast<off_t>( size ) ) != 0 ){
+            ::close( fd );
+            shm_unlink( name.c_str() );
+            throw k4a::error( "Failed to resize shared memory!" );
+        }
+
+        void* address = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        ::close( fd );
+        data = ( address == MAP_FAILED ) ? nullptr : static_cast<uint8_t*>( address );
+        #endif
+
+        if( !data ){
+            close();
+            throw k4a::error( "Failed to map shared memory!" );
+        }
+    }
+
+    // Open
+    void region::open( const std::string& name )
+    {
+        this->name = name;
+        owner = false;
+
+        #ifdef _WIN32
+        // Open File Mapping
+        mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, name.c_str() );
+        if( !mapping ){
+            throw k4a::error( "Failed to open shared memory!" );
+        }
+
+        // Map Header to Get Region Size
+        const header* head = static_cast<const header*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, sizeof( header ) ) );
+        if( !head ){
+            close();
+            throw k4a::error( "Failed to map shared memory!" );
+        }
+        size = head->region_size;
+        UnmapViewOfFile( head );
+
+        data = static_cast<uint8_t*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, size ) );
+        #else
+        // Open Shared Memory Object
+        const int fd = shm_open( name.c_str(), O_RDONLY, 0 );
+        if( fd < 0 ){
+            throw k4a::error( "Failed to open shared memory!" );
+        }
+
+        struct stat status;
+        if( fstat( fd, &status ) != 0 || static_cast<uint64_t>( status.st_size ) < sizeof( header ) ){
+            ::close( fd );
+            throw k4a::error( "Failed to open shared memory!" );
+        }
+        size = static_cast<uint64_t>( status.st_size );
+
+        void* address = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+        ::close( fd );
+        data = ( address == MAP_FAILED ) ? nullptr : static_cast<uint8_t*>( address );
+        #endif
+
+        if( !data ){
+            close();
+            throw k4a::error( "Failed to map shared memory!" );
+        }
+    }
+
+    // Close
+    void region::close()
+    {
+        #ifdef _WIN32
+        if( data ){
+            UnmapViewOfFile( data );
+        }
+
+        if( mapping ){
+            CloseHandle( mapping );
+            mapping = nullptr;
+        }
+        #else
+        if( data ){
+            munmap( data, size );
+        }
+
+        if( owner && !name.empty() ){
+            shm_unlink( name.c_str() );
+        }
+        #endif
+
+        data = nullptr;
+        size = 0;
+        owner = false;
+    }
+
+    // Constructor
+    writer::writer( const std::string& name, const k4a::calibration& calibration, const std::vector<uint8_t>& raw_calibration, const uint32_t slot_count )
+        : head( nullptr ),
+          frame_number( 0 )
+    {
+        if( slot_count < 2 ){
+            throw k4a::error( "Failed to create frame bus with less than 2 slots!" );
+        }
+
+        if( raw_calibration.size() > sizeof( header::calibration ) ){
+            throw k4a::error( "Failed to store calibration to frame bus!" );
+        }
+
+        // Compute Largest Payload (color is reserved as BGRA, compressed formats are smaller)
+        const uint64_t color_size    = static_cast<uint64_t>( calibration.color_camera_calibration.resolution_width ) * calibration.color_camera_calibration.resolution_height * 4;
+        const uint64_t depth_size    = static_cast<uint64_t>( calibration.depth_camera_calibration.resolution_width ) * calibration.depth_camera_calibration.resolution_height * 2;
+        const uint64_t infrared_size = depth_size;
+        const uint64_t slot_size     = align( sizeof( slot_descriptor ) ) + align( color_size ) + align( depth_size ) + align( infrared_size );
+        const uint64_t region_size   = align( sizeof( header ) ) + slot_size * slot_count;
+
+        // Create Shared Memory
+        shm.create( name, region_size );
+
+        // Initialize Slots
+        for( uint32_t i = 0; i < slot_count; i++ ){
+            slot_descriptor* slot = new( shm.get() + align( sizeof( header ) ) + slot_size * i ) slot_descriptor();
+            slot->sequence.store( 0, std::memory_order_relaxed );
+        }
+
+        // Initialize Header
+        head = new( shm.get() ) header();
+        head->magic            = magic;
+        head->version          = version;
+        head->slot_count       = slot_count;
+        head->slot_size        = slot_size;
+        head->region_size      = region_size;
+        head->depth_mode       = calibration.depth_mode;
+        head->color_resolution = calibration.color_resolution;
+        head->calibration_size = raw_calibration.size();
+        if( !raw_calibration.empty() ){
+            std::memcpy( head->calibration, raw_calibration.data(), raw_calibration.size() );
+        }
+        head->head.store( 0, std::memory_order_relaxed );
+        head->writer_alive.store( 1, std::memory_order_release );
+    }
+
+    // Destructor
+    writer::~writer()
+    {
+        if( head ){
+            // Notify Readers
+            head->writer_alive.store( 0, std::memory_order_release );
+        }
+    }
+
+    // Get Slot
+    slot_descriptor* writer::get_slot( const uint64_t number )
+    {
+        const uint64_t index = number % head->slot_count;
+        return reinterpret_cast<slot_descriptor*>( shm.get() + align( sizeof( header ) ) + head->slot_size * index );
+    }
+
+    // Publish Capture
+    void writer::publish( const k4a::capture& capture )
+    {
+        // Frame Numbers start from 1 (head = 0 means nothing published)
+        const uint64_t number = ++frame_number;
+        slot_descriptor* slot = get_slot( number );
+
+        // Begin Write (odd sequence)
+        slot->sequence.store( number * 2 - 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        // Write Images
+        uint64_t offset = align( sizeof( slot_descriptor ) );
+        write_image( slot, slot->images[stream::color],    capture.get_color_image(), offset );
+        write_image( slot, slot->images[stream::depth],    capture.get_depth_image(), offset );
+        write_image( slot, slot->images[stream::infrared], capture.get_ir_image(),    offset );
+        slot->frame_number = number;
+        slot->publish_timestamp_nsec = now_nsec();
+
+        // End Write (even sequence)
+        slot->sequence.store( number * 2, std::memory_order_release );
+
+        // Advance Head
+        head->head.store( number, std::memory_order_release );
+    }
+
+    // Write Image
+    void writer::write_image( slot_descriptor* slot, image_descriptor& descriptor, const k4a::image& image, uint64_t& offset )
+    {
+        std::memset( &descriptor, 0, sizeof( image_descriptor ) );
+        if( !image.handle() ){
+            return;
+        }
+
+        // Copy Image Buffer
+        const uint64_t size = image.get_size();
+        if( offset + size > head->slot_size ){
+            throw k4a::error( "Failed to publish image larger than slot!" );
+        }
+        std::memcpy( reinterpret_cast<uint8_t*>( slot ) + offset, image.get_buffer(), size );
+
+        // Fill Descriptor
+        descriptor.format                = image.get_format();
+        descriptor.width                 = image.get_width_pixels();
+        descriptor.height                = image.get_height_pixels();
+        descriptor.stride                = image.get_stride_bytes();
+        descriptor.offset                = offset;
+        descriptor.size                  = size;
+        descriptor.device_timestamp_usec = image.get_device_timestamp().count();
+        descriptor.system_timestamp_nsec = image.get_system_timestamp().count();
+
+        offset += align( size );
+    }
+
+    // Constructor
+    reader::reader( const std::string& name )
+        : head( nullptr ),
+          last_frame_number( 0 )
+    {
+        // Open Shared Memory
+        shm.open( name );
+
+        // Check Header
+        head = reinterpret_cast<const header*>( shm.get() );
+        if( head->magic != magic || head->version != version || head->region_size > shm.get_size() ){
+            throw k4a::error( "Failed to open incompatible frame bus!" );
+        }
+    }
+
+    // Get Calibration
+    k4a::calibration reader::get_calibration() const
+    {
+        std::vector<uint8_t> raw_calibration( head->calibration, head->calibration + head->calibration_size );
+        raw_calibration.push_back( '\0' );
+        return k4a::calibration::get_from_raw( reinterpret_cast<char*>( raw_calibration.data() ), raw_calibration.size(), static_cast<k4a_depth_mode_t>( head->depth_mode ), static_cast<k4a_color_resolution_t>( head->color_resolution ) );
+    }
+
+    // Get Slot
+    const slot_descriptor* reader::get_slot( const uint64_t number ) const
+    {
+        const uint64_t index = number % head->slot_count;
+        return reinterpret_cast<const slot_descriptor*>( shm.get() + align( sizeof( header ) ) + head->slot_size * index );
+    }
+
+    // Read
+    bool reader::read( frame& output, const std::chrono::milliseconds time_out )
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + time_out;
+        while( true ){
+            // Read Latest Published Frame
+            const uint64_t number = head->head.load( std::memory_order_acquire );
+            if( number > last_frame_number && try_read( number, output ) ){
+                last_frame_number = number;
+                return true;
+            }
+
+            if( !is_writer_alive() || std::chrono::steady_clock::now() >= deadline ){
+                return false;
+            }
+
+            // Writer never blocks on readers, so readers poll with short sleep
+            std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+        }
+    }
+
+    // Try Read
+    bool reader::try_read( const uint64_t number, frame& output ) const
+    {
+        const slot_descriptor* slot = get_slot( number );
+
+        // Check Slot holds Requested Frame
+        const uint64_t sequence = slot->sequence.load( std::memory_order_acquire );
+        if( sequence != number * 2 ){
+            return false;
+        }
+
+        // Copy Descriptors
+        output.frame_number           = slot->frame_number;
+        output.publish_timestamp_nsec = slot->publish_timestamp_nsec;
+        std::memcpy( output.descriptors, slot->images, sizeof( output.descriptors ) );
+        output.slot     = slot;
+        output.sequence = sequence;
+
+        // Check Descriptors were not Torn
+        if( !output.is_valid() ){
+            return false;
+        }
+
+        // Create Zero-Copy Views
+        for( uint32_t i = 0; i < stream::count; i++ ){
+            const image_descriptor& descriptor = output.descriptors[i];
+            uint8_t* buffer = const_cast<uint8_t*>( reinterpret_cast<const uint8_t*>( slot ) + descriptor.offset );
+            switch( descriptor.format ){
+                case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                    output.images[i] = cv::Mat( descriptor.height, descriptor.width, CV_8UC4, buffer, descriptor.stride );
+                    break;
+                case k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16:
+                case k4a_image_format_t::K4A_IMAGE_FORMAT_IR16:
+                    output.images[i] = cv::Mat( descriptor.height, descriptor.width, CV_16UC1, buffer, descriptor.stride );
+                    break;
+                default:
+                    // NOTE: Compressed or planar formats are exposed as raw bytes.
+                    output.images[i] = descriptor.size ? cv::Mat( 1, static_cast<int32_t>( descriptor.size ), CV_8UC1, buffer ) : cv::Mat();
+                    break;
+            }
+        }
+
+        return true;
+    }
+}
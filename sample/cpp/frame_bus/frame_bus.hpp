@@ -0,0 +1,212 @@
+#ifndef __FRAME_BUS__
+#define __FRAME_BUS__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+ This is shared memory frame bus that publishes captures of one device to any number of local processes.
+
+ The region is laid out as a header followed by a fixed number of slots.
+ Each slot is guarded by a sequence lock, writer never waits for readers.
+
+   [header][slot 0 (descriptor + payload)][slot 1]...[slot N-1]
+
+ Writer : sequence = 2n + 1 (writing) -> copy payload -> sequence = 2n + 2 (published) -> head = n
+ Reader : load head -> load sequence (must be even) -> read payload -> load sequence again (must be same)
+*/
+
+namespace frame_bus
+{
+    // Stream
+    enum stream : uint32_t
+    {
+        color = 0,
+        depth,
+        infrared,
+        count
+    };
+
+    // Image Descriptor
+    struct image_descriptor
+    {
+        int32_t  format;
+        int32_t  width;
+        int32_t  height;
+        int32_t  stride;
+        uint64_t offset;
+        uint64_t size;
+        int64_t  device_timestamp_usec;
+        int64_t  system_timestamp_nsec;
+    };
+
+    // Slot Descriptor
+    struct slot_descriptor
+    {
+        std::atomic<uint64_t> sequence;
+        uint64_t frame_number;
+        int64_t  publish_timestamp_nsec;
+        image_descriptor images[stream::count];
+    };
+
+    // Header
+    struct header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t reserved;
+        uint64_t slot_size;
+        uint64_t region_size;
+        int32_t  depth_mode;
+        int32_t  color_resolution;
+        uint64_t calibration_size;
+        char     calibration[16384];
+        std::atomic<uint64_t> head;
+        std::atomic<uint32_t> writer_alive;
+    };
+
+    constexpr uint32_t magic   = 0x4b344246; // "K4BF"
+    constexpr uint32_t version = 1;
+    constexpr uint64_t alignment = 4096;
+
+    static_assert( ATOMIC_LLONG_LOCK_FREE == 2, "frame bus requires address-free 64-bit atomics" );
+
+    // Get Monotonic Timestamp (shared by all processes on the host)
+    inline int64_t now_nsec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    // Shared Memory Region
+    class region
+    {
+    private:
+        std::string name;
+        uint8_t* data;
+        uint64_t size;
+        bool owner;
+        #ifdef _WIN32
+        void* mapping;
+        #endif
+
+    public:
+        // Constructor
+        region();
+
+        // Destructor
+        ~region();
+
+        // Create (Writer)
+        void create( const std::string& name, const uint64_t size );
+
+        // Open (Reader)
+        void open( const std::string& name );
+
+        // Close
+        void close();
+
+        // Get Pointer
+        uint8_t* get() const { return data; }
+
+        // Get Size
+        uint64_t get_size() const { return size; }
+
+    private:
+        region( const region& ) = delete;
+        region& operator=( const region& ) = delete;
+    };
+
+    // Frame (Zero-Copy View into Shared Memory)
+    struct frame
+    {
+        uint64_t frame_number = 0;
+        int64_t  publish_timestamp_nsec = 0;
+        image_descriptor descriptors[stream::count] = {};
+        cv::Mat images[stream::count];
+        const slot_descriptor* slot = nullptr;
+        uint64_t sequence = 0;
+
+        // Check Frame was not Overwritten while Reading (call after processing views)
+        bool is_valid() const
+        {
+            std::atomic_thread_fence( std::memory_order_acquire );
+            return slot && slot->sequence.load( std::memory_order_relaxed ) == sequence;
+        }
+    };
+
+    // Writer
+    class writer
+    {
+    private:
+        region shm;
+        header* head;
+        uint64_t frame_number;
+
+    public:
+        // Constructor
+        writer( const std::string& name, const k4a::calibration& calibration, const std::vector<uint8_t>& raw_calibration, const uint32_t slot_count = 8 );
+
+        // Destructor
+        ~writer();
+
+        // Publish Capture
+        void publish( const k4a::capture& capture );
+
+        // Get Number of Published Frames
+        uint64_t get_frame_number() const { return frame_number; }
+
+    private:
+        // Get Slot
+        slot_descriptor* get_slot( const uint64_t number );
+
+        // Write Image
+        void write_image( slot_descriptor* slot, image_descriptor& descriptor, const k4a::image& image, uint64_t& offset );
+    };
+
+    // Reader
+    class reader
+    {
+    private:
+        region shm;
+        const header* head;
+        uint64_t last_frame_number;
+
+    public:
+        // Constructor
+        reader( const std::string& name );
+
+        // Wait and Read Latest Frame (returns false on timeout or writer exit)
+        bool read( frame& output, const std::chrono::milliseconds time_out );
+
+        // Get Calibration
+        k4a::calibration get_calibration() const;
+
+        // Check Writer is Alive
+        bool is_writer_alive() const { return head->writer_alive.load( std::memory_order_acquire ) != 0; }
+
+    private:
+        // Get Slot
+        const slot_descriptor* get_slot( const uint64_t number ) const;
+
+        // Try Read
+        bool try_read( const uint64_t number, frame& output ) const;
+    };
+
+    // Get Shared Memory Name of Device
+    inline std::string get_name( const uint32_t device_index )
+    {
+        #ifdef _WIN32
+        return "Local\\k4a_frame_bus_" + std::to_string( device_index );
+        #else
+        return "/k4a_frame_bus_" + std::to_string( device_index );
+        #endif
+    }
+}
+
+#endif // __FRAME_BUS__
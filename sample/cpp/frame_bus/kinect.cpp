@@ -0,0 +1,216 @@
+#include "kinect.hpp"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Constructor
+kinect::kinect( const uint32_t index )
+    : device_index( index ),
+      publish_time( 0.0 )
+{
+    // Initialize
+    initialize();
+}
+
+kinect::~kinect()
+{
+    // Finalize
+    finalize();
+}
+
+// Initialize
+void kinect::initialize()
+{
+    // Initialize Sensor
+    initialize_sensor();
+
+    // Initialize Frame Bus
+    initialize_frame_bus();
+}
+
+// Initialize Sensor
+inline void kinect::initialize_sensor()
+{
+    // Get Connected Devices
+    const int32_t device_count = k4a::device::get_installed_count();
+    if( device_count == 0 ){
+        throw k4a::error( "Failed to found device!" );
+    }
+
+    // Open Default Device
+    device = k4a::device::open( device_index );
+
+    // Start Cameras with Configuration
+    device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    device_configuration.color_format             = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
+    device_configuration.color_resolution         = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    device_configuration.depth_mode               = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    device_configuration.synchronized_images_only = true;
+    device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    device.start_cameras( &device_configuration );
+
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
+    // Get Calibration
+    calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
+}
+
+// Initialize Frame Bus
+inline void kinect::initialize_frame_bus()
+{
+    // Create Frame Bus Writer
+    const std::string name = frame_bus::get_name( device_index );
+    writer.reset( new frame_bus::writer( name, calibration, device.get_raw_calibration() ) );
+    std::cout << "publish to " << name << std::endl;
+}
+
+// Finalize
+void kinect::finalize()
+{
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Report Publish Time
+    if( writer && writer->get_frame_number() ){
+        std::cout << "published " << writer->get_frame_number() << " frames, "
+                  << publish_time / writer->get_frame_number() << " ms/frame" << std::endl;
+    }
+
+    // Destroy Frame Bus Writer
+    writer.reset();
+
+    // Stop Cameras
+    device.stop_cameras();
+
+    // Close Device
+    device.close();
+
+    // Close Window
+    cv::destroyAllWindows();
+}
+
+// Run
+void kinect::run()
+{
+    // Main Loop
+    bool updated = false;
+    while( true ){
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
+
+        // Show
+        if( updated ){
+            show();
+            updated = false;
+        }
+
+        // Wait Key
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            break;
+        }
+    }
+}
+
+// Update
+bool kinect::update()
+{
+    // Update Frame
+    if( !update_frame() ){
+        return false;
+    }
+
+    // Publish Frame
+    publish_frame();
+
+    // Update Depth
+    update_depth();
+
+    // Release Capture Handle
+    capture.reset();
+
+    return true;
+}
+
+// Update Frame
+inline bool kinect::update_frame()
+{
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
+}
+
+// Publish Frame
+inline void kinect::publish_frame()
+{
+    // Publish Capture to Frame Bus
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    writer->publish( capture );
+    publish_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
+// Update Depth
+inline void kinect::update_depth()
+{
+    // Get Depth Image
+    depth_image = capture.get_depth_image();
+}
+
+// Draw
+void kinect::draw()
+{
+    // Draw Depth
+    draw_depth();
+}
+
+// Draw Depth
+inline void kinect::draw_depth()
+{
+    if( !depth_image.handle() ){
+        return;
+    }
+
+    // Get cv::Mat from k4a::image
+    depth = k4a::get_mat( depth_image );
+
+    // Release Depth Image Handle
+    depth_image.reset();
+}
+
+// Show
+void kinect::show()
+{
+    // Show Depth
+    show_depth();
+}
+
+// Show Depth
+inline void kinect::show_depth()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Scaling Depth
+    depth.convertTo( depth, CV_8U, -255.0 / 5000.0, 255.0 );
+
+    // Show Image
+    const cv::String window_name = cv::format( "depth (kinect %d)", device_index );
+    cv::imshow( window_name, depth );
+}
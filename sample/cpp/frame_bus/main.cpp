@@ -0,0 +1,37 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "kinect.hpp"
+#include "subscriber.hpp"
+#include "benchmark.hpp"
+
+int main( int argc, char* argv[] )
+{
+    try{
+        const std::string mode = ( argc > 1 ) ? argv[1] : "publish";
+        if( mode == "subscribe" ){
+            // Reader (run any number of processes)
+            subscriber subscriber;
+            subscriber.run();
+        }
+        else if( mode == "benchmark" ){
+            // One Writer and N Readers without Device
+            const uint32_t readers = ( argc > 2 ) ? std::atoi( argv[2] ) : 1;
+            const uint32_t frames  = ( argc > 3 ) ? std::atoi( argv[3] ) : 1000;
+            const uint32_t fps     = ( argc > 4 ) ? std::atoi( argv[4] ) : 0;
+            benchmark( readers, frames, fps );
+        }
+        else{
+            // Writer
+            kinect kinect;
+            kinect.run();
+        }
+    }
+    catch( const k4a::error& error ){
+        std::cout << error.what() << std::endl;
+    }
+
+    return 0;
+}
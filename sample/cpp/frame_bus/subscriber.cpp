@@ -0,0 +1,146 @@
+#include "subscriber.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+// Constructor
+subscriber::subscriber( const uint32_t index )
+    : reader( frame_bus::get_name( index ) ),
+      device_index( index ),
+      frames( 0 ),
+      dropped_frames( 0 ),
+      torn_frames( 0 ),
+      bytes( 0 ),
+      last_frame_number( 0 ),
+      latency( 0.0 ),
+      max_latency( 0.0 ),
+      start( std::chrono::steady_clock::now() )
+{
+}
+
+// Destructor
+subscriber::~subscriber()
+{
+    // Report Statistics
+    report_statistics();
+
+    // Close Window
+    cv::destroyAllWindows();
+}
+
+// Run
+void subscriber::run()
+{
+    // Main Loop
+    while( true ){
+        // Update
+        if( !update() ){
+            break;
+        }
+
+        // Draw
+        draw();
+
+        // Show
+        show();
+
+        // Wait Key
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            break;
+        }
+    }
+}
+
+// Update
+bool subscriber::update()
+{
+    // Read Latest Frame
+    constexpr std::chrono::milliseconds time_out( 1000 );
+    while( !reader.read( frame, time_out ) ){
+        if( !reader.is_writer_alive() ){
+            return false;
+        }
+    }
+
+    // Update Statistics
+    update_statistics();
+
+    return true;
+}
+
+// Update Statistics
+inline void subscriber::update_statistics()
+{
+    const double frame_latency = ( frame_bus::now_nsec() - frame.publish_timestamp_nsec ) / 1000000.0;
+    latency += frame_latency;
+    max_latency = std::max( max_latency, frame_latency );
+
+    if( last_frame_number && frame.frame_number > last_frame_number + 1 ){
+        dropped_frames += frame.frame_number - last_frame_number - 1;
+    }
+    last_frame_number = frame.frame_number;
+
+    for( const frame_bus::image_descriptor& descriptor : frame.descriptors ){
+        bytes += descriptor.size;
+    }
+
+    // Report Statistics every 100 Frames
+    if( ++frames % 100 == 0 ){
+        report_statistics();
+    }
+}
+
+// Report Statistics
+inline void subscriber::report_statistics()
+{
+    if( frames == 0 ){
+        return;
+    }
+
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    std::cout << "frames "    << frames
+              << ", fps "     << frames / elapsed
+              << ", MB/s "    << bytes / elapsed / ( 1024.0 * 1024.0 )
+              << ", latency " << latency / frames << " ms (max " << max_latency << " ms)"
+              << ", dropped " << dropped_frames
+              << ", torn "    << torn_frames << std::endl;
+}
+
+// Draw
+void subscriber::draw()
+{
+    const cv::Mat& view = frame.images[frame_bus::stream::depth];
+    if( view.empty() ){
+        return;
+    }
+
+    // Scaling Depth (reads directly from shared memory)
+    view.convertTo( depth, CV_8U, -255.0 / 5000.0, 255.0 );
+
+    // Discard Frame if Writer Overwrote Slot while Reading
+    if( !frame.is_valid() ){
+        depth.release();
+        torn_frames++;
+    }
+}
+
+// Show
+void subscriber::show()
+{
+    // Show Depth
+    show_depth();
+}
+
+// Show Depth
+inline void subscriber::show_depth()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Show Image
+    const cv::String window_name = cv::format( "depth (frame bus %d)", device_index );
+    cv::imshow( window_name, depth );
+}
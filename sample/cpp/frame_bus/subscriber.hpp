@@ -0,0 +1,62 @@
+#ifndef __SUBSCRIBER__
+#define __SUBSCRIBER__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+
+#include "frame_bus.hpp"
+
+class subscriber
+{
+private:
+    // Frame Bus
+    frame_bus::reader reader;
+    frame_bus::frame frame;
+    uint32_t device_index;
+
+    // Depth
+    cv::Mat depth;
+
+    // Statistics
+    uint64_t frames;
+    uint64_t dropped_frames;
+    uint64_t torn_frames;
+    uint64_t bytes;
+    uint64_t last_frame_number;
+    double latency;
+    double max_latency;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    // Constructor
+    subscriber( const uint32_t index = K4A_DEVICE_DEFAULT );
+
+    // Destructor
+    ~subscriber();
+
+    // Run
+    void run();
+
+    // Update
+    bool update();
+
+    // Draw
+    void draw();
+
+    // Show
+    void show();
+
+private:
+    // Update Statistics
+    void update_statistics();
+
+    // Report Statistics
+    void report_statistics();
+
+    // Show Depth
+    void show_depth();
+};
+
+#endif // __SUBSCRIBER__
@@ -0,0 +1,71 @@
+#include "benchmark.hpp"
+#include "imu.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Benchmark
+void benchmark( const std::string& file, const size_t batch_size )
+{
+    // Batch Size (0 would never drain ring)
+    const size_t count = std::max<size_t>( batch_size, 1 );
+
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+
+    // Start Reader Thread and Consume Samples in Batches as Fast as Possible
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t samples = 0;
+    uint64_t batches = 0;
+    uint64_t first_timestamp = 0;
+    uint64_t last_timestamp = 0;
+    double integrate_time = 0.0;
+    double read_time = 0.0;
+    {
+        imu::reader reader( &playback );
+        imu::integrator integrator;
+        std::vector<imu::sample> batch;
+        batch.reserve( count );
+        while( !reader.is_finished() ){
+            batch.clear();
+            if( !reader.read( batch, count ) ){
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Integrate Orientation over Batch
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            integrator.integrate( batch );
+            integrate_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin ).count();
+
+            if( !samples ){
+                first_timestamp = batch.front().gyro_timestamp_usec;
+            }
+            last_timestamp = batch.back().gyro_timestamp_usec;
+            samples += batch.size();
+            batches++;
+        }
+        read_time = reader.get_read_time();
+    }
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    // Close Playback
+    playback.close();
+
+    if( !samples ){
+        std::cout << "no imu samples in " << file << std::endl;
+        return;
+    }
+
+    // Report Throughput
+    // Recorded Rate is rate of device (~1.6 kHz), Realtime is how many times faster than device ingestion runs.
+    const double duration = ( last_timestamp - first_timestamp ) / 1000000.0;
+    std::cout << "samples    : " << samples << " (" << duration << " s recorded, " << samples / std::max( duration, 1e-6 ) << " Hz)" << std::endl;
+    std::cout << "throughput : " << samples / elapsed << " samples/s (" << duration / elapsed << "x realtime)" << std::endl;
+    std::cout << "read       : " << read_time * 1000.0 / samples << " us/sample (reader thread)" << std::endl;
+    std::cout << "integrate  : " << integrate_time * 1000.0 / samples << " us/sample"
+              << ", " << static_cast<double>( samples ) / batches << " samples/batch" << std::endl;
+}
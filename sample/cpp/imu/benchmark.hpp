@@ -0,0 +1,9 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <string>
+
+// Benchmark IMU Ingestion (reader thread -> ring -> batched integration) on Recorded IMU Track
+void benchmark( const std::string& file, const size_t batch_size = 64 );
+
+#endif // __BENCHMARK__
@@ -0,0 +1,306 @@
+#include "imu.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace imu
+{
+    // Multiply
+    quaternion quaternion::operator*( const quaternion& q ) const
+    {
+        quaternion result;
+        result.w = w * q.w - x * q.x - y * q.y - z * q.z;
+        result.x = w * q.x + x * q.w + y * q.z - z * q.y;
+        result.y = w * q.y - x * q.z + y * q.w + z * q.x;
+        result.z = w * q.z + x * q.y - y * q.x + z * q.w;
+        return result;
+    }
+
+    // Normalize
+    quaternion quaternion::normalize() const
+    {
+        const double norm = std::sqrt( w * w + x * x + y * y + z * z );
+        if( norm <= 0.0 ){
+            return quaternion();
+        }
+
+        quaternion result;
+        result.w = w / norm;
+        result.x = x / norm;
+        result.y = y / norm;
+        result.z = z / norm;
+        return result;
+    }
+
+    // Conjugate
+    quaternion quaternion::conjugate() const
+    {
+        quaternion result;
+        result.w = w;
+        result.x = -x;
+        result.y = -y;
+        result.z = -z;
+        return result;
+    }
+
+    // Get Angle
+    double quaternion::angle() const
+    {
+        return 2.0 * std::acos( std::min( 1.0, std::abs( w ) ) );
+    }
+
+    // Convert to Rotation Matrix
+    cv::Matx33f quaternion::to_matrix() const
+    {
+        return cv::Matx33f(
+            static_cast<float>( 1.0 - 2.0 * ( y * y + z * z ) ), static_cast<float>( 2.0 * ( x * y - w * z ) ), static_cast<float>( 2.0 * ( x * z + w * y ) ),
+            static_cast<float>( 2.0 * ( x * y + w * z ) ), static_cast<float>( 1.0 - 2.0 * ( x * x + z * z ) ), static_cast<float>( 2.0 * ( y * z - w * x ) ),
+            static_cast<float>( 2.0 * ( x * z - w * y ) ), static_cast<float>( 2.0 * ( y * z + w * x ) ), static_cast<float>( 1.0 - 2.0 * ( x * x + y * y ) )
+        );
+    }
+
+    // Create from Rotation Vector
+    quaternion quaternion::from_rotation_vector( const double x, const double y, const double z )
+    {
+        quaternion result;
+        const double angle = std::sqrt( x * x + y * y + z * z );
+        if( angle < 1e-12 ){
+            // Small Angle Approximation
+            result.x = x * 0.5;
+            result.y = y * 0.5;
+            result.z = z * 0.5;
+            return result.normalize();
+        }
+
+        const double scale = std::sin( angle * 0.5 ) / angle;
+        result.w = std::cos( angle * 0.5 );
+        result.x = x * scale;
+        result.y = y * scale;
+        result.z = z * scale;
+        return result;
+    }
+
+    // Constructor (Device)
+    reader::reader( k4a::device* device, const size_t capacity )
+        : device( device ),
+          playback( nullptr ),
+          ring( capacity ),
+          running( false ),
+          finished( false ),
+          produced( 0 ),
+          dropped( 0 ),
+          read_time_nsec( 0 )
+    {
+        if( !device ){
+            throw k4a::error( "Failed to create imu reader (device is not opened)!" );
+        }
+
+        // Start IMU (requires cameras to be started)
+        device->start_imu();
+
+        // Start Thread
+        start();
+    }
+
+    // Constructor (Playback)
+    reader::reader( k4a::playback* playback, const size_t capacity )
+        : device( nullptr ),
+          playback( playback ),
+          ring( capacity ),
+          running( false ),
+          finished( false ),
+          produced( 0 ),
+          dropped( 0 ),
+          read_time_nsec( 0 )
+    {
+        if( !playback ){
+            throw k4a::error( "Failed to create imu reader (playback is not opened)!" );
+        }
+
+        if( !playback->get_record_configuration().imu_track_enabled ){
+            throw k4a::error( "Failed to create imu reader (recording has no imu track)!" );
+        }
+
+        // Start Thread
+        start();
+    }
+
+    // Destructor
+    reader::~reader()
+    {
+        // Stop Thread
+        stop();
+
+        // Stop IMU
+        if( device ){
+            device->stop_imu();
+        }
+    }
+
+    // Start Thread
+    void reader::start()
+    {
+        running = true;
+        thread = std::thread( [this](){
+            if( device ){
+                read_device();
+            }
+            else{
+                read_playback();
+            }
+        } );
+    }
+
+    // Stop Thread
+    void reader::stop()
+    {
+        running = false;
+        if( thread.joinable() ){
+            thread.join();
+        }
+    }
+
+    // Read Device
+    void reader::read_device()
+    {
+        // NOTE: Exception can not cross thread boundary, failure of device ends reading.
+        try{
+            sample imu_sample;
+            while( running ){
+                // Wait Sample (timeout lets thread notice stop request)
+                constexpr std::chrono::milliseconds time_out( 10 );
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                const bool result = device->get_imu_sample( &imu_sample, time_out );
+                read_time_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+                if( !result ){
+                    continue;
+                }
+
+                // Push Sample (drop newest while consumer is behind, device would overflow otherwise)
+                if( ring.push( imu_sample ) ){
+                    produced++;
+                }
+                else{
+                    dropped++;
+                }
+            }
+        }
+        catch( const k4a::error& error ){
+            std::cerr << error.what() << std::endl;
+        }
+
+        finished = true;
+    }
+
+    // Read Playback
+    void reader::read_playback()
+    {
+        try{
+            sample imu_sample;
+            while( running ){
+                // Read Next Sample
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                const bool result = playback->get_next_imu_sample( &imu_sample );
+                read_time_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+                if( !result ){
+                    // EOF
+                    break;
+                }
+
+                // Push Sample (recording is lossless, wait for space)
+                bool pushed = ring.push( imu_sample );
+                while( !pushed && running ){
+                    std::this_thread::yield();
+                    pushed = ring.push( imu_sample );
+                }
+                if( !pushed ){
+                    // Stopped while waiting
+                    break;
+                }
+                produced++;
+            }
+        }
+        catch( const k4a::error& error ){
+            std::cerr << error.what() << std::endl;
+        }
+
+        finished = true;
+    }
+
+    // Read Samples up to Device Timestamp
+    size_t reader::read_until( const std::chrono::microseconds device_timestamp, std::vector<sample>& batch )
+    {
+        size_t count = 0;
+        const uint64_t timestamp = static_cast<uint64_t>( device_timestamp.count() );
+        while( const sample* imu_sample = ring.front() ){
+            if( imu_sample->gyro_timestamp_usec > timestamp ){
+                break;
+            }
+
+            batch.emplace_back();
+            ring.pop( batch.back() );
+            count++;
+        }
+        return count;
+    }
+
+    // Read Available Samples
+    size_t reader::read( std::vector<sample>& batch, const size_t count )
+    {
+        const size_t size = batch.size();
+        batch.resize( size + count );
+        const size_t result = ring.pop( batch.data() + size, count );
+        batch.resize( size + result );
+        return result;
+    }
+
+    // Check Reader Finished
+    bool reader::is_finished()
+    {
+        return finished.load() && !ring.front();
+    }
+
+    // Constructor
+    integrator::integrator()
+        : has_last( false ),
+          samples( 0 )
+    {
+    }
+
+    // Integrate Gyro over Batch
+    quaternion integrator::integrate( const std::vector<sample>& batch )
+    {
+        quaternion delta;
+        for( const sample& imu_sample : batch ){
+            if( has_last ){
+                // Skip Gap (e.g. dropped samples or seek)
+                constexpr double max_interval = 0.1;
+                const double interval = ( static_cast<double>( imu_sample.gyro_timestamp_usec ) - static_cast<double>( last.gyro_timestamp_usec ) ) * 1e-6;
+                if( 0.0 < interval && interval < max_interval ){
+                    // Trapezoidal Integration of Angular Velocity [rad/s]
+                    const double x = 0.5 * ( last.gyro_sample.xyz.x + imu_sample.gyro_sample.xyz.x ) * interval;
+                    const double y = 0.5 * ( last.gyro_sample.xyz.y + imu_sample.gyro_sample.xyz.y ) * interval;
+                    const double z = 0.5 * ( last.gyro_sample.xyz.z + imu_sample.gyro_sample.xyz.z ) * interval;
+                    const quaternion rotation = quaternion::from_rotation_vector( x, y, z );
+                    delta = delta * rotation;
+                }
+            }
+
+            last = imu_sample;
+            has_last = true;
+            samples++;
+        }
+
+        // Normalize once per Batch
+        delta = delta.normalize();
+        orientation = ( orientation * delta ).normalize();
+        return delta;
+    }
+
+    // Reset Orientation
+    void integrator::reset()
+    {
+        orientation = quaternion();
+    }
+}
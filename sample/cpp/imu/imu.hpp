@@ -0,0 +1,144 @@
+#ifndef __IMU__
+#define __IMU__
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ring.hpp"
+
+/*
+ This is IMU ingestion that reads samples (~1.6 kHz) on dedicated thread and hands them to main loop.
+
+ reader thread : get_imu_sample / get_next_imu_sample -> spsc_ring
+ main loop     : read_until( capture timestamp ) -> batch of samples up to frame -> integrator
+
+ IMU samples and images share device timestamp, so samples are aligned to capture by gyro timestamp.
+ Sample that arrives after its frame was processed is carried into batch of next frame.
+*/
+
+namespace imu
+{
+    // Sample
+    typedef k4a_imu_sample_t sample;
+
+    // Quaternion
+    struct quaternion
+    {
+        double w = 1.0;
+        double x = 0.0;
+        double y = 0.0;
+        double z = 0.0;
+
+        // Multiply
+        quaternion operator*( const quaternion& q ) const;
+
+        // Normalize
+        quaternion normalize() const;
+
+        // Conjugate (inverse of unit quaternion)
+        quaternion conjugate() const;
+
+        // Get Angle [rad]
+        double angle() const;
+
+        // Convert to Rotation Matrix
+        cv::Matx33f to_matrix() const;
+
+        // Create from Rotation Vector [rad]
+        static quaternion from_rotation_vector( const double x, const double y, const double z );
+    };
+
+    // Reader
+    class reader
+    {
+    private:
+        // Source
+        k4a::device* device;
+        k4a::playback* playback;
+
+        // Ring and Thread
+        spsc_ring<sample> ring;
+        std::thread thread;
+        std::atomic<bool> running;
+        std::atomic<bool> finished;
+
+        // Statistics (written by reader thread)
+        std::atomic<uint64_t> produced;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> read_time_nsec;
+
+    public:
+        // Constructor (live device, drops newest sample when ring is full)
+        reader( k4a::device* device, const size_t capacity = 4096 );
+
+        // Constructor (recording, waits for space when ring is full)
+        reader( k4a::playback* playback, const size_t capacity = 4096 );
+
+        // Destructor
+        ~reader();
+
+        // Read Samples up to Device Timestamp (appends to batch, returns number of samples)
+        size_t read_until( const std::chrono::microseconds device_timestamp, std::vector<sample>& batch );
+
+        // Read Available Samples (appends up to count samples to batch, returns number of samples)
+        size_t read( std::vector<sample>& batch, const size_t count );
+
+        // Check Reader Reached End of Recording and Ring is Empty
+        bool is_finished();
+
+        // Get Statistics
+        uint64_t get_produced() const { return produced.load(); }
+        uint64_t get_dropped() const { return dropped.load(); }
+        double get_read_time() const { return read_time_nsec.load() / 1000000.0; }
+
+    private:
+        // Start Thread
+        void start();
+
+        // Stop Thread
+        void stop();
+
+        // Read Device
+        void read_device();
+
+        // Read Playback
+        void read_playback();
+
+        reader( const reader& ) = delete;
+        reader& operator=( const reader& ) = delete;
+    };
+
+    // Integrator
+    class integrator
+    {
+    private:
+        quaternion orientation;
+        sample last;
+        bool has_last;
+        uint64_t samples;
+
+    public:
+        // Constructor
+        integrator();
+
+        // Integrate Gyro over Batch (returns rotation from start to end of batch)
+        quaternion integrate( const std::vector<sample>& batch );
+
+        // Reset Orientation
+        void reset();
+
+        // Get Orientation
+        const quaternion& get_orientation() const { return orientation; }
+
+        // Get Number of Integrated Samples
+        uint64_t get_samples() const { return samples; }
+    };
+}
+
+#endif // __IMU__
@@ -0,0 +1,252 @@
+#include "kinect.hpp"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Constructor
+kinect::kinect( const uint32_t index )
+    : device_index( index ),
+      imu_frames( 0 ),
+      integrate_time( 0.0 )
+{
+    // Initialize
+    initialize();
+}
+
+kinect::~kinect()
+{
+    // Finalize
+    finalize();
+}
+
+// Initialize
+void kinect::initialize()
+{
+    // Initialize Sensor
+    initialize_sensor();
+
+    // Initialize IMU
+    initialize_imu();
+}
+
+// Initialize Sensor
+inline void kinect::initialize_sensor()
+{
+    // Get Connected Devices
+    const int32_t device_count = k4a::device::get_installed_count();
+    if( device_count == 0 ){
+        throw k4a::error( "Failed to found device!" );
+    }
+
+    // Open Default Device
+    device = k4a::device::open( device_index );
+
+    // Start Cameras with Configuration
+    device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    device_configuration.depth_mode      = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    device_configuration.wired_sync_mode = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    device.start_cameras( &device_configuration );
+
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
+    // Get Calibration
+    calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
+}
+
+// Initialize IMU
+inline void kinect::initialize_imu()
+{
+    // Start IMU and Reader Thread
+    imu_reader.reset( new imu::reader( &device ) );
+
+    // Reserve Batch (~1.6 kHz / 30 fps, with headroom for late frames)
+    imu_batch.reserve( 256 );
+}
+
+// Finalize
+void kinect::finalize()
+{
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Report IMU Statistics
+    if( imu_reader && imu_frames ){
+        std::cout << "imu : " << imu_reader->get_produced() << " samples, " << imu_reader->get_dropped() << " dropped"
+                  << ", " << static_cast<double>( integrator.get_samples() ) / imu_frames << " samples/frame"
+                  << ", integrate " << integrate_time * 1000.0 / std::max<uint64_t>( 1, integrator.get_samples() ) << " us/sample" << std::endl;
+    }
+
+    // Stop IMU Reader
+    imu_reader.reset();
+
+    // Stop Cameras
+    device.stop_cameras();
+
+    // Close Device
+    device.close();
+
+    // Close Window
+    cv::destroyAllWindows();
+}
+
+// Run
+void kinect::run()
+{
+    // Main Loop
+    bool updated = false;
+    while( true ){
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
+
+        // Show
+        if( updated ){
+            show();
+            updated = false;
+        }
+
+        // Wait Key
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            break;
+        }
+
+        // Reset Orientation
+        if( key == 'r' ){
+            integrator.reset();
+        }
+    }
+}
+
+// Update
+bool kinect::update()
+{
+    // Update Frame
+    if( !update_frame() ){
+        return false;
+    }
+
+    // Update IMU
+    update_imu();
+
+    // Update Depth
+    update_depth();
+
+    // Release Capture Handle
+    capture.reset();
+
+    return true;
+}
+
+// Update Frame
+inline bool kinect::update_frame()
+{
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
+}
+
+// Update IMU
+inline void kinect::update_imu()
+{
+    // Read Samples up to Timestamp of Capture
+    imu_batch.clear();
+    imu_reader->read_until( scheduler::get_device_timestamp( capture ), imu_batch );
+
+    // Integrate Orientation over Batch
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    imu_delta = integrator.integrate( imu_batch );
+    integrate_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    imu_frames++;
+}
+
+// Update Depth
+inline void kinect::update_depth()
+{
+    // Get Depth Image
+    depth_image = capture.get_depth_image();
+}
+
+// Draw
+void kinect::draw()
+{
+    // Draw Depth
+    draw_depth();
+
+    // Draw Orientation
+    draw_orientation();
+}
+
+// Draw Depth
+inline void kinect::draw_depth()
+{
+    if( !depth_image.handle() ){
+        return;
+    }
+
+    // Get cv::Mat from k4a::image
+    depth = k4a::get_mat( depth_image );
+
+    // Scaling Depth
+    depth.convertTo( depth, CV_8U, -255.0 / 5000.0, 255.0 );
+    cv::cvtColor( depth, depth, cv::COLOR_GRAY2BGR );
+
+    // Release Depth Image Handle
+    depth_image.reset();
+}
+
+// Draw Orientation
+inline void kinect::draw_orientation()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Draw Axes of Integrated Orientation (x: red, y: green, z: blue)
+    const cv::Matx33f rotation = integrator.get_orientation().to_matrix();
+    const cv::Point center( 80, 80 );
+    constexpr float length = 60.0f;
+    const cv::Scalar colors[3] = { cv::Scalar( 0, 0, 255 ), cv::Scalar( 0, 255, 0 ), cv::Scalar( 255, 0, 0 ) };
+    for( int32_t i = 0; i < 3; i++ ){
+        const cv::Point end( center.x + static_cast<int32_t>( rotation( 0, i ) * length ), center.y + static_cast<int32_t>( rotation( 1, i ) * length ) );
+        cv::line( depth, center, end, colors[i], 2 );
+    }
+
+    // Draw Samples and Rotation of Last Frame
+    const std::string text = cv::format( "%d samples, %.2f deg", static_cast<int32_t>( imu_batch.size() ), imu_delta.angle() * 180.0 / CV_PI );
+    cv::putText( depth, text, cv::Point( 10, depth.rows - 10 ), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar( 255, 255, 255 ) );
+}
+
+// Show
+void kinect::show()
+{
+    // Show Depth
+    show_depth();
+}
+
+// Show Depth
+inline void kinect::show_depth()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Show Image
+    const cv::String window_name = cv::format( "imu (kinect %d)", device_index );
+    cv::imshow( window_name, depth );
+}
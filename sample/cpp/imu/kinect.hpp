@@ -0,0 +1,89 @@
+#ifndef __KINECT__
+#define __KINECT__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "imu.hpp"
+
+class kinect
+{
+private:
+    // Kinect
+    k4a::device device;
+    k4a::capture capture;
+    k4a::calibration calibration;
+    k4a_device_configuration_t device_configuration;
+    uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
+
+    // IMU
+    std::unique_ptr<imu::reader> imu_reader;
+    imu::integrator integrator;
+    std::vector<imu::sample> imu_batch;
+    imu::quaternion imu_delta;
+    uint64_t imu_frames;
+    double integrate_time;
+
+    // Depth
+    k4a::image depth_image;
+    cv::Mat depth;
+
+public:
+    // Constructor
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
+
+    // Destructor
+    ~kinect();
+
+    // Run
+    void run();
+
+    // Update
+    bool update();
+
+    // Draw
+    void draw();
+
+    // Show
+    void show();
+
+private:
+    // Initialize
+    void initialize();
+
+    // Initialize Sensor
+    void initialize_sensor();
+
+    // Initialize IMU
+    void initialize_imu();
+
+    // Finalize
+    void finalize();
+
+    // Update Frame
+    bool update_frame();
+
+    // Update IMU
+    void update_imu();
+
+    // Update Depth
+    void update_depth();
+
+    // Draw Depth
+    void draw_depth();
+
+    // Draw Orientation
+    void draw_orientation();
+
+    // Show Depth
+    void show_depth();
+};
+
+#endif // __KINECT__
@@ -0,0 +1,30 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "kinect.hpp"
+#include "benchmark.hpp"
+
+int main( int argc, char* argv[] )
+{
+    try{
+        const std::string mode = ( argc > 1 ) ? argv[1] : "live";
+        if( mode == "benchmark" ){
+            // Recorded IMU Track without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            const size_t batch_size = ( argc > 3 ) ? std::atoi( argv[3] ) : 64;
+            benchmark( file, batch_size );
+        }
+        else{
+            // Device
+            kinect kinect;
+            kinect.run();
+        }
+    }
+    catch( const k4a::error& error ){
+        std::cout << error.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "benchmark.hpp"
+#include "kernels.hpp"
+#include "parallel.hpp"
+
+#include <k4abt.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Measure Average Time of Function [ms]
+    double measure( const uint32_t iterations, const std::function<void()>& function )
+    {
+        // Warm-Up (allocate outputs, wake threads)
+        function();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for( uint32_t i = 0; i < iterations; i++ ){
+            function();
+        }
+        return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() / iterations;
+    }
+}
+
+// Benchmark Kernels
+void benchmark_kernels( const uint32_t max_threads, const uint32_t iterations )
+{
+    const uint32_t threads = max_threads ? max_threads : std::max( 1u, std::thread::hardware_concurrency() );
+
+    // Synthetic Inputs (bodies are ellipses with holes, same size as 720p color-registered map)
+    const cv::Size size( 1280, 720 );
+    cv::Mat index_map( size, CV_8UC1, cv::Scalar( K4ABT_BODY_INDEX_MAP_BACKGROUND ) );
+    for( int32_t i = 0; i < 4; i++ ){
+        cv::ellipse( index_map, cv::Point( 200 + i * 280, 400 ), cv::Size( 100, 280 ), 0.0, 0.0, 360.0, cv::Scalar( i ), -1 );
+    }
+    for( int32_t y = 0; y < size.height; y += 7 ){
+        for( int32_t x = y % 5; x < size.width; x += 11 ){
+            index_map.at<uint8_t>( y, x ) = K4ABT_BODY_INDEX_MAP_BACKGROUND;
+        }
+    }
+    cv::Mat color( size, CV_8UC4, cv::Scalar( 64, 128, 192, 255 ) );
+
+    std::vector<cv::Vec3b> colors;
+    colors.push_back( cv::Vec3b( 255,   0,   0 ) );
+    colors.push_back( cv::Vec3b(   0, 255,   0 ) );
+    colors.push_back( cv::Vec3b(   0,   0, 255 ) );
+    colors.push_back( cv::Vec3b( 255, 255,   0 ) );
+
+    // Baseline (cv::Mat::forEach)
+    cv::Mat colorized, filled, blended;
+    const double baseline = measure( iterations, [&](){
+        colorized = cv::Mat::zeros( index_map.size(), CV_8UC3 );
+        colorized.forEach<cv::Vec3b>(
+            [&]( cv::Vec3b& pixel, const int32_t* position ){
+                const uint32_t body_index = index_map.at<uint8_t>( position[0], position[1] );
+                if( body_index != K4ABT_BODY_INDEX_MAP_BACKGROUND ){
+                    pixel = colors[body_index % colors.size()];
+                }
+            }
+        );
+    } );
+    std::cout << "forEach colorize : " << baseline << " ms" << std::endl;
+
+    // Scaling from 1 to N Threads
+    std::cout << "threads  colorize     fill    blend [ms]  (speedup of colorize)" << std::endl;
+    double single = 0.0;
+    for( uint32_t count = 1; count <= threads; count = ( count < threads && count * 2 > threads ) ? threads : count * 2 ){
+        const parallel::options config( count );
+        parallel::thread_pool pool( config );
+        const double colorize_time = measure( iterations, [&](){ kernels::colorize_index( pool, index_map, colors, colorized ); } );
+        const double fill_time     = measure( iterations, [&](){ kernels::fill_index_holes( pool, index_map, filled ); } );
+        const double blend_time    = measure( iterations, [&](){ kernels::blend_index( pool, color, index_map, colors, 0.7, blended ); } );
+        if( count == 1 ){
+            single = colorize_time;
+        }
+
+        std::cout << std::setw( 7 ) << count << std::fixed << std::setprecision( 3 )
+                  << std::setw( 10 ) << colorize_time << std::setw( 9 ) << fill_time << std::setw( 9 ) << blend_time
+                  << "      x" << std::setprecision( 2 ) << single / colorize_time
+                  << "  (" << pool.get_stolen() << " stolen tiles)" << std::defaultfloat << std::endl;
+
+        if( count == threads ){
+            break;
+        }
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+
+// Benchmark Scaling of Per-Pixel Kernels from 1 to N Threads on Synthetic 720p Body Index Map and Color Image
+// cv::Mat::forEach colorizer (previous implementation) is measured as baseline.
+void benchmark_kernels( const uint32_t max_threads = 0, const uint32_t iterations = 100 );
+
+#endif // __BENCHMARK__
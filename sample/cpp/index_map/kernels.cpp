@@ -0,0 +1,107 @@
+#include "kernels.hpp"
+
+#include <k4abt.hpp>
+
+namespace
+{
+    // Color Table of Body Index (background is black)
+    void make_table( const std::vector<cv::Vec3b>& colors, cv::Vec3b table[256] )
+    {
+        for( int32_t i = 0; i < 256; i++ ){
+            table[i] = ( i == K4ABT_BODY_INDEX_MAP_BACKGROUND || colors.empty() ) ? cv::Vec3b( 0, 0, 0 ) : colors[i % colors.size()];
+        }
+    }
+}
+
+namespace kernels
+{
+    // Colorize Body Index Map
+    void colorize_index( parallel::thread_pool& pool, const cv::Mat& index_map, const std::vector<cv::Vec3b>& colors, cv::Mat& colorized )
+    {
+        CV_Assert( index_map.type() == CV_8UC1 );
+
+        cv::Vec3b table[256];
+        make_table( colors, table );
+
+        colorized.create( index_map.size(), CV_8UC3 );
+        parallel::for_each_tile( pool, index_map.size(), sizeof( cv::Vec3b ) + 1, [&]( const cv::Rect& tile ){
+            for( int32_t y = tile.y; y < tile.y + tile.height; y++ ){
+                const uint8_t* src = index_map.ptr<uint8_t>( y );
+                cv::Vec3b* dst = colorized.ptr<cv::Vec3b>( y );
+                for( int32_t x = tile.x; x < tile.x + tile.width; x++ ){
+                    dst[x] = table[src[x]];
+                }
+            }
+        } );
+    }
+
+    // Fill Background Holes Surrounded by Body
+    void fill_index_holes( parallel::thread_pool& pool, const cv::Mat& index_map, cv::Mat& filled )
+    {
+        CV_Assert( index_map.type() == CV_8UC1 && index_map.data != filled.data );
+
+        filled.create( index_map.size(), CV_8UC1 );
+        const int32_t rows = index_map.rows;
+        const int32_t cols = index_map.cols;
+        parallel::for_each_tile( pool, index_map.size(), 2, [&]( const cv::Rect& tile ){
+            for( int32_t y = tile.y; y < tile.y + tile.height; y++ ){
+                const uint8_t* src = index_map.ptr<uint8_t>( y );
+                uint8_t* dst = filled.ptr<uint8_t>( y );
+                for( int32_t x = tile.x; x < tile.x + tile.width; x++ ){
+                    dst[x] = src[x];
+                    if( src[x] != K4ABT_BODY_INDEX_MAP_BACKGROUND || y == 0 || x == 0 || y == rows - 1 || x == cols - 1 ){
+                        continue;
+                    }
+
+                    // Majority of 8 Neighbors (5 or more of same body)
+                    const uint8_t* above = src - index_map.step;
+                    const uint8_t* below = src + index_map.step;
+                    const uint8_t neighbors[8] = { above[x - 1], above[x], above[x + 1], src[x - 1], src[x + 1], below[x - 1], below[x], below[x + 1] };
+                    for( int32_t i = 0; i < 4; i++ ){
+                        if( neighbors[i] == K4ABT_BODY_INDEX_MAP_BACKGROUND ){
+                            continue;
+                        }
+                        int32_t count = 0;
+                        for( int32_t j = 0; j < 8; j++ ){
+                            count += ( neighbors[j] == neighbors[i] ) ? 1 : 0;
+                        }
+                        if( count >= 5 ){
+                            dst[x] = neighbors[i];
+                            break;
+                        }
+                    }
+                }
+            }
+        } );
+    }
+
+    // Blend Colorized Body Index Map on Color
+    void blend_index( parallel::thread_pool& pool, const cv::Mat& color, const cv::Mat& index_map, const std::vector<cv::Vec3b>& colors, const double alpha, cv::Mat& blended )
+    {
+        CV_Assert( ( color.type() == CV_8UC4 || color.type() == CV_8UC3 ) && index_map.type() == CV_8UC1 && color.size() == index_map.size() );
+
+        cv::Vec3b table[256];
+        make_table( colors, table );
+
+        // Fixed Point Weights (8 bits)
+        const int32_t a = static_cast<int32_t>( alpha * 256.0 + 0.5 );
+        const int32_t b = 256 - a;
+        const int32_t channels = color.channels();
+
+        blended.create( color.size(), CV_8UC3 );
+        parallel::for_each_tile( pool, color.size(), channels + 1 + 3, [&]( const cv::Rect& tile ){
+            for( int32_t y = tile.y; y < tile.y + tile.height; y++ ){
+                const uint8_t* src = color.ptr<uint8_t>( y );
+                const uint8_t* index = index_map.ptr<uint8_t>( y );
+                cv::Vec3b* dst = blended.ptr<cv::Vec3b>( y );
+                for( int32_t x = tile.x; x < tile.x + tile.width; x++ ){
+                    const uint8_t* pixel = src + x * channels;
+                    const cv::Vec3b& overlay = table[index[x]];
+                    for( int32_t c = 0; c < 3; c++ ){
+                        dst[x][c] = static_cast<uint8_t>( ( pixel[c] * a + overlay[c] * b + 128 ) >> 8 );
+                    }
+                }
+            }
+        } );
+    }
+}
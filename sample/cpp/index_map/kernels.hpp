@@ -0,0 +1,32 @@
+#ifndef __KERNELS__
+#define __KERNELS__
+
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+
+#include "parallel.hpp"
+
+/*
+ This is per-pixel kernels of body index map that run on cache-sized tiles of parallel::thread_pool.
+
+ kernels::colorize_index( pool, index_map, colors, colorized );            // CV_8UC1 -> CV_8UC3
+ kernels::fill_index_holes( pool, index_map, filled );                     // CV_8UC1 -> CV_8UC1
+ kernels::blend_index( pool, color, index_map, colors, alpha, blended );   // CV_8UC4/CV_8UC3 + CV_8UC1 -> CV_8UC3
+
+ Output is created before kernel runs, each tile writes only its own pixels.
+*/
+
+namespace kernels
+{
+    // Colorize Body Index Map (background is black)
+    void colorize_index( parallel::thread_pool& pool, const cv::Mat& index_map, const std::vector<cv::Vec3b>& colors, cv::Mat& colorized );
+
+    // Fill Background Holes Surrounded by Body (3x3 majority of same body index)
+    void fill_index_holes( parallel::thread_pool& pool, const cv::Mat& index_map, cv::Mat& filled );
+
+    // Blend Colorized Body Index Map on Color ( alpha * color + ( 1 - alpha ) * colorized, conversion to BGR is fused )
+    void blend_index( parallel::thread_pool& pool, const cv::Mat& color, const cv::Mat& index_map, const std::vector<cv::Vec3b>& colors, const double alpha, cv::Mat& blended );
+}
+
+#endif // __KERNELS__
@@ -1,11 +1,21 @@
 #include "kinect.hpp"
 #include "util.h"
+#include "kernels.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
-kinect::kinect( const uint32_t index )
-    : device_index( index )
+kinect::kinect( const uint32_t index, const threading::configuration& threads )
+    : device_index( index ),
+      threads( threads ),
+      capturing( false ),
+      dropped_captures( 0 ),
+      pool( parallel::options( static_cast<uint32_t>( threads.kernels.cores.size() ), threads.kernels.cores ) ),
+      display_node( 0 ),
+      kernel_frames( 0 ),
+      kernel_time( 0.0 )
 {
     // Initialize
     initialize();
@@ -25,6 +35,9 @@ void kinect::initialize()
 
     // Initialize Body Tracking
     initialize_body_tracking();
+
+    // Initialize Capture Thread
+    initialize_capture();
 }
 
 // Initialize Sensor
@@ -48,6 +61,9 @@ inline void kinect::initialize_sensor()
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
 
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
     // Get Calibration
     calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
 
@@ -62,8 +78,11 @@ inline void kinect::initialize_body_tracking()
     k4abt_tracker_configuration_t tracker_configuration = K4ABT_TRACKER_CONFIG_DEFAULT;
     tracker_configuration.sensor_orientation = K4ABT_SENSOR_ORIENTATION_DEFAULT;
 
-    // Create Tracker with Configuration
-    tracker = k4abt::tracker::create( calibration, tracker_configuration );
+    // Create Tracker with Configuration (worker threads of tracker inherit affinity of tracking stage)
+    {
+        threading::scoped_affinity scope( threads.tracking );
+        tracker = k4abt::tracker::create( calibration, tracker_configuration );
+    }
     if( !tracker ){
         throw k4a::error( "Failed to create tracker!" );
     }
@@ -83,9 +102,40 @@ inline void kinect::initialize_body_tracking()
     colors.push_back( cv::Vec3b( 128,   0, 128 ) );
 }
 
+// Initialize Capture Thread
+inline void kinect::initialize_capture()
+{
+    // Start Capture Thread
+    capturing = true;
+    capture_thread = std::thread( &kinect::capture_loop, this );
+}
+
 // Finalize
 void kinect::finalize()
 {
+    // Stop Capture Thread
+    capturing = false;
+    if( capture_thread.joinable() ){
+        capture_thread.join();
+    }
+
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Report Threading and Jitter
+    std::cout << "capture  : " << threading::describe( threads.capture ) << ", " << dropped_captures << " captures dropped (tracker queue full)" << std::endl;
+    std::cout << "tracking : " << threading::describe( threads.tracking ) << std::endl;
+    std::cout << "display  : " << threading::describe( threads.display ) << ", buffers on node " << display_node << std::endl;
+    capture_jitter.report( std::cout, "capture jitter" );
+    display_jitter.report( std::cout, "display jitter" );
+
+    // Report Kernel Time
+    if( kernel_frames ){
+        std::cout << "kernels : " << kernel_frames << " frames, " << kernel_time / kernel_frames << " ms/frame on " << pool.get_threads() << " threads ("
+                  << pool.get_stolen() << " of " << pool.get_executed() << " tiles stolen)" << std::endl;
+    }
+
     // Destroy Tracker
     tracker.destroy();
 
@@ -99,34 +149,88 @@ void kinect::finalize()
     cv::destroyAllWindows();
 }
 
+// Capture Loop
+void kinect::capture_loop()
+{
+    // Pin Capture Thread (and raise priority)
+    if( !threading::apply( threads.capture ) ){
+        std::cout << "failed to apply capture stage (" << threading::describe( threads.capture ) << ")" << std::endl;
+    }
+
+    // NOTE: Exception can not cross thread boundary, failure of device ends capturing.
+    try{
+        k4a::capture frame_capture;
+        while( capturing ){
+            // Wait Capture (short timeout lets thread notice stop request)
+            if( poller.poll( &frame_capture, std::chrono::milliseconds( 100 ) ) != capture_poller::status::ready ){
+                continue;
+            }
+            capture_jitter.add();
+
+            // Enqueue Capture without Blocking (drop if tracker falls behind)
+            if( !tracker.enqueue_capture( frame_capture, std::chrono::milliseconds( 0 ) ) ){
+                dropped_captures++;
+            }
+            frame_capture.reset();
+        }
+    }
+    catch( const k4a::error& error ){
+        std::cout << error.what() << std::endl;
+        capturing = false;
+    }
+}
+
 // Run
 void kinect::run()
 {
+    // Pin Main Thread to Display Stage, Frame Buffers are Allocated on its Node
+    if( !threading::apply( threads.display ) ){
+        std::cout << "failed to apply display stage (" << threading::describe( threads.display ) << ")" << std::endl;
+    }
+    display_node = threading::get_numa_node( threads.display );
+
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
 
-        // Draw
-        draw();
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
-        if( key == 'q' ){
+        if( key == 'q' || !capturing ){
             break;
         }
     }
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
+
+    // Update Body Tracking
+    update_body_tracking();
 
     // Update Color
     update_color();
@@ -134,9 +238,6 @@ void kinect::update()
     // Update Depth
     update_depth();
 
-    // Update Body Tracking
-    update_body_tracking();
-
     // Update Body Index Map
     update_body_index_map();
 
@@ -148,17 +249,21 @@ void kinect::update()
 
     // Release Body Frame Handle
     frame.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
+    // Pop Body Tracking Result (waits until next result or UI refresh is due, captures are enqueued by capture thread)
+    frame = tracker.pop_result( loop.get_time_out() );
+    if( !frame ){
+        return false;
     }
+
+    display_jitter.add();
+    return true;
 }
 
 // Update Color
@@ -178,11 +283,8 @@ inline void kinect::update_depth()
 // Update Body Tracking
 inline void kinect::update_body_tracking()
 {
-    // Enqueue Capture
-    tracker.enqueue_capture( capture );
-
-    // Pop Body Tracking Result
-    frame = tracker.pop_result();
+    // Get Capture that used for Inference
+    capture = frame.get_capture();
 }
 
 // Update Body Index Map
@@ -275,16 +377,11 @@ inline void kinect::show_body_index_map()
         return;
     }
 
-    // Visualize Body Index Map
-    cv::Mat colorized_body_index_map = cv::Mat::zeros( body_index_map.size(), CV_8UC3 );
-    colorized_body_index_map.forEach<cv::Vec3b>(
-        [&]( cv::Vec3b& pixel, const int32_t* position ){
-            const uint32_t body_index = body_index_map.at<uint8_t>( position[0], position[1] );
-            if( body_index != K4ABT_BODY_INDEX_MAP_BACKGROUND ){
-                pixel = colors[body_index % colors.size()];
-            }
-        }
-    );
+    // Visualize Body Index Map (output on NUMA node of display stage)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    threading::create_on_node( colorized_body_index_map, colorized_buffer, body_index_map.size(), CV_8UC3, display_node );
+    kernels::colorize_index( pool, body_index_map, colors, colorized_body_index_map );
+    kernel_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
 
     // Show Image
     const cv::String window_name = cv::format( "body index map (kinect %d)", device_index );
@@ -298,31 +395,30 @@ inline void kinect::show_transformation()
         return;
     }
 
-    // Visualize Transformed Body Index Map
-    cv::Mat colorized_body_index_map = cv::Mat::zeros( transformed_body_index_map.size(), CV_8UC3 );
-    colorized_body_index_map.forEach<cv::Vec3b>(
-        [&]( cv::Vec3b& pixel, const int32_t* position ){
-            const uint32_t body_index = transformed_body_index_map.at<uint8_t>( position[0], position[1] );
-            if( body_index != K4ABT_BODY_INDEX_MAP_BACKGROUND ){
-                pixel = colors[body_index % colors.size()];
-            }
-        }
-    );
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-    // Visualize Transformed Body Index Map on Color
-    if( !color.empty() ){
-        // Convert Channels
-        if( color.channels() == 4 ){
-            cv::cvtColor( color, color, cv::COLOR_BGRA2BGR );
-        }
+    // Frame Buffers on NUMA Node of Display Stage
+    threading::create_on_node( filled_body_index_map, filled_buffer, transformed_body_index_map.size(), CV_8UC1, display_node );
+    threading::create_on_node( blended_body_index_map, blended_buffer, transformed_body_index_map.size(), CV_8UC3, display_node );
+
+    // Fill Holes of Transformed Body Index Map (nearest interpolation into higher resolution)
+    kernels::fill_index_holes( pool, transformed_body_index_map, filled_body_index_map );
 
-        // Alpha Blend
+    // Visualize Transformed Body Index Map on Color
+    if( !color.empty() && color.size() == filled_body_index_map.size() ){
+        // Alpha Blend (conversion of channels is fused)
         constexpr double alpha = 0.7;
-        constexpr double beta  = 1.0 - alpha;
-        cv::addWeighted( color, alpha, colorized_body_index_map, beta, 0.0, colorized_body_index_map );
+        kernels::blend_index( pool, color, filled_body_index_map, colors, alpha, blended_body_index_map );
     }
+    else{
+        // Visualize Transformed Body Index Map
+        kernels::colorize_index( pool, filled_body_index_map, colors, blended_body_index_map );
+    }
+
+    kernel_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    kernel_frames++;
 
     // Show Image
     const cv::String window_name = cv::format( "transofrmed body index map (kinect %d)", device_index );
-    cv::imshow( window_name, colorized_body_index_map );
+    cv::imshow( window_name, blended_body_index_map );
 }
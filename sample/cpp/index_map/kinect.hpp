@@ -5,8 +5,15 @@
 #include <k4abt.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "parallel.hpp"
+#include "threading.hpp"
+
 class kinect
 {
 private:
@@ -17,6 +24,16 @@ private:
     k4a::transformation transformation;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
+
+    // Threading (capture thread enqueues captures into tracker, main thread pops results)
+    threading::configuration threads;
+    std::thread capture_thread;
+    std::atomic<bool> capturing;
+    std::atomic<uint64_t> dropped_captures;
+    threading::jitter_meter capture_jitter;
+    threading::jitter_meter display_jitter;
 
     // Color
     k4a::image color_image;
@@ -39,10 +56,20 @@ private:
 
     // Visualize
     std::vector<cv::Vec3b> colors;
+    parallel::thread_pool pool;
+    cv::Mat filled_body_index_map;
+    cv::Mat colorized_body_index_map;
+    cv::Mat blended_body_index_map;
+    threading::node_buffer filled_buffer;
+    threading::node_buffer colorized_buffer;
+    threading::node_buffer blended_buffer;
+    int32_t display_node;
+    uint64_t kernel_frames;
+    double kernel_time;
 
 public:
     // Constructor
-    kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT, const threading::configuration& threads = threading::configuration() );
 
     // Destructor
     ~kinect();
@@ -51,7 +78,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -69,11 +96,17 @@ private:
     // Initialize Body Tracking
     void initialize_body_tracking();
 
+    // Initialize Capture Thread
+    void initialize_capture();
+
     // Finalize
     void finalize();
 
+    // Capture Loop (capture thread)
+    void capture_loop();
+
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Color
     void update_color();
@@ -1,13 +1,25 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "benchmark.hpp"
 
 int main( int argc, char* argv[] )
 {
     try{
-        kinect kinect;
-        kinect.run();
+        const std::string mode = ( argc > 1 ) ? argv[1] : "live";
+        if( mode == "benchmark" ){
+            // Scaling of Kernels from 1 to N Threads without Device
+            const uint32_t threads = ( argc > 2 ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 0;
+            benchmark_kernels( threads );
+        }
+        else{
+            // Device with Threading Configuration (e.g. "live capture=2:high;tracking=4-7;display=1;kernels=8-11")
+            const threading::configuration threads = threading::parse( ( argc > 2 ) ? argv[2] : "" );
+            kinect kinect( K4A_DEVICE_DEFAULT, threads );
+            kinect.run();
+        }
     }
     catch( const k4a::error& error ){
         std::cout << error.what() << std::endl;
@@ -0,0 +1,198 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace parallel
+{
+    // Pin Current Thread to Core
+    bool pin_current_thread( const int32_t core )
+    {
+        if( core < 0 ){
+            return false;
+        }
+
+        #if defined( _WIN32 )
+        return SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>( 1 ) << core ) != 0;
+        #elif defined( __linux__ )
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( core, &set );
+        return pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0;
+        #else
+        return false;
+        #endif
+    }
+
+    // Constructor
+    thread_pool::thread_pool( const options& config )
+        : pending( 0 ),
+          stopping( false ),
+          stolen( 0 ),
+          executed( 0 )
+    {
+        const uint32_t count = config.threads ? config.threads : std::max( 1u, std::thread::hardware_concurrency() );
+        for( uint32_t i = 0; i < count; i++ ){
+            queues.emplace_back( new queue() );
+        }
+
+        // Start Workers (calling thread is last one and is not pinned here)
+        for( uint32_t i = 0; i + 1 < count; i++ ){
+            const int32_t core = config.cores.empty() ? -1 : config.cores[i % config.cores.size()];
+            threads.emplace_back( [this, i, core](){
+                pin_current_thread( core );
+                work( i );
+            } );
+        }
+    }
+
+    // Destructor
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        condition.notify_all();
+        for( std::thread& thread : threads ){
+            thread.join();
+        }
+    }
+
+    // Run Kernel on Tiles
+    void thread_pool::run( const std::vector<cv::Rect>& tiles, const std::function<void( const cv::Rect& )>& kernel )
+    {
+        if( tiles.empty() ){
+            return;
+        }
+
+        // Single Thread (no synchronization)
+        if( queues.size() == 1 || tiles.size() == 1 ){
+            for( const cv::Rect& tile : tiles ){
+                kernel( tile );
+            }
+            executed += tiles.size();
+            return;
+        }
+
+        job current;
+        current.kernel = kernel;
+        current.remaining = static_cast<uint32_t>( tiles.size() );
+
+        // Count Tasks before Dealing (pending never goes below number of queued tasks)
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            pending += static_cast<uint32_t>( tiles.size() );
+        }
+
+        // Deal Tiles Round-Robin (neighboring tiles go to different workers, stealing balances rest)
+        const size_t count = queues.size();
+        for( size_t i = 0; i < count; i++ ){
+            std::lock_guard<std::mutex> lock( queues[i]->mutex );
+            for( size_t j = i; j < tiles.size(); j += count ){
+                queues[i]->tasks.push_back( task{ &current, tiles[j] } );
+            }
+        }
+        condition.notify_all();
+
+        // Work on Tiles in Calling Thread
+        const uint32_t self = static_cast<uint32_t>( count - 1 );
+        task target;
+        while( current.remaining > 0 ){
+            if( take( self, target ) ){
+                execute( target );
+            }
+            else{
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Worker Loop
+    void thread_pool::work( const uint32_t index )
+    {
+        task target;
+        while( true ){
+            if( take( index, target ) ){
+                execute( target );
+                continue;
+            }
+
+            // Sleep until Tasks are Queued
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait( lock, [&](){ return pending > 0 || stopping; } );
+            if( stopping ){
+                break;
+            }
+        }
+    }
+
+    // Take Task
+    bool thread_pool::take( const uint32_t index, task& target )
+    {
+        // Own Queue (back, most recently dealt tile)
+        {
+            queue& own = *queues[index];
+            std::lock_guard<std::mutex> lock( own.mutex );
+            if( !own.tasks.empty() ){
+                target = own.tasks.back();
+                own.tasks.pop_back();
+                pending--;
+                return true;
+            }
+        }
+
+        // Steal from Other Queues (front)
+        const size_t count = queues.size();
+        for( size_t i = 1; i < count; i++ ){
+            queue& other = *queues[( index + i ) % count];
+            std::lock_guard<std::mutex> lock( other.mutex );
+            if( !other.tasks.empty() ){
+                target = other.tasks.front();
+                other.tasks.pop_front();
+                pending--;
+                stolen++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Execute Task
+    void thread_pool::execute( const task& target )
+    {
+        target.owner->kernel( target.tile );
+        executed++;
+
+        // Last Tile releases Calling Thread (job lives on its stack until then)
+        target.owner->remaining--;
+    }
+
+    // Split Size into Tiles
+    std::vector<cv::Rect> make_tiles( const cv::Size& size, const size_t bytes_per_pixel, const size_t cache_bytes )
+    {
+        std::vector<cv::Rect> tiles;
+        if( size.width <= 0 || size.height <= 0 ){
+            return tiles;
+        }
+
+        // Full-Width Row Bands if Row Fits, otherwise Split Columns too
+        const size_t row_bytes = static_cast<size_t>( size.width ) * std::max<size_t>( 1, bytes_per_pixel );
+        const int32_t tile_width = ( row_bytes <= cache_bytes ) ? size.width : std::max<int32_t>( 1, static_cast<int32_t>( cache_bytes / std::max<size_t>( 1, bytes_per_pixel ) ) );
+        const size_t tile_row_bytes = static_cast<size_t>( tile_width ) * std::max<size_t>( 1, bytes_per_pixel );
+        const int32_t tile_height = std::max<int32_t>( 1, std::min<int32_t>( size.height, static_cast<int32_t>( cache_bytes / tile_row_bytes ) ) );
+
+        for( int32_t y = 0; y < size.height; y += tile_height ){
+            for( int32_t x = 0; x < size.width; x += tile_width ){
+                tiles.push_back( cv::Rect( x, y, std::min( tile_width, size.width - x ), std::min( tile_height, size.height - y ) ) );
+            }
+        }
+        return tiles;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef __PARALLEL__
+#define __PARALLEL__
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ This is parallel-for framework with persistent work-stealing thread pool and cache-sized 2D tiling.
+
+ parallel::thread_pool pool( parallel::options( 4, { 0, 1, 2, 3 } ) ); // 4 threads pinned to cores 0-3 (one pool per stage)
+ parallel::for_each_tile( pool, image.size(), image.elemSize(), [&]( const cv::Rect& tile ){ ... } );
+
+ Image is split into tiles that fit into cache (full-width row bands unless row is larger than budget).
+ Tiles are dealt round-robin into per-worker queues, worker pops its own queue from back and steals from front of others.
+ Calling thread works on tiles too and returns when all tiles of call are done.
+ Kernel must not call parallel::for_each_tile on same pool (no nested parallelism).
+*/
+
+namespace parallel
+{
+    // Options of Thread Pool
+    struct options
+    {
+        uint32_t threads;           // number of threads including calling thread (0: hardware concurrency)
+        std::vector<int32_t> cores; // cores to pin threads to (empty: no pinning, worker i is pinned to cores[i % size])
+
+        options( const uint32_t threads = 0, const std::vector<int32_t>& cores = std::vector<int32_t>() )
+            : threads( threads ), cores( cores )
+        {
+        }
+    };
+
+    // Pin Current Thread to Core (returns false if not supported)
+    bool pin_current_thread( const int32_t core );
+
+    // Thread Pool
+    class thread_pool
+    {
+    private:
+        // Job (one call of for_each_tile)
+        struct job
+        {
+            std::function<void( const cv::Rect& )> kernel;
+            std::atomic<uint32_t> remaining;
+        };
+
+        // Task (one tile)
+        struct task
+        {
+            job* owner;
+            cv::Rect tile;
+        };
+
+        // Queue of Worker
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        // Queues (last one belongs to calling thread)
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<uint32_t> pending;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping;
+
+        // Statistics
+        std::atomic<uint64_t> stolen;
+        std::atomic<uint64_t> executed;
+
+    public:
+        // Constructor
+        thread_pool( const options& config = options() );
+
+        // Destructor
+        ~thread_pool();
+
+        // Run Kernel on Tiles (blocks until all tiles are done)
+        void run( const std::vector<cv::Rect>& tiles, const std::function<void( const cv::Rect& )>& kernel );
+
+        // Get Number of Threads (including calling thread)
+        uint32_t get_threads() const { return static_cast<uint32_t>( queues.size() ); }
+
+        // Get Number of Stolen Tasks
+        uint64_t get_stolen() const { return stolen; }
+
+        // Get Number of Executed Tasks
+        uint64_t get_executed() const { return executed; }
+
+    private:
+        // Worker Loop
+        void work( const uint32_t index );
+
+        // Take Task (own queue from back, other queues from front)
+        bool take( const uint32_t index, task& target );
+
+        // Execute Task
+        void execute( const task& target );
+    };
+
+    // Split Size into Tiles that Fit into Cache Budget [bytes]
+    std::vector<cv::Rect> make_tiles( const cv::Size& size, const size_t bytes_per_pixel, const size_t cache_bytes = 128 * 1024 );
+
+    // Run Kernel on Cache-Sized Tiles of Image
+    inline void for_each_tile( thread_pool& pool, const cv::Size& size, const size_t bytes_per_pixel, const std::function<void( const cv::Rect& )>& kernel )
+    {
+        pool.run( make_tiles( size, bytes_per_pixel ), kernel );
+    }
+}
+
+#endif // __PARALLEL__
@@ -0,0 +1,217 @@
+/*
+ This is capture poller that gets capture from device without blocking main loop indefinitely.
+
+ capture_poller poller( device, configuration.camera_fps );
+ if( poller.poll( &capture ) == capture_poller::status::ready ){ ... }
+
+ poll( &capture )           : adaptive timeout, waits only when next frame is due (at most one frame interval)
+ poll( &capture, time_out ) : explicit timeout (0 is non-blocking)
+
+ Failure of device is propagated as k4a::error.
+*/
+
+#ifndef __POLLER__
+#define __POLLER__
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <ostream>
+
+#include <k4a/k4a.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+class capture_poller
+{
+public:
+    // Status
+    enum class status
+    {
+        ready,
+        timeout
+    };
+
+    // Frame Ready Callback
+    typedef std::function<void( const k4a::capture& )> callback_t;
+
+private:
+    // Device
+    k4a::device* device;
+    callback_t callback;
+
+    // Frame Interval (estimated from device timestamps)
+    std::chrono::microseconds frame_interval;
+    std::chrono::microseconds last_device_timestamp;
+    std::chrono::steady_clock::time_point last_arrival;
+
+    // Statistics
+    uint64_t polls;
+    uint64_t frames;
+    double wait_time;
+    double wait_cpu_time;
+    double start_cpu_time;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    // Constructor
+    capture_poller( k4a::device* device = nullptr, const k4a_fps_t fps = k4a_fps_t::K4A_FRAMES_PER_SECOND_30 )
+        : device( device ),
+          frame_interval( get_frame_interval( fps ) ),
+          last_device_timestamp( 0 ),
+          polls( 0 ),
+          frames( 0 ),
+          wait_time( 0.0 ),
+          wait_cpu_time( 0.0 ),
+          start_cpu_time( get_thread_cpu_time() ),
+          start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    // Set Frame Ready Callback
+    void set_callback( const callback_t& callback )
+    {
+        this->callback = callback;
+    }
+
+    // Poll with Adaptive Timeout
+    status poll( k4a::capture* capture )
+    {
+        return poll( capture, get_adaptive_time_out() );
+    }
+
+    // Poll with Timeout
+    status poll( k4a::capture* capture, const std::chrono::milliseconds time_out )
+    {
+        if( !device ){
+            throw k4a::error( "Failed to poll capture (device is not opened)!" );
+        }
+
+        // Get Capture Frame (throws k4a::error on failure)
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        const double begin_cpu_time = get_thread_cpu_time();
+        const bool result = device->get_capture( capture, time_out );
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        wait_time += std::chrono::duration<double, std::milli>( end - begin ).count();
+        wait_cpu_time += get_thread_cpu_time() - begin_cpu_time;
+        polls++;
+
+        if( !result ){
+            return status::timeout;
+        }
+
+        // Update Frame Interval
+        update_frame_interval( *capture, end );
+        frames++;
+
+        // Notify Frame Ready
+        if( callback ){
+            callback( *capture );
+        }
+
+        return status::ready;
+    }
+
+    // Get Adaptive Timeout (remaining time until next frame is due)
+    std::chrono::milliseconds get_adaptive_time_out() const
+    {
+        if( !frames ){
+            return std::chrono::duration_cast<std::chrono::milliseconds>( frame_interval );
+        }
+
+        // Wait until expected arrival with small margin, but never longer than one frame interval
+        // NOTE: Late frame is waited with margin too, so that polling loop does not spin.
+        constexpr std::chrono::milliseconds margin( 2 );
+        const std::chrono::steady_clock::duration remaining = last_arrival + frame_interval - std::chrono::steady_clock::now();
+        const std::chrono::milliseconds time_out = std::chrono::duration_cast<std::chrono::milliseconds>( remaining ) + margin;
+        return std::max( margin, std::min( time_out, std::chrono::duration_cast<std::chrono::milliseconds>( frame_interval ) ) );
+    }
+
+    // Get Estimated Frame Interval
+    std::chrono::microseconds get_frame_interval() const
+    {
+        return frame_interval;
+    }
+
+    // Report Statistics
+    void report( std::ostream& stream ) const
+    {
+        if( !frames ){
+            return;
+        }
+
+        // Wait Time is wall time blocked in get_capture, Idle is share of wall time this thread did not use CPU
+        const double wall_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        const double cpu_time = get_thread_cpu_time() - start_cpu_time;
+        stream << "capture : " << frames << " frames / " << polls << " polls"
+               << ", wait " << wait_time / frames << " ms/frame"
+               << " (cpu " << wait_cpu_time / frames << " ms/frame)"
+               << ", busy " << ( cpu_time - wait_cpu_time ) / frames << " ms/frame"
+               << ", idle cpu " << 100.0 * std::max( 0.0, 1.0 - cpu_time / wall_time ) << " %" << std::endl;
+    }
+
+private:
+    // Update Frame Interval
+    void update_frame_interval( const k4a::capture& capture, const std::chrono::steady_clock::time_point arrival )
+    {
+        last_arrival = arrival;
+
+        k4a::image image = capture.get_depth_image();
+        if( !image.handle() ){
+            image = capture.get_color_image();
+        }
+
+        if( !image.handle() ){
+            return;
+        }
+
+        // Exponential Moving Average of Device Timestamp Interval
+        const std::chrono::microseconds device_timestamp = image.get_device_timestamp();
+        const std::chrono::microseconds interval = device_timestamp - last_device_timestamp;
+        if( last_device_timestamp.count() && interval.count() > 0 && interval < frame_interval * 4 ){
+            frame_interval = ( frame_interval * 7 + interval ) / 8;
+        }
+        last_device_timestamp = device_timestamp;
+    }
+
+    // Get Frame Interval from FPS
+    static std::chrono::microseconds get_frame_interval( const k4a_fps_t fps )
+    {
+        switch( fps ){
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_5:
+                return std::chrono::microseconds( 200000 );
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_15:
+                return std::chrono::microseconds( 66667 );
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_30:
+            default:
+                return std::chrono::microseconds( 33333 );
+        }
+    }
+
+    // Get CPU Time of Calling Thread [ms]
+    static double get_thread_cpu_time()
+    {
+        #ifdef _WIN32
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        if( !GetThreadTimes( GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time ) ){
+            return 0.0;
+        }
+        const uint64_t kernel = ( static_cast<uint64_t>( kernel_time.dwHighDateTime ) << 32 ) | kernel_time.dwLowDateTime;
+        const uint64_t user   = ( static_cast<uint64_t>( user_time.dwHighDateTime ) << 32 ) | user_time.dwLowDateTime;
+        return ( kernel + user ) / 10000.0;
+        #else
+        timespec time;
+        clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time );
+        return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+        #endif
+    }
+};
+
+#endif // __POLLER__
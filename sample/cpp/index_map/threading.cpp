@@ -0,0 +1,366 @@
+#include "threading.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+#if defined( _WIN32 )
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Parse Cores ( "4-7" or "4,5,6,7" or "0,2-3" )
+    std::vector<int32_t> parse_cores( const std::string& text )
+    {
+        std::vector<int32_t> cores;
+        std::stringstream stream( text );
+        std::string item;
+        while( std::getline( stream, item, ',' ) ){
+            if( item.empty() ){
+                continue;
+            }
+            const size_t dash = item.find( '-' );
+            const int32_t first = std::stoi( item.substr( 0, dash ) );
+            const int32_t last = ( dash == std::string::npos ) ? first : std::stoi( item.substr( dash + 1 ) );
+            for( int32_t core = first; core <= last; core++ ){
+                cores.push_back( core );
+            }
+        }
+        return cores;
+    }
+
+    // Set Affinity of Calling Thread (previous affinity is returned if requested)
+    bool set_affinity( const std::vector<int32_t>& cores, std::vector<int32_t>* previous = nullptr )
+    {
+        if( cores.empty() ){
+            return true;
+        }
+
+        #if defined( _WIN32 )
+        // Previous Mask is Returned by SetThreadAffinityMask (cores out of mask are ignored)
+        constexpr int32_t bits = static_cast<int32_t>( sizeof( DWORD_PTR ) * 8 );
+        DWORD_PTR mask = 0;
+        for( const int32_t core : cores ){
+            if( core >= 0 && core < bits ){
+                mask |= static_cast<DWORD_PTR>( 1 ) << core;
+            }
+        }
+        const DWORD_PTR previous_mask = mask ? SetThreadAffinityMask( GetCurrentThread(), mask ) : 0;
+        if( !previous_mask ){
+            return false;
+        }
+        if( previous ){
+            previous->clear();
+            for( int32_t core = 0; core < bits; core++ ){
+                if( previous_mask & ( static_cast<DWORD_PTR>( 1 ) << core ) ){
+                    previous->push_back( core );
+                }
+            }
+        }
+        return true;
+        #elif defined( __linux__ )
+        // Previous Affinity
+        cpu_set_t set;
+        if( previous ){
+            previous->clear();
+            CPU_ZERO( &set );
+            if( pthread_getaffinity_np( pthread_self(), sizeof( set ), &set ) != 0 ){
+                return false;
+            }
+            for( int32_t core = 0; core < CPU_SETSIZE; core++ ){
+                if( CPU_ISSET( core, &set ) ){
+                    previous->push_back( core );
+                }
+            }
+        }
+
+        // Cores out of Set are Ignored
+        CPU_ZERO( &set );
+        for( const int32_t core : cores ){
+            if( core >= 0 && core < CPU_SETSIZE ){
+                CPU_SET( core, &set );
+            }
+        }
+        return CPU_COUNT( &set ) && pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0;
+        #else
+        return false;
+        #endif
+    }
+
+    // Raise Priority of Calling Thread
+    bool raise_priority()
+    {
+        #if defined( _WIN32 )
+        return SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) != 0;
+        #elif defined( __linux__ )
+        // Real-Time Scheduling (needs CAP_SYS_NICE or rtprio limit)
+        sched_param param;
+        param.sched_priority = 10;
+        if( pthread_setschedparam( pthread_self(), SCHED_FIFO, &param ) == 0 ){
+            return true;
+        }
+
+        // Lower Nice Value of Thread (needs RLIMIT_NICE)
+        const id_t thread = static_cast<id_t>( syscall( SYS_gettid ) );
+        for( int32_t nice = -10; nice < 0; nice += 5 ){
+            if( setpriority( PRIO_PROCESS, thread, nice ) == 0 ){
+                return true;
+            }
+        }
+        return false;
+        #else
+        return false;
+        #endif
+    }
+
+    // Get Core of Calling Thread
+    int32_t get_current_core()
+    {
+        #if defined( _WIN32 )
+        return static_cast<int32_t>( GetCurrentProcessorNumber() );
+        #elif defined( __linux__ )
+        return sched_getcpu();
+        #else
+        return 0;
+        #endif
+    }
+}
+
+namespace threading
+{
+    // Parse Configuration
+    configuration parse( const std::string& text )
+    {
+        configuration config;
+        std::stringstream stream( text );
+        std::string item;
+        while( std::getline( stream, item, ';' ) ){
+            const size_t equal = item.find( '=' );
+            if( equal == std::string::npos ){
+                continue;
+            }
+
+            const std::string name = item.substr( 0, equal );
+            std::string value = item.substr( equal + 1 );
+            stage target;
+            const size_t colon = value.find( ':' );
+            if( colon != std::string::npos ){
+                target.high_priority = ( value.substr( colon + 1 ) == "high" );
+                value = value.substr( 0, colon );
+            }
+            target.cores = parse_cores( value );
+
+            if( name == "capture" ){
+                config.capture = target;
+            }
+            else if( name == "tracking" ){
+                config.tracking = target;
+            }
+            else if( name == "display" ){
+                config.display = target;
+            }
+            else if( name == "kernels" ){
+                config.kernels = target;
+            }
+        }
+        return config;
+    }
+
+    // Apply Stage to Calling Thread
+    bool apply( const stage& target )
+    {
+        bool result = set_affinity( target.cores );
+        if( target.high_priority ){
+            result = raise_priority() && result;
+        }
+        return result;
+    }
+
+    // Get Description of Stage
+    std::string describe( const stage& target )
+    {
+        if( target.cores.empty() ){
+            return target.high_priority ? "any core, high priority" : "any core";
+        }
+
+        std::stringstream stream;
+        stream << "cores";
+        for( const int32_t core : target.cores ){
+            stream << " " << core;
+        }
+        stream << " (node " << get_numa_node( target.cores.front() ) << ")";
+        if( target.high_priority ){
+            stream << ", high priority";
+        }
+        return stream.str();
+    }
+
+    // Get NUMA Node of Core
+    int32_t get_numa_node( const int32_t core )
+    {
+        #if defined( _WIN32 )
+        UCHAR node = 0;
+        return GetNumaProcessorNode( static_cast<UCHAR>( core ), &node ) ? static_cast<int32_t>( node ) : 0;
+        #elif defined( __linux__ )
+        // Core Directory has Link to its Node
+        for( int32_t node = 0; node < 64; node++ ){
+            const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string( core ) + "/node" + std::to_string( node );
+            if( access( path.c_str(), F_OK ) == 0 ){
+                return node;
+            }
+        }
+        return 0;
+        #else
+        return 0;
+        #endif
+    }
+
+    // Get NUMA Node of Stage
+    int32_t get_numa_node( const stage& target )
+    {
+        return get_numa_node( target.cores.empty() ? get_current_core() : target.cores.front() );
+    }
+
+    // Scoped Affinity
+    scoped_affinity::scoped_affinity( const stage& target )
+        : changed( !target.cores.empty() && set_affinity( target.cores, &previous ) )
+    {
+    }
+
+    scoped_affinity::~scoped_affinity()
+    {
+        if( changed ){
+            set_affinity( previous );
+        }
+    }
+
+    // Frame Buffer on NUMA Node
+    node_buffer::node_buffer()
+        : data( nullptr ),
+          size( 0 ),
+          node( -1 )
+    {
+    }
+
+    node_buffer::~node_buffer()
+    {
+        allocate( 0, -1 );
+    }
+
+    // Allocate
+    void node_buffer::allocate( const size_t bytes, const int32_t target_node )
+    {
+        // Free Previous Buffer
+        if( data ){
+            #if defined( _WIN32 )
+            VirtualFree( data, 0, MEM_RELEASE );
+            #elif defined( __linux__ )
+            munmap( data, size );
+            #else
+            std::free( data );
+            #endif
+            data = nullptr;
+            size = 0;
+            node = -1;
+        }
+
+        if( !bytes ){
+            return;
+        }
+
+        #if defined( _WIN32 )
+        data = VirtualAllocExNuma( GetCurrentProcess(), nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>( target_node ) );
+        #elif defined( __linux__ )
+        void* mapped = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        data = ( mapped == MAP_FAILED ) ? nullptr : mapped;
+        if( data && target_node >= 0 ){
+            // Prefer Node for Pages of Buffer (MPOL_PREFERRED, no dependency on libnuma)
+            constexpr int32_t mpol_preferred = 1;
+            constexpr size_t bits = sizeof( unsigned long ) * 8;
+            std::vector<unsigned long> mask( static_cast<size_t>( target_node ) / bits + 1, 0 );
+            mask[target_node / bits] = 1ul << ( target_node % bits );
+            syscall( SYS_mbind, data, bytes, mpol_preferred, mask.data(), mask.size() * bits + 1, 0 );
+        }
+        #else
+        data = std::malloc( bytes );
+        #endif
+
+        if( !data ){
+            throw std::bad_alloc();
+        }
+        size = bytes;
+        node = target_node;
+
+        // Fault in Pages from Calling Thread
+        std::memset( data, 0, bytes );
+    }
+
+    // Create Mat on Buffer of NUMA Node
+    void create_on_node( cv::Mat& mat, node_buffer& buffer, const cv::Size& size, const int32_t type, const int32_t node )
+    {
+        if( mat.data && mat.data == buffer.get_data() && mat.size() == size && mat.type() == type ){
+            return;
+        }
+
+        const size_t bytes = static_cast<size_t>( size.area() ) * CV_ELEM_SIZE( type );
+        if( buffer.get_size() < bytes || buffer.get_node() != node ){
+            mat.release();
+            buffer.allocate( bytes, node );
+        }
+        mat = cv::Mat( size, type, buffer.get_data() );
+    }
+
+    // Frame Time Jitter
+    jitter_meter::jitter_meter( const std::chrono::microseconds nominal )
+        : nominal( nominal.count() / 1000.0 ),
+          count( 0 ),
+          mean( 0.0 ),
+          m2( 0.0 ),
+          max( 0.0 ),
+          late( 0 )
+    {
+    }
+
+    // Add Frame
+    void jitter_meter::add()
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if( last != std::chrono::steady_clock::time_point() ){
+            // Welford's Online Variance
+            const double interval = std::chrono::duration<double, std::milli>( now - last ).count();
+            count++;
+            const double delta = interval - mean;
+            mean += delta / count;
+            m2 += delta * ( interval - mean );
+            max = std::max( max, interval );
+            late += ( interval > nominal * 1.5 ) ? 1 : 0;
+        }
+        last = now;
+    }
+
+    // Report Statistics
+    void jitter_meter::report( std::ostream& stream, const std::string& name ) const
+    {
+        if( count < 2 ){
+            return;
+        }
+
+        const double deviation = std::sqrt( m2 / ( count - 1 ) );
+        stream << name << " : interval " << mean << " ms (jitter " << deviation << " ms stddev, " << max << " ms max, "
+               << late << " of " << count << " late)" << std::endl;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef __THREADING__
+#define __THREADING__
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+/*
+ This is threading configuration that places pipeline stages on cores and NUMA nodes.
+
+ threading::configuration config = threading::parse( "capture=2:high;tracking=4-7;display=1;kernels=8-11" );
+ threading::apply( config.capture );                      // pin calling thread (and raise priority if ":high")
+ threading::scoped_affinity scope( config.tracking );     // threads created in scope inherit affinity (Linux)
+ threading::create_on_node( mat, buffer, size, type, node ); // frame buffer on NUMA node of consuming stage
+
+ Stage is list of cores ("4-7" or "4,5,6,7"), empty stage is left to scheduler.
+ Raised priority uses SCHED_FIFO if permitted, otherwise lowest nice value that is permitted (Linux),
+ THREAD_PRIORITY_TIME_CRITICAL on Windows.
+ Frame buffers are bound to NUMA node with mbind (Linux, MPOL_PREFERRED) or VirtualAllocExNuma (Windows),
+ and are touched by calling thread, so that pages are faulted in on that node.
+*/
+
+namespace threading
+{
+    // Stage
+    struct stage
+    {
+        std::vector<int32_t> cores;
+        bool high_priority = false;
+    };
+
+    // Configuration of Pipeline
+    struct configuration
+    {
+        stage capture;  // device.get_capture and enqueue to tracker
+        stage tracking; // body tracking threads (inherit affinity of creating thread)
+        stage display;  // pop result, kernels dispatch, imshow
+        stage kernels;  // thread pool of per-pixel kernels
+    };
+
+    // Parse Configuration ( "stage=cores[:high];..." )
+    configuration parse( const std::string& text );
+
+    // Apply Stage to Calling Thread (returns false if any setting failed)
+    bool apply( const stage& target );
+
+    // Get Description of Stage
+    std::string describe( const stage& target );
+
+    // Get NUMA Node of Core (0 if unknown)
+    int32_t get_numa_node( const int32_t core );
+
+    // Get NUMA Node of Stage (node of first core, or node of core that calling thread runs on)
+    int32_t get_numa_node( const stage& target );
+
+    // Scoped Affinity (restores previous affinity of calling thread)
+    class scoped_affinity
+    {
+    private:
+        std::vector<int32_t> previous;
+        bool changed;
+
+    public:
+        scoped_affinity( const stage& target );
+        ~scoped_affinity();
+    };
+
+    // Frame Buffer on NUMA Node
+    class node_buffer
+    {
+    private:
+        void* data;
+        size_t size;
+        int32_t node;
+
+    public:
+        node_buffer();
+        ~node_buffer();
+        node_buffer( const node_buffer& ) = delete;
+        node_buffer& operator=( const node_buffer& ) = delete;
+
+        // Allocate (previous buffer is freed)
+        void allocate( const size_t bytes, const int32_t node );
+
+        void* get_data() const { return data; }
+        size_t get_size() const { return size; }
+        int32_t get_node() const { return node; }
+    };
+
+    // Create Mat on Buffer of NUMA Node (reallocates only if size or type changed)
+    void create_on_node( cv::Mat& mat, node_buffer& buffer, const cv::Size& size, const int32_t type, const int32_t node );
+
+    // Frame Time Jitter (intervals between frames of stage)
+    class jitter_meter
+    {
+    private:
+        std::chrono::steady_clock::time_point last;
+        double nominal;  // [ms]
+        uint64_t count;
+        double mean;
+        double m2;
+        double max;
+        uint64_t late;   // intervals longer than 1.5x nominal
+
+    public:
+        jitter_meter( const std::chrono::microseconds nominal = std::chrono::microseconds( 33333 ) );
+
+        // Add Frame (now)
+        void add();
+
+        // Report Statistics
+        void report( std::ostream& stream, const std::string& name ) const;
+    };
+}
+
+#endif // __THREADING__
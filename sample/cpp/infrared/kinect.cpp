@@ -1,7 +1,9 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
 kinect::kinect( const uint32_t index )
@@ -44,11 +46,18 @@ inline void kinect::initialize_sensor()
     device_configuration.synchronized_images_only = true;
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
+
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
 }
 
 // Finalize
 void kinect::finalize()
 {
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
     // Stop Cameras
     device.stop_cameras();
 
@@ -63,18 +72,30 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
 
-        // Draw
-        draw();
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
         if( key == 'q' ){
             break;
@@ -83,27 +104,28 @@ void kinect::run()
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Update Infrared
     update_infrared();
 
     // Release Capture Handle
     capture.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
-    }
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
 }
 
 // Update Infrared
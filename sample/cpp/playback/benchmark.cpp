@@ -0,0 +1,257 @@
+#include "benchmark.hpp"
+#include "custom_tracks.hpp"
+#include "frame_cache.hpp"
+#include "track_playback.hpp"
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+    // Analysis of Frame (mean of images, touches every pixel)
+    double analyze( const cv::Mat& color, const cv::Mat& depth, const cv::Mat& infrared )
+    {
+        double sum = 0.0;
+        if( !color.empty() ){
+            sum += cv::mean( color )[0];
+        }
+        if( !depth.empty() ){
+            sum += cv::mean( depth )[0];
+        }
+        if( !infrared.empty() ){
+            sum += cv::mean( infrared )[0];
+        }
+        return sum;
+    }
+
+    // Get Decoded Bytes of Frame
+    size_t get_bytes( const cv::Mat& color, const cv::Mat& depth, const cv::Mat& infrared )
+    {
+        return color.total() * color.elemSize() + depth.total() * depth.elemSize() + infrared.total() * infrared.elemSize();
+    }
+
+    // Get Bytes Read by Process (rchar of /proc/self/io, includes page cache hits, 0 if unavailable)
+    uint64_t get_read_bytes()
+    {
+        std::ifstream stream( "/proc/self/io" );
+        std::string key;
+        uint64_t value = 0;
+        while( stream >> key >> value ){
+            if( key == "rchar:" ){
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    // Get CPU Time of Process [ms] (sum of all threads)
+    double get_process_cpu_time()
+    {
+        #ifdef _WIN32
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        if( !GetProcessTimes( GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time ) ){
+            return 0.0;
+        }
+        const uint64_t kernel = ( static_cast<uint64_t>( kernel_time.dwHighDateTime ) << 32 ) | kernel_time.dwLowDateTime;
+        const uint64_t user   = ( static_cast<uint64_t>( user_time.dwHighDateTime ) << 32 ) | user_time.dwLowDateTime;
+        return ( kernel + user ) / 10000.0;
+        #else
+        timespec time;
+        clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &time );
+        return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+        #endif
+    }
+
+    // Report Pass
+    void report( const std::string& name, const uint32_t pass, const uint64_t frames, const size_t bytes, const double time )
+    {
+        std::cout << name << " pass " << pass << " : " << frames << " frames, " << time << " ms, "
+                  << frames * 1000.0 / time << " fps, " << bytes / 1048576.0 * 1000.0 / time << " MB/s" << std::endl;
+    }
+}
+
+// Benchmark Analysis Passes
+void benchmark_cache( const std::string& file, const uint32_t passes )
+{
+    const std::string cache_file = file + ".cache";
+    double mkv_checksum = 0.0;
+    double cache_checksum = 0.0;
+
+    // Build Cache (first pass, demux and decode once)
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const uint64_t frames = frame_cache::build( file, cache_file );
+    const double build_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    std::cout << "build : " << frames << " frames, " << build_time << " ms (" << cache_file << ")" << std::endl;
+
+    // Re-Decode MKV every Pass
+    for( uint32_t pass = 0; pass < passes; pass++ ){
+        start = std::chrono::steady_clock::now();
+        k4a::playback playback = k4a::playback::open( file.c_str() );
+        uint64_t count = 0;
+        size_t bytes = 0;
+        cv::Mat color;
+
+        k4a::capture capture;
+        while( playback.get_next_capture( &capture ) ){
+            const k4a::image color_image = capture.get_color_image();
+            const k4a::image depth_image = capture.get_depth_image();
+            const k4a::image infrared_image = capture.get_ir_image();
+
+            // Decode Color, Views of Depth and Infrared
+            color.release();
+            if( color_image.handle() ){
+                frame_cache::convert_color( color_image, color );
+            }
+            const cv::Mat depth = depth_image.handle() ? cv::Mat( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( depth_image.get_buffer() ), depth_image.get_stride_bytes() ) : cv::Mat();
+            const cv::Mat infrared = infrared_image.handle() ? cv::Mat( infrared_image.get_height_pixels(), infrared_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( infrared_image.get_buffer() ), infrared_image.get_stride_bytes() ) : cv::Mat();
+
+            mkv_checksum += analyze( color, depth, infrared );
+            bytes += get_bytes( color, depth, infrared );
+            count++;
+        }
+        playback.close();
+
+        report( "mkv  ", pass, count, bytes, std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() );
+    }
+
+    // Memory-Mapped Cache every Pass
+    for( uint32_t pass = 0; pass < passes; pass++ ){
+        start = std::chrono::steady_clock::now();
+        frame_cache cache( cache_file );
+        size_t bytes = 0;
+
+        for( uint64_t frame = 0; frame < cache.get_frames(); frame++ ){
+            // Zero-Copy Views
+            const cv::Mat color = cache.get_mat( frame, frame_cache::track::color );
+            const cv::Mat depth = cache.get_mat( frame, frame_cache::track::depth );
+            const cv::Mat infrared = cache.get_mat( frame, frame_cache::track::infrared );
+
+            cache_checksum += analyze( color, depth, infrared );
+            bytes += get_bytes( color, depth, infrared );
+        }
+
+        report( "cache", pass, cache.get_frames(), bytes, std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() );
+    }
+
+    // Checksum (same analysis result from both sources)
+    std::cout << "checksum : " << mkv_checksum << " (mkv), " << cache_checksum << " (cache)" << std::endl;
+}
+
+// Benchmark Passes with Track Selections
+void benchmark_tracks( const std::string& file )
+{
+    const std::vector<std::string> selections = { "all", "color", "depth", "ir", "depth,ir", "imu" };
+    for( const std::string& text : selections ){
+        const track_playback::selection select = track_playback::selection::parse( text );
+
+        // Open Playback
+        k4a::playback playback = k4a::playback::open( file.c_str() );
+        track_playback reader( playback, select );
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const double cpu_start = get_process_cpu_time();
+        const uint64_t read_start = get_read_bytes();
+        uint64_t captures = 0;
+        uint64_t samples = 0;
+
+        // Read Selected Image Tracks (decode color as consumer would)
+        if( select.tracks & track_playback::track::images ){
+            cv::Mat color;
+            k4a::capture capture;
+            while( reader.get_next_capture( &capture ) ){
+                const k4a::image color_image = capture.get_color_image();
+                if( color_image.handle() ){
+                    frame_cache::convert_color( color_image, color );
+                }
+                capture.reset();
+                captures++;
+            }
+        }
+
+        // Read IMU Samples
+        k4a_imu_sample_t sample;
+        while( reader.get_next_imu_sample( &sample ) ){
+            samples++;
+        }
+
+        const double time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        const double cpu_time = get_process_cpu_time() - cpu_start;
+        const uint64_t read_bytes = get_read_bytes() - read_start;
+        playback.close();
+
+        std::cout << text << " : " << captures << " captures, " << samples << " imu samples, " << time << " ms, "
+                  << cpu_time << " ms cpu, " << read_bytes / 1048576.0 << " MB read"
+                  << ( reader.is_reading_captures() ? " (whole captures)" : "" ) << std::endl;
+    }
+}
+
+// Benchmark Reading Processed Results
+void benchmark_results( const std::string& file )
+{
+    for( const bool results : { false, true } ){
+        // Open Playback
+        k4a::playback playback = k4a::playback::open( file.c_str() );
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const double cpu_start = get_process_cpu_time();
+        const uint64_t read_start = get_read_bytes();
+        uint64_t frames = 0;
+        uint64_t bodies = 0;
+
+        if( results ){
+            // Read Custom Tracks of Results (builtin tracks are not decoded)
+            result_reader reader( playback );
+            if( !reader.has_track( track_format::depth_filtered ) ){
+                throw k4a::error( "Failed to found processed results in " + file + " (record with \"processed\" profile)!" );
+            }
+
+            k4a::image depth_image;
+            k4a::image body_index_image;
+            while( reader.get_next_depth( &depth_image ) ){
+                reader.get_next_body_index( &body_index_image );
+                frames++;
+            }
+
+            std::chrono::microseconds timestamp;
+            std::vector<track_format::body> frame_bodies;
+            while( reader.get_next_bodies( &timestamp, &frame_bodies ) ){
+                bodies += frame_bodies.size();
+            }
+        }
+        else{
+            // Read Whole Captures (decode color as consumer would)
+            cv::Mat color;
+            k4a::capture capture;
+            while( playback.get_next_capture( &capture ) ){
+                const k4a::image color_image = capture.get_color_image();
+                if( color_image.handle() ){
+                    frame_cache::convert_color( color_image, color );
+                }
+                capture.reset();
+                frames++;
+            }
+        }
+
+        const double time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        const double cpu_time = get_process_cpu_time() - cpu_start;
+        const uint64_t read_bytes = get_read_bytes() - read_start;
+        playback.close();
+
+        std::cout << ( results ? "results" : "captures" ) << " : " << frames << " frames, " << bodies << " bodies, " << time << " ms, "
+                  << cpu_time << " ms cpu, " << read_bytes / 1048576.0 << " MB read" << std::endl;
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+#include <string>
+
+// Benchmark Analysis Passes over Recording, Re-Decoding MKV every Pass vs Memory-Mapped Frame Cache Decoded Once
+// Cache is built as <file>.cache by first pass, each pass computes mean of color, depth and infrared images.
+void benchmark_cache( const std::string& file, const uint32_t passes = 3 );
+
+// Benchmark Passes over Recording with Track Selections (all, color, depth, ir, depth+ir, imu)
+// Each pass reads selected tracks (and decodes color if selected), reports time, CPU time and bytes read from file.
+void benchmark_tracks( const std::string& file );
+
+// Benchmark Reading Processed Results from Custom Tracks vs Reading Whole Captures (and decoding color)
+// Results are filtered depth, body index map and joints written by "processed" profile of record sample.
+void benchmark_results( const std::string& file );
+
+#endif // __BENCHMARK__
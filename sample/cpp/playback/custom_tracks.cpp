@@ -0,0 +1,126 @@
+#include "custom_tracks.hpp"
+#include "track_playback.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Constructor
+result_reader::result_reader( k4a::playback& playback )
+    : playback( &playback )
+{
+    // Find Custom Tracks of Results
+    const std::vector<std::string> names = track_playback::get_track_names( playback );
+    depth_track = find_video_track( names, track_format::depth_filtered, 16 );
+    body_index_track = find_video_track( names, track_format::body_index, 8 );
+    has_joints = std::find( names.begin(), names.end(), track_format::body_joints ) != names.end();
+}
+
+// Track is in Recording
+bool result_reader::has_track( const std::string& name ) const
+{
+    if( name == depth_track.name ){
+        return depth_track.found;
+    }
+    if( name == body_index_track.name ){
+        return body_index_track.found;
+    }
+    if( name == track_format::body_joints ){
+        return has_joints;
+    }
+    return false;
+}
+
+// Get Next Filtered Depth
+bool result_reader::get_next_depth( k4a::image* image )
+{
+    return get_next_image( depth_track, k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16, image );
+}
+
+// Get Next Body Index Map
+bool result_reader::get_next_body_index( k4a::image* image )
+{
+    return get_next_image( body_index_track, k4a_image_format_t::K4A_IMAGE_FORMAT_CUSTOM8, image );
+}
+
+// Get Next Bodies
+bool result_reader::get_next_bodies( std::chrono::microseconds* timestamp, std::vector<track_format::body>* bodies )
+{
+    if( !has_joints ){
+        return false;
+    }
+
+    k4a::data_block block;
+    if( !playback->get_next_data_block( track_format::body_joints, &block ) ){
+        return false;
+    }
+
+    if( !track_format::deserialize_bodies( block.get_buffer(), block.get_buffer_size(), bodies ) ){
+        throw k4a::error( std::string( "Failed to read block of track " ) + track_format::body_joints + " (unexpected size)!" );
+    }
+    *timestamp = block.get_device_timestamp_usec();
+    return true;
+}
+
+// Find Video Track and Read Format from Codec Private
+result_reader::video_track result_reader::find_video_track( const std::vector<std::string>& names, const std::string& name, const uint16_t bits ) const
+{
+    video_track target = { name, { 0, 0, 0, 0 }, false };
+    if( std::find( names.begin(), names.end(), name ) == names.end() ){
+        return target;
+    }
+
+    // Get Codec Private
+    size_t size = 0;
+    if( k4a_playback_track_get_codec_context( playback->handle(), name.c_str(), nullptr, &size ) != K4A_BUFFER_RESULT_TOO_SMALL ){
+        throw k4a::error( "Failed to get codec context of track " + name + "!" );
+    }
+    std::vector<uint8_t> context( size );
+    if( k4a_playback_track_get_codec_context( playback->handle(), name.c_str(), context.data(), &size ) != K4A_BUFFER_RESULT_SUCCEEDED ){
+        throw k4a::error( "Failed to get codec context of track " + name + "!" );
+    }
+
+    // Parse BITMAPINFOHEADER
+    if( !track_format::parse_codec_context( context, &target.format ) || target.format.bits != bits ){
+        throw k4a::error( "Failed to parse codec context of track " + name + " (unexpected format)!" );
+    }
+    target.found = true;
+    return target;
+}
+
+// Read Next Block of Video Track into Image
+bool result_reader::get_next_image( const video_track& target, const k4a_image_format_t format, k4a::image* image )
+{
+    if( !target.found ){
+        return false;
+    }
+
+    k4a::data_block block;
+    if( !playback->get_next_data_block( target.name.c_str(), &block ) ){
+        return false;
+    }
+
+    const int32_t width = target.format.width;
+    const int32_t height = target.format.height;
+    const int32_t bytes = target.format.bits / 8;
+    const size_t pixels = static_cast<size_t>( width ) * height;
+    if( block.get_buffer_size() != pixels * bytes ){
+        throw k4a::error( "Failed to read block of track " + target.name + " (unexpected size)!" );
+    }
+
+    k4a::image result = k4a::image::create( format, width, height, width * bytes );
+    const uint8_t* source = block.get_buffer();
+    if( target.format.fourcc == track_format::make_fourcc( "b16g" ) ){
+        // Convert Big Endian (b16g) to Little Endian
+        uint16_t* destination = reinterpret_cast<uint16_t*>( result.get_buffer() );
+        for( size_t i = 0; i < pixels; i++ ){
+            destination[i] = static_cast<uint16_t>( ( source[i * 2] << 8 ) | source[i * 2 + 1] );
+        }
+    }
+    else{
+        std::memcpy( result.get_buffer(), source, pixels * bytes );
+    }
+
+    result.set_device_timestamp( block.get_device_timestamp_usec() );
+    *image = std::move( result );
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef __CUSTOM_TRACKS__
+#define __CUSTOM_TRACKS__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+#include "track_format.hpp"
+
+/*
+ This is typed reader of custom tracks that hold processed results (written by record sample, see track_format.hpp).
+
+ result_reader reader( playback );
+ if( reader.has_track( track_format::depth_filtered ) ){
+     reader.get_next_depth( &depth_image );                 // DEPTH16 image of filtered depth
+ }
+ reader.get_next_body_index( &body_index_image );           // CUSTOM8 image of body index map
+ reader.get_next_bodies( &timestamp, &bodies );             // joints of bodies
+
+ Each track is read with playback.get_next_data_block( name ), so that blocks of color, depth and infrared tracks are
+ not copied into images and color is not decoded. Each track has own read position in k4arecord.
+ Size and format of video tracks are taken from codec private (BITMAPINFOHEADER) of track.
+*/
+
+class result_reader
+{
+private:
+    // Video Track
+    struct video_track
+    {
+        std::string name;
+        track_format::video_format format;
+        bool found;
+    };
+
+    k4a::playback* playback;
+    video_track depth_track;
+    video_track body_index_track;
+    bool has_joints;
+
+public:
+    // Constructor
+    result_reader( k4a::playback& playback );
+
+    // Track is in Recording
+    bool has_track( const std::string& name ) const;
+
+    // Get Next Filtered Depth (DEPTH16, returns false at end of track)
+    bool get_next_depth( k4a::image* image );
+
+    // Get Next Body Index Map (CUSTOM8, returns false at end of track)
+    bool get_next_body_index( k4a::image* image );
+
+    // Get Next Bodies (returns false at end of track)
+    bool get_next_bodies( std::chrono::microseconds* timestamp, std::vector<track_format::body>* bodies );
+
+private:
+    // Find Video Track and Read Format from Codec Private
+    video_track find_video_track( const std::vector<std::string>& names, const std::string& name, const uint16_t bits ) const;
+
+    // Read Next Block of Video Track into Image
+    bool get_next_image( const video_track& target, const k4a_image_format_t format, k4a::image* image );
+};
+
+#endif // __CUSTOM_TRACKS__
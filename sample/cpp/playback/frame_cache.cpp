@@ -0,0 +1,380 @@
+#include "frame_cache.hpp"
+
+#include <k4arecord/playback.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Magic and Version of Cache File
+    constexpr char magic[8] = { 'K', '4', 'A', 'C', 'A', 'C', 'H', 'E' };
+    constexpr uint32_t version = 1;
+    constexpr uint32_t page_size = 4096;
+
+    // Round Up to Multiple of Alignment
+    uint64_t round_up( const uint64_t value, const uint64_t alignment )
+    {
+        return ( value + alignment - 1 ) / alignment * alignment;
+    }
+
+    // Get Mat Type of Image Format
+    int32_t get_type( const int32_t format )
+    {
+        return ( format == k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32 ) ? CV_8UC4 : CV_16UC1;
+    }
+
+    // Copy Rows of Image into Slot (fixed stride)
+    void copy_rows( const uint8_t* source, const int32_t source_stride, uint8_t* destination, const int32_t stride, const int32_t height )
+    {
+        for( int32_t y = 0; y < height; y++ ){
+            std::memcpy( destination + static_cast<size_t>( y ) * stride, source + static_cast<size_t>( y ) * source_stride, stride );
+        }
+    }
+}
+
+// Constructor
+frame_cache::frame_cache()
+    : data( nullptr ),
+      size( 0 ),
+      #ifdef _WIN32
+      file_handle( nullptr ),
+      mapping_handle( nullptr ),
+      #else
+      descriptor( -1 ),
+      #endif
+      header( nullptr ),
+      index( nullptr )
+{
+}
+
+frame_cache::frame_cache( const std::string& file )
+    : frame_cache()
+{
+    // Open Cache
+    open( file );
+}
+
+// Destructor
+frame_cache::~frame_cache()
+{
+    // Close Cache
+    close();
+}
+
+// Build Cache from Recording
+uint64_t frame_cache::build( const std::string& recording, const std::string& file )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( recording.c_str() );
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    const k4a::calibration calibration = playback.get_calibration();
+    std::vector<uint8_t> raw_calibration = playback.get_raw_calibration();
+
+    // Create Header
+    file_header target;
+    std::memset( &target, 0, sizeof( target ) );
+    std::memcpy( target.magic, magic, sizeof( magic ) );
+    target.version = version;
+    target.page_size = page_size;
+    target.depth_mode = calibration.depth_mode;
+    target.color_resolution = calibration.color_resolution;
+
+    const bool enabled[track::count] = { configuration.color_track_enabled, configuration.depth_track_enabled, configuration.ir_track_enabled };
+    const k4a_image_format_t formats[track::count] = { K4A_IMAGE_FORMAT_COLOR_BGRA32, K4A_IMAGE_FORMAT_DEPTH16, K4A_IMAGE_FORMAT_IR16 };
+    const k4a_calibration_camera_t* cameras[track::count] = { &calibration.color_camera_calibration, &calibration.depth_camera_calibration, &calibration.depth_camera_calibration };
+    uint64_t slot_bytes = 0;
+    for( int32_t i = 0; i < track::count; i++ ){
+        if( !enabled[i] ){
+            continue;
+        }
+
+        track_header& layout = target.tracks[i];
+        layout.format = formats[i];
+        layout.width = cameras[i]->resolution_width;
+        layout.height = cameras[i]->resolution_height;
+        layout.stride = layout.width * CV_ELEM_SIZE( get_type( layout.format ) );
+        layout.offset = slot_bytes;
+        layout.bytes = static_cast<uint64_t>( layout.stride ) * layout.height;
+        slot_bytes += round_up( layout.bytes, page_size );
+    }
+    target.slot_bytes = slot_bytes;
+    target.data_offset = page_size;
+
+    // Open File (header is written last)
+    std::ofstream stream( file, std::ios::binary | std::ios::trunc );
+    if( !stream.is_open() ){
+        throw k4a::error( "Failed to open cache file!" );
+    }
+    std::vector<uint8_t> slot( page_size, 0 );
+    stream.write( reinterpret_cast<const char*>( slot.data() ), page_size );
+    slot.assign( slot_bytes, 0 );
+
+    // Write Slots of Captures
+    std::vector<index_entry> entries;
+    cv::Mat bgra;
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        index_entry entry;
+        std::memset( &entry, 0, sizeof( entry ) );
+
+        const k4a::image images[track::count] = { capture.get_color_image(), capture.get_depth_image(), capture.get_ir_image() };
+        for( int32_t i = 0; i < track::count; i++ ){
+            const track_header& layout = target.tracks[i];
+            uint8_t* destination = slot.data() + layout.offset;
+            if( !layout.format || !images[i].handle() ){
+                if( layout.format ){
+                    std::memset( destination, 0, layout.bytes );
+                }
+                continue;
+            }
+
+            const k4a::image& image = images[i];
+            if( image.get_width_pixels() != layout.width || image.get_height_pixels() != layout.height ){
+                throw k4a::error( "Failed to build cache (image size differs from calibration)!" );
+            }
+
+            // Decode Color, Copy Depth and Infrared
+            if( i == track::color ){
+                convert_color( image, bgra );
+                copy_rows( bgra.data, static_cast<int32_t>( bgra.step ), destination, layout.stride, layout.height );
+            }
+            else{
+                copy_rows( image.get_buffer(), image.get_stride_bytes(), destination, layout.stride, layout.height );
+            }
+
+            entry.timestamps[i] = image.get_device_timestamp().count();
+            entry.present |= 1u << i;
+        }
+
+        stream.write( reinterpret_cast<const char*>( slot.data() ), static_cast<std::streamsize>( slot.size() ) );
+        entries.push_back( entry );
+        capture.reset();
+    }
+    playback.close();
+
+    // Write Index and Calibration
+    target.frames = entries.size();
+    target.index_offset = target.data_offset + target.frames * target.slot_bytes;
+    target.calibration_offset = target.index_offset + target.frames * sizeof( index_entry );
+    target.calibration_bytes = raw_calibration.size();
+    stream.write( reinterpret_cast<const char*>( entries.data() ), static_cast<std::streamsize>( entries.size() * sizeof( index_entry ) ) );
+    stream.write( reinterpret_cast<const char*>( raw_calibration.data() ), static_cast<std::streamsize>( raw_calibration.size() ) );
+
+    // Write Header
+    stream.seekp( 0 );
+    stream.write( reinterpret_cast<const char*>( &target ), sizeof( target ) );
+    stream.close();
+    if( stream.fail() ){
+        throw k4a::error( "Failed to write cache file!" );
+    }
+
+    return target.frames;
+}
+
+// Check Cache is Complete
+bool frame_cache::is_valid( const std::string& file )
+{
+    std::ifstream stream( file, std::ios::binary | std::ios::ate );
+    if( !stream.is_open() ){
+        return false;
+    }
+
+    const uint64_t bytes = static_cast<uint64_t>( stream.tellg() );
+    file_header target;
+    stream.seekg( 0 );
+    if( !stream.read( reinterpret_cast<char*>( &target ), sizeof( target ) ) ){
+        return false;
+    }
+
+    return std::memcmp( target.magic, magic, sizeof( magic ) ) == 0 && target.version == version && bytes >= target.calibration_offset + target.calibration_bytes;
+}
+
+// Convert Color Image to BGRA
+void frame_cache::convert_color( const k4a::image& image, cv::Mat& bgra )
+{
+    const int32_t width = image.get_width_pixels();
+    const int32_t height = image.get_height_pixels();
+    uint8_t* buffer = const_cast<uint8_t*>( image.get_buffer() );
+    switch( image.get_format() )
+    {
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+        {
+            const cv::Mat bgr = cv::imdecode( cv::Mat( 1, static_cast<int32_t>( image.get_size() ), CV_8UC1, buffer ), cv::IMREAD_COLOR );
+            cv::cvtColor( bgr, bgra, cv::COLOR_BGR2BGRA );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+            cv::cvtColor( cv::Mat( height + height / 2, width, CV_8UC1, buffer, image.get_stride_bytes() ), bgra, cv::COLOR_YUV2BGRA_NV12 );
+            break;
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+            cv::cvtColor( cv::Mat( height, width, CV_8UC2, buffer, image.get_stride_bytes() ), bgra, cv::COLOR_YUV2BGRA_YUY2 );
+            break;
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+            cv::Mat( height, width, CV_8UC4, buffer, image.get_stride_bytes() ).copyTo( bgra );
+            break;
+        default:
+            throw k4a::error( "Failed to convert this format!" );
+    }
+}
+
+// Open Cache
+void frame_cache::open( const std::string& file )
+{
+    // Close Previous Cache
+    close();
+
+    if( !is_valid( file ) ){
+        throw k4a::error( "Failed to open cache (not exists or incomplete)!" );
+    }
+
+    // Map File (read-only)
+    #ifdef _WIN32
+    file_handle = CreateFileA( file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    if( file_handle == INVALID_HANDLE_VALUE ){
+        file_handle = nullptr;
+        throw k4a::error( "Failed to open cache file!" );
+    }
+    LARGE_INTEGER bytes;
+    if( !GetFileSizeEx( file_handle, &bytes ) ){
+        close();
+        throw k4a::error( "Failed to open cache file!" );
+    }
+    mapping_handle = CreateFileMappingA( file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    const void* mapped = mapping_handle ? MapViewOfFile( mapping_handle, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+    if( !mapped ){
+        close();
+        throw k4a::error( "Failed to map cache file!" );
+    }
+    size = static_cast<size_t>( bytes.QuadPart );
+    #else
+    descriptor = ::open( file.c_str(), O_RDONLY );
+    struct stat status;
+    if( descriptor < 0 || fstat( descriptor, &status ) != 0 ){
+        close();
+        throw k4a::error( "Failed to open cache file!" );
+    }
+    size = static_cast<size_t>( status.st_size );
+    void* mapped = mmap( nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0 );
+    if( mapped == MAP_FAILED ){
+        size = 0;
+        close();
+        throw k4a::error( "Failed to map cache file!" );
+    }
+
+    // Analysis Passes Read Frames in Order (read-ahead of page cache)
+    madvise( mapped, size, MADV_SEQUENTIAL );
+    #endif
+
+    data = static_cast<const uint8_t*>( mapped );
+    header = reinterpret_cast<const file_header*>( data );
+    index = reinterpret_cast<const index_entry*>( data + header->index_offset );
+}
+
+// Close Cache
+void frame_cache::close()
+{
+    #ifdef _WIN32
+    if( data ){
+        UnmapViewOfFile( const_cast<uint8_t*>( data ) );
+    }
+    if( mapping_handle ){
+        CloseHandle( mapping_handle );
+    }
+    if( file_handle ){
+        CloseHandle( file_handle );
+    }
+    file_handle = nullptr;
+    mapping_handle = nullptr;
+    #else
+    if( data ){
+        munmap( const_cast<uint8_t*>( data ), size );
+    }
+    if( descriptor >= 0 ){
+        ::close( descriptor );
+    }
+    descriptor = -1;
+    #endif
+
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    index = nullptr;
+}
+
+// Get Pointer to Image in Mapping
+const uint8_t* frame_cache::get_data( const uint64_t frame, const track target ) const
+{
+    if( !header || frame >= header->frames || !is_enabled( target ) || !is_present( frame, target ) ){
+        return nullptr;
+    }
+
+    return data + header->data_offset + frame * header->slot_bytes + header->tracks[target].offset;
+}
+
+// Get Image
+k4a::image frame_cache::get_image( const uint64_t frame, const track target ) const
+{
+    const uint8_t* buffer = get_data( frame, target );
+    if( !buffer ){
+        return k4a::image();
+    }
+
+    // Create Image on Mapping (no release callback, mapping outlives image)
+    const track_header& layout = header->tracks[target];
+    k4a::image image = k4a::image::create_from_buffer( static_cast<k4a_image_format_t>( layout.format ), layout.width, layout.height, layout.stride, const_cast<uint8_t*>( buffer ), static_cast<size_t>( layout.bytes ), nullptr, nullptr );
+    image.set_device_timestamp( get_timestamp( frame, target ) );
+    return image;
+}
+
+// Get Mat
+cv::Mat frame_cache::get_mat( const uint64_t frame, const track target ) const
+{
+    const uint8_t* buffer = get_data( frame, target );
+    if( !buffer ){
+        return cv::Mat();
+    }
+
+    const track_header& layout = header->tracks[target];
+    return cv::Mat( layout.height, layout.width, get_type( layout.format ), const_cast<uint8_t*>( buffer ), layout.stride );
+}
+
+// Get Capture of Images
+k4a::capture frame_cache::get_capture( const uint64_t frame ) const
+{
+    if( !header || frame >= header->frames ){
+        return k4a::capture();
+    }
+
+    k4a::capture capture = k4a::capture::create();
+    if( is_present( frame, track::color ) ){
+        capture.set_color_image( get_image( frame, track::color ) );
+    }
+    if( is_present( frame, track::depth ) ){
+        capture.set_depth_image( get_image( frame, track::depth ) );
+    }
+    if( is_present( frame, track::infrared ) ){
+        capture.set_ir_image( get_image( frame, track::infrared ) );
+    }
+    return capture;
+}
+
+// Get Calibration
+k4a::calibration frame_cache::get_calibration() const
+{
+    char* raw_calibration = reinterpret_cast<char*>( const_cast<uint8_t*>( data + header->calibration_offset ) );
+    return k4a::calibration::get_from_raw( raw_calibration, static_cast<size_t>( header->calibration_bytes ), static_cast<k4a_depth_mode_t>( header->depth_mode ), static_cast<k4a_color_resolution_t>( header->color_resolution ) );
+}
@@ -0,0 +1,157 @@
+#ifndef __FRAME_CACHE__
+#define __FRAME_CACHE__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+/*
+ This is decoded frame cache of recording that is memory-mapped for repeated analysis passes.
+
+ frame_cache::build( "file.mkv", "file.cache" );               // first pass (demux and decode once)
+ frame_cache cache( "file.cache" );                            // later passes (mmap)
+ k4a::capture capture = cache.get_capture( frame );            // zero-copy images
+ cv::Mat depth = cache.get_mat( frame, frame_cache::track::depth );
+
+ Frames are stored decoded with fixed stride (BGRA, DEPTH16, IR16), so that frame is at fixed offset and is not parsed.
+ Images are views into read-only mapping of file, served from page cache after first pass (must not be written).
+
+ +--------------------+ 0
+ | header             |   magic, tracks (format, size, stride, offset in slot), offsets of sections
+ +--------------------+ page size
+ | slot of frame 0    |   color | depth | infrared (each track is page aligned, absent image is zero)
+ | slot of frame 1    |
+ | ...                |
+ +--------------------+ index offset
+ | index              |   device timestamps of images and present flags per frame
+ +--------------------+ calibration offset
+ | raw calibration    |
+ +--------------------+
+ Header is written last, so that incomplete cache (interrupted build) is rejected.
+*/
+
+class frame_cache
+{
+public:
+    // Track
+    enum track : int32_t
+    {
+        color = 0,
+        depth = 1,
+        infrared = 2,
+        count = 3
+    };
+
+private:
+    // Track Header
+    struct track_header
+    {
+        int32_t format;     // k4a_image_format_t (0 if track is disabled)
+        int32_t width;
+        int32_t height;
+        int32_t stride;
+        uint64_t offset;    // offset in slot
+        uint64_t bytes;     // stride x height
+    };
+
+    // File Header
+    struct file_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t page_size;
+        uint64_t frames;
+        uint64_t slot_bytes;
+        uint64_t data_offset;
+        uint64_t index_offset;
+        uint64_t calibration_offset;
+        uint64_t calibration_bytes;
+        int32_t depth_mode;
+        int32_t color_resolution;
+        track_header tracks[track::count];
+    };
+
+    // Index Entry
+    struct index_entry
+    {
+        int64_t timestamps[track::count]; // device timestamp [us]
+        uint32_t present;                 // bit of track
+        uint32_t reserved;
+    };
+
+    // Mapping
+    const uint8_t* data;
+    size_t size;
+    #ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+    #else
+    int32_t descriptor;
+    #endif
+
+    // Header and Index (in mapping)
+    const file_header* header;
+    const index_entry* index;
+
+public:
+    // Constructor
+    frame_cache();
+    frame_cache( const std::string& file );
+
+    // Destructor
+    ~frame_cache();
+
+    frame_cache( const frame_cache& ) = delete;
+    frame_cache& operator=( const frame_cache& ) = delete;
+
+    // Build Cache from Recording (decodes all captures, returns number of frames)
+    static uint64_t build( const std::string& recording, const std::string& file );
+
+    // Check Cache is Complete (header written and sections in file)
+    static bool is_valid( const std::string& file );
+
+    // Convert Color Image to BGRA (decodes MJPG, converts NV12 and YUY2, copies BGRA)
+    static void convert_color( const k4a::image& image, cv::Mat& bgra );
+
+    // Open Cache (maps file)
+    void open( const std::string& file );
+
+    // Close Cache (unmaps file, images of cache must be released before)
+    void close();
+
+    // Get Number of Frames
+    uint64_t get_frames() const { return header ? header->frames : 0; }
+
+    // Track is Enabled
+    bool is_enabled( const track target ) const { return header && header->tracks[target].format; }
+
+    // Image is Present in Frame
+    bool is_present( const uint64_t frame, const track target ) const { return ( index[frame].present >> target ) & 1; }
+
+    // Get Device Timestamp of Image
+    std::chrono::microseconds get_timestamp( const uint64_t frame, const track target ) const { return std::chrono::microseconds( index[frame].timestamps[target] ); }
+
+    // Get Image (zero-copy view, empty if not present)
+    k4a::image get_image( const uint64_t frame, const track target ) const;
+
+    // Get Mat (zero-copy view, empty if not present)
+    cv::Mat get_mat( const uint64_t frame, const track target ) const;
+
+    // Get Capture of Images (zero-copy views)
+    k4a::capture get_capture( const uint64_t frame ) const;
+
+    // Get Calibration
+    k4a::calibration get_calibration() const;
+
+    // Get Mapped Bytes
+    size_t get_size() const { return size; }
+
+private:
+    // Get Pointer to Image in Mapping
+    const uint8_t* get_data( const uint64_t frame, const track target ) const;
+};
+
+#endif // __FRAME_CACHE__
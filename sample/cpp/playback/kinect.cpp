@@ -1,19 +1,33 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
 kinect::kinect( const uint32_t index )
-    : device_index( index )
+    : device_index( index ),
+      loop( scheduler::mode::live ),
+      end_of_file( false ),
+      prefetch( 0 ),
+      use_cache( false ),
+      cache_frame( 0 )
 {
     // Initialize
     initialize();
 }
 
 // Constructor
-kinect::kinect( const filesystem::path path )
-    : playback_file( path )
+kinect::kinect( const filesystem::path path, const scheduler::mode mode, const double speed, const bool use_cache, const read_ahead::options& prefetch )
+    : device_index( 0 ),
+      loop( mode ),
+      clock( speed ),
+      playback_file( path ),
+      end_of_file( false ),
+      prefetch( prefetch ),
+      use_cache( use_cache ),
+      cache_frame( 0 )
 {
     // Initialize
     initialize();
@@ -32,6 +46,10 @@ void kinect::initialize()
         // Initialize Sensor
         initialize_sensor();
     }
+    else if( use_cache ){
+        // Initialize Frame Cache
+        initialize_cache();
+    }
     else{
         // Initialize Playback
         initialize_playback();
@@ -59,6 +77,9 @@ inline void kinect::initialize_sensor()
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
 
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
     // Get Calibration
     calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
 
@@ -73,11 +94,46 @@ inline void kinect::initialize_playback()
         throw k4a::error( "Failed to found file path!" );
     }
 
-    // Open Playback
-    playback = k4a::playback::open( playback_file.generic_string().c_str() );
+    if( prefetch.depth ){
+        // Open Read-Ahead Playback (demux and decode on threads)
+        reader.open( playback_file.generic_string(), prefetch );
+
+        // Get Calibration
+        calibration = reader.get_calibration();
+    }
+    else{
+        // Open Playback (reads only selected tracks)
+        playback = k4a::playback::open( playback_file.generic_string().c_str() );
+        tracks = track_playback( playback, prefetch.tracks );
+
+        // Get Calibration
+        calibration = playback.get_calibration();
+    }
+
+    // Create Transformation
+    transformation = k4a::transformation( calibration );
+}
+
+// Initialize Frame Cache
+inline void kinect::initialize_cache()
+{
+    if( !filesystem::is_regular_file( playback_file ) || !filesystem::exists( playback_file ) ){
+        throw k4a::error( "Failed to found file path!" );
+    }
+
+    // Build Cache (decode once, rebuilt if missing, incomplete or older than recording)
+    filesystem::path cache_file = playback_file;
+    cache_file += ".cache";
+    if( !frame_cache::is_valid( cache_file.generic_string() ) || filesystem::last_write_time( cache_file ) < filesystem::last_write_time( playback_file ) ){
+        std::cout << "building frame cache " << cache_file.generic_string() << std::endl;
+        frame_cache::build( playback_file.generic_string(), cache_file.generic_string() );
+    }
+
+    // Open Cache
+    cache.open( cache_file.generic_string() );
 
     // Get Calibration
-    calibration = playback.get_calibration();
+    calibration = cache.get_calibration();
 
     // Create Transformation
     transformation = k4a::transformation( calibration );
@@ -86,6 +142,14 @@ inline void kinect::initialize_playback()
 // Finalize
 void kinect::finalize()
 {
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+    clock.report( std::cout );
+    if( !playback_file.empty() && !use_cache && prefetch.depth ){
+        reader.report( std::cout );
+    }
+
     // Destroy Transformation
     transformation.destroy();
 
@@ -96,9 +160,10 @@ void kinect::finalize()
         // Close Device
         device.close();
     }
-    else{
+    else if( !use_cache ){
         // Close Playback
         playback.close();
+        reader.close();
     }
 
     // Close Window
@@ -109,30 +174,51 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
 
-        // Draw
-        draw();
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
         constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
-        if( key == 'q' ){
+        if( key == 'q' || end_of_file ){
             break;
         }
+
+        // Change Replay Speed
+        if( key == '+' || key == '-' ){
+            const double speed = ( key == '+' ) ? clock.get_speed() * 2.0 : clock.get_speed() / 2.0;
+            clock.set_speed( std::max( replay_clock::min_speed, std::min( speed, replay_clock::max_speed ) ) );
+            std::cout << "replay speed : " << clock.get_speed() << "x" << std::endl;
+        }
     }
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Update Color
     update_color();
@@ -145,25 +231,50 @@ void kinect::update()
 
     // Release Capture Handle
     capture.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
     // Get Capture Frame
     if( playback_file.empty() ){
-        constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-        const bool result = device.get_capture( &capture, time_out );
-        if( !result ){
-            throw k4a::error( "Failed to capture!" );
-        }
+        // Poll Capture Frame (waits until next frame or UI refresh is due)
+        const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+        return poller.poll( &capture, time_out ) == capture_poller::status::ready;
     }
     else{
-        const bool result = playback.get_next_capture( &capture );
-        if( !result ){
-            // EOF
-            std::exit( EXIT_SUCCESS );
+        // Get Next Capture (kept until it is due)
+        if( !capture.handle() ){
+            if( use_cache ){
+                // Get Views into Frame Cache (no demuxing and decoding)
+                capture = cache.get_capture( cache_frame++ );
+            }
+            else if( prefetch.depth ){
+                // Pop Decoded Capture from Read-Ahead (waits until UI refresh is due)
+                const read_ahead::status status = reader.pop( &capture, loop.get_time_out() );
+                if( status == read_ahead::status::timeout ){
+                    return false;
+                }
+            }
+            else{
+                tracks.get_next_capture( &capture );
+            }
+
+            if( !capture.handle() ){
+                // EOF
+                end_of_file = true;
+                return false;
+            }
         }
+
+        if( loop.get_mode() != scheduler::mode::paced ){
+            return true;
+        }
+
+        // Wait until Capture is Due at Recorded Device Timestamp (or until UI refresh is due)
+        return clock.wait( scheduler::get_device_timestamp( capture ), loop.get_next_ui_refresh() );
     }
 }
 
@@ -192,6 +303,10 @@ inline void kinect::update_transformation()
         // Transform Color Image to Depth Camera
         transformed_color_image = transformation.color_image_to_depth_camera( depth_image, color_image );
     }
+    else if( color_image.get_format() == k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32 ){
+        // Transform Color Image to Depth Camera (decoded by frame cache)
+        transformed_color_image = transformation.color_image_to_depth_camera( depth_image, color_image );
+    }
     else{
         // Decode Motion JPEG, and Create Color Image from Buffer
         color = k4a::get_mat( color_image );
@@ -225,8 +340,8 @@ inline void kinect::draw_color()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    color = k4a::get_mat( color_image );
+    // Get cv::Mat from k4a::image (view of frame cache without copy)
+    color = k4a::get_mat( color_image, !use_cache );
 
     // Release Color Image Handle
     color_image.reset();
@@ -239,8 +354,8 @@ inline void kinect::draw_depth()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    depth = k4a::get_mat( depth_image );
+    // Get cv::Mat from k4a::image (view of frame cache without copy)
+    depth = k4a::get_mat( depth_image, !use_cache );
 
     // Release Depth Image Handle
     depth_image.reset();
@@ -5,6 +5,12 @@
 #include <k4arecord/playback.hpp>
 #include <opencv2/opencv.hpp>
 
+#include "frame_cache.hpp"
+#include "poller.hpp"
+#include "read_ahead.hpp"
+#include "replay_clock.hpp"
+#include "scheduler.hpp"
+
 #if __has_include(<filesystem>)
 #include <filesystem>
 namespace filesystem = std::filesystem;
@@ -23,12 +29,26 @@ private:
     // Kinect
     k4a::device device;
     k4a::playback playback;
+    track_playback tracks;
     k4a::capture capture;
     k4a::calibration calibration;
     k4a::transformation transformation;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
+    replay_clock clock;
     filesystem::path playback_file;
+    bool end_of_file;
+
+    // Read-Ahead Playback (demux and decode threads, disabled if depth is 0)
+    read_ahead reader;
+    read_ahead::options prefetch;
+
+    // Frame Cache (images of cache are views into mapping, declared before images)
+    frame_cache cache;
+    bool use_cache;
+    uint64_t cache_frame;
 
     // Color
     k4a::image color_image;
@@ -48,8 +68,8 @@ public:
     // Constructor
     kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
 
-    // Constructor
-    kinect( const filesystem::path path );
+    // Constructor (mode is scheduler::mode::paced or scheduler::mode::fast, speed is 0.25x - 16x for paced, prefetch is read-ahead of playback)
+    kinect( const filesystem::path path, const scheduler::mode mode = scheduler::mode::paced, const double speed = 1.0, const bool use_cache = false, const read_ahead::options& prefetch = read_ahead::options() );
 
     // Destructor
     ~kinect();
@@ -58,7 +78,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -76,11 +96,14 @@ private:
     // Initialize Playback
     void initialize_playback();
 
+    // Initialize Frame Cache
+    void initialize_cache();
+
     // Finalize
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Color
     void update_color();
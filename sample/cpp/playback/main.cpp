@@ -1,20 +1,49 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "benchmark.hpp"
 
 int main( int argc, char* argv[] )
 {
     try{
+        const std::string mode = ( argc > 1 ) ? argv[1] : "file";
+        if( mode == "benchmark" ){
+            // Analysis Passes over Recording, MKV vs Frame Cache
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_cache( file );
+            return 0;
+        }
+        if( mode == "tracks" ){
+            // Passes over Recording with each Track Selection
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_tracks( file );
+            return 0;
+        }
+        if( mode == "results" ){
+            // Read Processed Results from Custom Tracks vs Whole Captures
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_results( file );
+            return 0;
+        }
+
         /*
         // Sensor
         const uint32_t index = K4A_DEVICE_DEFAULT;
         kinect kinect( index );
         */
         ///*
-        // File
+        // File ("cache" replays from memory-mapped frame cache that is built on first run)
         const filesystem::path file = "../file.mkv";
-        kinect kinect( file );
+        const scheduler::mode replay_mode = scheduler::mode::paced; // or scheduler::mode::fast
+        const double speed = 1.0; // 0.25x - 16x (change with '+' and '-' key)
+        const bool use_cache = ( mode == "cache" );
+        // Read-Ahead and Tracks ("file <depth> <decoders> <tracks>", depth 0 is synchronous playback, tracks e.g. "depth,ir")
+        const uint32_t depth = ( argc > 2 ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 8;
+        const uint32_t decoders = ( argc > 3 ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 2;
+        const track_playback::selection tracks = ( argc > 4 ) ? track_playback::selection::parse( argv[4] ) : track_playback::selection();
+        kinect kinect( file, replay_mode, speed, use_cache, read_ahead::options( depth, decoders, tracks ) );
         //*/
         kinect.run();
     }
@@ -23,4 +52,4 @@ int main( int argc, char* argv[] )
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,245 @@
+#include "read_ahead.hpp"
+#include "frame_cache.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// Constructor
+read_ahead::read_ahead()
+    : stopping( false ),
+      next_sequence( 0 ),
+      end_sequence( std::numeric_limits<uint64_t>::max() ),
+      in_flight( 0 ),
+      popped( 0 ),
+      stalls( 0 ),
+      stall_time( 0 ),
+      max_stall( 0 ),
+      decode_time( 0 ),
+      max_reordered( 0 )
+{
+}
+
+// Destructor
+read_ahead::~read_ahead()
+{
+    // Close
+    close();
+}
+
+// Open Recording and Start Threads
+void read_ahead::open( const std::string& file, const options& config )
+{
+    // Close Previous Recording
+    close();
+
+    // Open Playback (used only by demux thread after here)
+    playback = k4a::playback::open( file.c_str() );
+    calibration = playback.get_calibration();
+
+    this->config = options( std::max( config.depth, 1u ), std::max( config.decoders, 1u ), config.tracks );
+    reader = track_playback( playback, this->config.tracks );
+    stopping = false;
+    next_sequence = 0;
+    end_sequence = std::numeric_limits<uint64_t>::max();
+    in_flight = 0;
+    error.clear();
+
+    // Start Threads
+    demuxer = std::thread( &read_ahead::demux, this );
+    for( uint32_t i = 0; i < this->config.decoders; i++ ){
+        decoders.emplace_back( &read_ahead::decode, this );
+    }
+}
+
+// Stop Threads and Close Recording
+void read_ahead::close()
+{
+    // Stop Threads
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    space_available.notify_all();
+    job_available.notify_all();
+    capture_available.notify_all();
+
+    if( demuxer.joinable() ){
+        demuxer.join();
+    }
+    for( std::thread& decoder : decoders ){
+        decoder.join();
+    }
+    decoders.clear();
+
+    // Release Captures before Playback
+    jobs.clear();
+    decoded.clear();
+
+    // Close Playback
+    playback.close();
+}
+
+// Pop Next Capture in Order
+read_ahead::status read_ahead::pop( k4a::capture* capture, const std::chrono::milliseconds time_out )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock( mutex );
+
+    // Wait Next Capture (stall if it is not decoded yet)
+    const auto is_available = [&](){
+        return !error.empty() || decoded.count( next_sequence ) || next_sequence >= end_sequence;
+    };
+    if( !is_available() ){
+        capture_available.wait_for( lock, time_out, is_available );
+
+        const std::chrono::steady_clock::duration stall = std::chrono::steady_clock::now() - start;
+        stall_time += stall;
+        max_stall = std::max( max_stall, stall );
+        stalls++;
+    }
+
+    // NOTE: Exception can not cross thread boundary, error of threads is thrown here.
+    if( !error.empty() ){
+        throw k4a::error( error );
+    }
+
+    const std::map<uint64_t, k4a::capture>::iterator it = decoded.find( next_sequence );
+    if( it == decoded.end() ){
+        return ( next_sequence >= end_sequence ) ? status::end : status::timeout;
+    }
+
+    // Pop Capture
+    *capture = std::move( it->second );
+    decoded.erase( it );
+    next_sequence++;
+    in_flight--;
+    popped++;
+    lock.unlock();
+
+    space_available.notify_one();
+    return status::ready;
+}
+
+// Report Statistics
+void read_ahead::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    const double frames = static_cast<double>( popped ? popped : 1 );
+    stream << "read-ahead : depth " << config.depth << ", " << config.decoders << " decoders, tracks " << config.tracks.describe() << ", " << popped << " captures, "
+           << stalls << " stalls, " << std::chrono::duration<double, std::milli>( stall_time ).count() << " ms stall time (max "
+           << std::chrono::duration<double, std::milli>( max_stall ).count() << " ms), "
+           << std::chrono::duration<double, std::milli>( decode_time ).count() / frames << " ms decode/capture, "
+           << max_reordered << " max reordered" << std::endl;
+}
+
+// Demux Loop
+void read_ahead::demux()
+{
+    // NOTE: Exception can not cross thread boundary, error is passed to consumer.
+    try{
+        uint64_t sequence = 0;
+        while( true ){
+            // Wait Space of Read-Ahead
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                space_available.wait( lock, [&](){ return stopping || in_flight < config.depth; } );
+                if( stopping ){
+                    return;
+                }
+            }
+
+            // Demux Next Capture
+            k4a::capture capture;
+            if( !reader.get_next_capture( &capture ) ){
+                break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                jobs.push_back( job{ sequence++, std::move( capture ) } );
+                in_flight++;
+            }
+            job_available.notify_one();
+        }
+
+        // End of File
+        std::lock_guard<std::mutex> lock( mutex );
+        end_sequence = sequence;
+    }
+    catch( const k4a::error& exception ){
+        std::lock_guard<std::mutex> lock( mutex );
+        error = exception.what();
+    }
+
+    job_available.notify_all();
+    capture_available.notify_all();
+}
+
+// Decode Loop
+void read_ahead::decode()
+{
+    while( true ){
+        // Wait Job
+        job current;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            job_available.wait( lock, [&](){ return stopping || !jobs.empty() || end_sequence != std::numeric_limits<uint64_t>::max() || !error.empty(); } );
+            if( stopping || jobs.empty() ){
+                return;
+            }
+            current = std::move( jobs.front() );
+            jobs.pop_front();
+        }
+
+        // Decode (out of order across decode threads)
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        k4a::capture result;
+        std::string message;
+        try{
+            result = decode_capture( current.capture );
+        }
+        catch( const k4a::error& exception ){
+            message = exception.what();
+        }
+        catch( const cv::Exception& exception ){
+            message = exception.what();
+        }
+        current.capture.reset();
+
+        // Reorder by Sequence
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !message.empty() ){
+                error = message;
+            }
+            decoded[current.sequence] = std::move( result );
+            decode_time += std::chrono::steady_clock::now() - start;
+            max_reordered = std::max( max_reordered, static_cast<uint32_t>( decoded.size() ) );
+        }
+        capture_available.notify_all();
+    }
+}
+
+// Decode Color Image of Capture to BGRA
+k4a::capture read_ahead::decode_capture( const k4a::capture& capture )
+{
+    const k4a::image color_image = capture.get_color_image();
+    if( !color_image.handle() || color_image.get_format() == k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32 ){
+        return capture;
+    }
+
+    // Decode into Buffer of BGRA Image
+    const int32_t width = color_image.get_width_pixels();
+    const int32_t height = color_image.get_height_pixels();
+    k4a::image bgra_image = k4a::image::create( k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4 );
+    cv::Mat bgra( height, width, CV_8UC4, bgra_image.get_buffer(), bgra_image.get_stride_bytes() );
+    frame_cache::convert_color( color_image, bgra );
+    bgra_image.set_device_timestamp( color_image.get_device_timestamp() );
+
+    // Create Capture with Decoded Color Image
+    k4a::capture result = k4a::capture::create();
+    result.set_color_image( bgra_image );
+    result.set_depth_image( capture.get_depth_image() );
+    result.set_ir_image( capture.get_ir_image() );
+    return result;
+}
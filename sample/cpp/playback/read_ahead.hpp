@@ -0,0 +1,140 @@
+#ifndef __READ_AHEAD__
+#define __READ_AHEAD__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+#include "track_playback.hpp"
+
+/*
+ This is read-ahead playback that demuxes and decodes captures of recording ahead of consumer.
+
+ read_ahead reader;
+ reader.open( "file.mkv", read_ahead::options( 8, 2 ) ); // depth of read-ahead, decode threads
+ k4a::capture capture;
+ if( reader.pop( &capture, time_out ) == read_ahead::status::ready ){ ... } // color image is decoded to BGRA
+
+ demux thread   : get_next_capture() of selected tracks in order, blocks while depth captures are in flight
+ decode threads : decode color image (MJPG, NV12, YUY2) to BGRA out of order
+ consumer       : pop() returns captures in order of recording (reordered by sequence number)
+
+ Time that consumer waits for next capture is stall (read-ahead did not keep up).
+ Failure of playback or decode is propagated as k4a::error from pop().
+*/
+
+class read_ahead
+{
+public:
+    // Status of Pop
+    enum class status
+    {
+        ready,
+        timeout,
+        end
+    };
+
+    // Options
+    struct options
+    {
+        uint32_t depth;                   // max captures in flight (demuxed but not popped)
+        uint32_t decoders;                // decode threads
+        track_playback::selection tracks; // image tracks to read
+
+        options( const uint32_t depth = 8, const uint32_t decoders = 2, const track_playback::selection& tracks = track_playback::selection() )
+            : depth( depth ),
+              decoders( decoders ),
+              tracks( tracks )
+        {
+        }
+    };
+
+private:
+    // Job
+    struct job
+    {
+        uint64_t sequence;
+        k4a::capture capture;
+    };
+
+    // Playback
+    k4a::playback playback;
+    track_playback reader;
+    k4a::calibration calibration;
+    options config;
+
+    // Threads
+    std::thread demuxer;
+    std::vector<std::thread> decoders;
+    std::mutex mutex;
+    std::condition_variable space_available;
+    std::condition_variable job_available;
+    std::condition_variable capture_available;
+    bool stopping;
+
+    // Queues
+    std::deque<job> jobs;
+    std::map<uint64_t, k4a::capture> decoded;
+    uint64_t next_sequence;  // next sequence to pop
+    uint64_t end_sequence;   // number of captures (set at end of file)
+    uint32_t in_flight;
+    std::string error;
+
+    // Statistics
+    uint64_t popped;
+    uint64_t stalls;
+    std::chrono::steady_clock::duration stall_time;
+    std::chrono::steady_clock::duration max_stall;
+    std::chrono::steady_clock::duration decode_time;
+    uint32_t max_reordered;
+
+public:
+    // Constructor
+    read_ahead();
+
+    // Destructor
+    ~read_ahead();
+
+    read_ahead( const read_ahead& ) = delete;
+    read_ahead& operator=( const read_ahead& ) = delete;
+
+    // Open Recording and Start Threads
+    void open( const std::string& file, const options& config = options() );
+
+    // Stop Threads and Close Recording
+    void close();
+
+    // Pop Next Capture in Order (waits until time out)
+    status pop( k4a::capture* capture, const std::chrono::milliseconds time_out );
+
+    // Get Calibration
+    const k4a::calibration& get_calibration() const { return calibration; }
+
+    // Get Options
+    const options& get_options() const { return config; }
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Demux Loop
+    void demux();
+
+    // Decode Loop
+    void decode();
+
+    // Decode Color Image of Capture to BGRA
+    static k4a::capture decode_capture( const k4a::capture& capture );
+};
+
+#endif // __READ_AHEAD__
@@ -0,0 +1,183 @@
+/*
+ This is replay clock that schedules captures of recording at their device timestamps.
+
+ replay_clock clock( 1.0 );
+ if( clock.wait( device_timestamp, deadline ) ){ ... } // false if deadline came first, call again with same timestamp
+
+ Speed multiplier is 0.25x - 16x, due time of frame is base time + ( device timestamp - base timestamp ) / speed.
+ Frame that is later than resync threshold rebases the clock, so that replay does not burst to catch up.
+
+ lateness : wall time between due time and release of frame
+ drift    : elapsed wall time x speed minus elapsed media time at the last frame (since last rebase)
+*/
+
+#ifndef __REPLAY_CLOCK__
+#define __REPLAY_CLOCK__
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <thread>
+
+#include <k4a/k4a.hpp>
+
+class replay_clock
+{
+public:
+    // Speed Range
+    static constexpr double min_speed = 0.25;
+    static constexpr double max_speed = 16.0;
+
+private:
+    // Speed
+    double speed;
+
+    // Time Base
+    bool started;
+    std::chrono::microseconds base_timestamp;
+    std::chrono::microseconds last_timestamp;
+    std::chrono::steady_clock::time_point base_time;
+    std::chrono::steady_clock::duration resync_threshold;
+
+    // Statistics
+    uint64_t frames;
+    uint64_t late_frames;
+    uint64_t resyncs;
+    double total_lateness;
+    double max_lateness;
+    double drift;
+
+public:
+    // Constructor
+    replay_clock( const double speed = 1.0, const std::chrono::milliseconds resync_threshold = std::chrono::milliseconds( 250 ) )
+        : speed( check_speed( speed ) ),
+          started( false ),
+          base_timestamp( 0 ),
+          last_timestamp( 0 ),
+          resync_threshold( resync_threshold ),
+          frames( 0 ),
+          late_frames( 0 ),
+          resyncs( 0 ),
+          total_lateness( 0.0 ),
+          max_lateness( 0.0 ),
+          drift( 0.0 )
+    {
+    }
+
+    // Set Speed (rebases clock at last released frame)
+    void set_speed( const double speed )
+    {
+        this->speed = check_speed( speed );
+        if( started ){
+            rebase( last_timestamp, std::chrono::steady_clock::now() );
+        }
+    }
+
+    // Get Speed
+    double get_speed() const
+    {
+        return speed;
+    }
+
+    // Wait until Frame is Due (returns false if deadline came first)
+    bool wait( const std::chrono::microseconds device_timestamp, const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max() )
+    {
+        // First Frame (or Seek Backward) Defines Time Base
+        if( !started || device_timestamp < last_timestamp ){
+            started = true;
+            rebase( device_timestamp, std::chrono::steady_clock::now() );
+            release( device_timestamp, std::chrono::steady_clock::now() );
+            return true;
+        }
+
+        // Sleep until Due Time or Deadline
+        const std::chrono::steady_clock::time_point due = get_due_time( device_timestamp );
+        sleep_until( std::min( due, deadline ) );
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if( now < due ){
+            return false;
+        }
+
+        // Resync if Frame is too Late (e.g. decoding stalled)
+        if( now - due > resync_threshold ){
+            resyncs++;
+            rebase( device_timestamp, now );
+        }
+
+        release( device_timestamp, now );
+        return true;
+    }
+
+    // Report Lateness and Drift
+    void report( std::ostream& stream ) const
+    {
+        if( !frames ){
+            return;
+        }
+
+        stream << "replay (" << speed << "x) : " << frames << " frames"
+               << ", lateness " << total_lateness / frames << " ms/frame (max " << max_lateness << " ms)"
+               << ", late " << late_frames << " frames"
+               << ", drift " << drift << " ms"
+               << ", resync " << resyncs << std::endl;
+    }
+
+private:
+    // Get Due Time of Frame
+    std::chrono::steady_clock::time_point get_due_time( const std::chrono::microseconds device_timestamp ) const
+    {
+        const std::chrono::duration<double, std::micro> offset( ( device_timestamp - base_timestamp ).count() / speed );
+        return base_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>( offset );
+    }
+
+    // Rebase Clock to Frame
+    void rebase( const std::chrono::microseconds device_timestamp, const std::chrono::steady_clock::time_point time )
+    {
+        base_timestamp = device_timestamp;
+        base_time = time;
+    }
+
+    // Release Frame
+    void release( const std::chrono::microseconds device_timestamp, const std::chrono::steady_clock::time_point now )
+    {
+        // Lateness against Due Time
+        constexpr double late_threshold = 1.0;
+        const double lateness = std::max( 0.0, std::chrono::duration<double, std::milli>( now - get_due_time( device_timestamp ) ).count() );
+        total_lateness += lateness;
+        max_lateness = std::max( max_lateness, lateness );
+        if( lateness > late_threshold ){
+            late_frames++;
+        }
+
+        // Drift of Media Time against Wall Time (positive is behind)
+        const double media_time = std::chrono::duration<double, std::milli>( device_timestamp - base_timestamp ).count();
+        const double wall_time = std::chrono::duration<double, std::milli>( now - base_time ).count() * speed;
+        drift = wall_time - media_time;
+
+        last_timestamp = device_timestamp;
+        frames++;
+    }
+
+    // Sleep until Time
+    // NOTE: Sleep is coarse on some platforms, last part is waited by yield to release frame on time.
+    static void sleep_until( const std::chrono::steady_clock::time_point time )
+    {
+        constexpr std::chrono::milliseconds spin( 2 );
+        std::this_thread::sleep_until( time - spin );
+        while( std::chrono::steady_clock::now() < time ){
+            std::this_thread::yield();
+        }
+    }
+
+    // Check Speed
+    static double check_speed( const double speed )
+    {
+        if( !std::isfinite( speed ) || speed < min_speed || speed > max_speed ){
+            throw k4a::error( "Failed to set replay speed (must be 0.25x - 16x)!" );
+        }
+        return speed;
+    }
+};
+
+#endif // __REPLAY_CLOCK__
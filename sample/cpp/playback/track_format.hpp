@@ -0,0 +1,171 @@
+#ifndef __TRACK_FORMAT__
+#define __TRACK_FORMAT__
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ This is format of custom tracks that hold processed results in recording (same file in record and playback samples).
+
+ DEPTH_FILTERED : video track (V_MS/VFW/FOURCC "b16g"), filtered depth, 16 bit big endian like DEPTH track
+ BODY_INDEX     : video track (V_MS/VFW/FOURCC "Y800"), body index map, 8 bit (255 is background)
+ BODY_JOINTS    : subtitle track (S_K4A/BODY_JOINTS), one block per body frame
+
+ Codec private of video tracks is BITMAPINFOHEADER (40 bytes, little endian) like builtin tracks of k4arecord.
+ Block of BODY_JOINTS is little endian : uint32 bodies, { uint32 id, { float position[3] [mm], float orientation[4] (w, x, y, z),
+ int32 confidence } * 32 joints } * bodies
+*/
+
+namespace track_format
+{
+    // Names of Tracks
+    constexpr const char* depth_filtered = "DEPTH_FILTERED";
+    constexpr const char* body_index = "BODY_INDEX";
+    constexpr const char* body_joints = "BODY_JOINTS";
+
+    // Codec IDs
+    constexpr const char* video_codec = "V_MS/VFW/FOURCC";
+    constexpr const char* joints_codec = "S_K4A/BODY_JOINTS";
+
+    // Joint of Body
+    constexpr uint32_t joint_count = 32;
+    struct joint
+    {
+        float position[3];
+        float orientation[4];
+        int32_t confidence;
+    };
+
+    // Body
+    struct body
+    {
+        uint32_t id;
+        joint joints[joint_count];
+    };
+
+    // Size of Serialized Body
+    constexpr size_t body_bytes = sizeof( uint32_t ) + joint_count * ( sizeof( float ) * 7 + sizeof( int32_t ) );
+
+    // Create FOURCC
+    inline uint32_t make_fourcc( const char* code )
+    {
+        return static_cast<uint32_t>( static_cast<uint8_t>( code[0] ) ) | static_cast<uint32_t>( static_cast<uint8_t>( code[1] ) ) << 8 |
+               static_cast<uint32_t>( static_cast<uint8_t>( code[2] ) ) << 16 | static_cast<uint32_t>( static_cast<uint8_t>( code[3] ) ) << 24;
+    }
+
+    // Video Format
+    struct video_format
+    {
+        int32_t width;
+        int32_t height;
+        uint16_t bits;   // bits per pixel (8 or 16)
+        uint32_t fourcc;
+    };
+
+    // Serialize Value (host byte order, little endian on platforms of SDK)
+    template<typename type>
+    inline void put( std::vector<uint8_t>& buffer, const type value )
+    {
+        uint8_t bytes[sizeof( type )];
+        std::memcpy( bytes, &value, sizeof( type ) );
+        buffer.insert( buffer.end(), bytes, bytes + sizeof( type ) );
+    }
+
+    // Deserialize Value (host byte order, little endian on platforms of SDK)
+    template<typename type>
+    inline type get( const uint8_t* buffer, size_t& offset )
+    {
+        type value;
+        std::memcpy( &value, buffer + offset, sizeof( type ) );
+        offset += sizeof( type );
+        return value;
+    }
+
+    // Create Codec Private of Video Track (BITMAPINFOHEADER)
+    inline std::vector<uint8_t> make_codec_context( const video_format& format )
+    {
+        std::vector<uint8_t> context;
+        put<uint32_t>( context, 40 );                                                  // biSize
+        put<int32_t>( context, format.width );                                         // biWidth
+        put<int32_t>( context, format.height );                                        // biHeight
+        put<uint16_t>( context, 1 );                                                   // biPlanes
+        put<uint16_t>( context, format.bits );                                         // biBitCount
+        put<uint32_t>( context, format.fourcc );                                       // biCompression
+        put<uint32_t>( context, static_cast<uint32_t>( format.width * format.height * format.bits / 8 ) ); // biSizeImage
+        put<int32_t>( context, 0 );                                                    // biXPelsPerMeter
+        put<int32_t>( context, 0 );                                                    // biYPelsPerMeter
+        put<uint32_t>( context, 0 );                                                   // biClrUsed
+        put<uint32_t>( context, 0 );                                                   // biClrImportant
+        return context;
+    }
+
+    // Parse Codec Private of Video Track (returns false if it is not BITMAPINFOHEADER)
+    inline bool parse_codec_context( const std::vector<uint8_t>& context, video_format* format )
+    {
+        if( context.size() < 40 ){
+            return false;
+        }
+
+        size_t offset = 4;
+        format->width = get<int32_t>( context.data(), offset );
+        format->height = get<int32_t>( context.data(), offset );
+        offset += sizeof( uint16_t );
+        format->bits = get<uint16_t>( context.data(), offset );
+        format->fourcc = get<uint32_t>( context.data(), offset );
+        return true;
+    }
+
+    // Serialize Bodies into Block
+    inline std::vector<uint8_t> serialize_bodies( const std::vector<body>& bodies )
+    {
+        std::vector<uint8_t> block;
+        block.reserve( sizeof( uint32_t ) + bodies.size() * body_bytes );
+        put<uint32_t>( block, static_cast<uint32_t>( bodies.size() ) );
+        for( const body& target : bodies ){
+            put<uint32_t>( block, target.id );
+            for( const joint& point : target.joints ){
+                for( const float value : point.position ){
+                    put<float>( block, value );
+                }
+                for( const float value : point.orientation ){
+                    put<float>( block, value );
+                }
+                put<int32_t>( block, point.confidence );
+            }
+        }
+        return block;
+    }
+
+    // Deserialize Bodies from Block (returns false if size of block does not match)
+    inline bool deserialize_bodies( const uint8_t* block, const size_t size, std::vector<body>* bodies )
+    {
+        if( size < sizeof( uint32_t ) ){
+            return false;
+        }
+
+        size_t offset = 0;
+        const uint32_t count = get<uint32_t>( block, offset );
+        if( size != sizeof( uint32_t ) + count * body_bytes ){
+            return false;
+        }
+
+        bodies->resize( count );
+        for( body& target : *bodies ){
+            target.id = get<uint32_t>( block, offset );
+            for( joint& point : target.joints ){
+                for( float& value : point.position ){
+                    value = get<float>( block, offset );
+                }
+                for( float& value : point.orientation ){
+                    value = get<float>( block, offset );
+                }
+                point.confidence = get<int32_t>( block, offset );
+            }
+        }
+        return true;
+    }
+}
+
+#endif // __TRACK_FORMAT__
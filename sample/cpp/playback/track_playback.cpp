@@ -0,0 +1,257 @@
+#include "track_playback.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    // Release Data Block of Image (image owns block that holds buffer)
+    void release_block( void* buffer, void* context )
+    {
+        delete static_cast<k4a::data_block*>( context );
+    }
+
+    // Get Bytes per Row of Raw Color Format
+    int32_t get_stride( const k4a_image_format_t format, const int32_t width )
+    {
+        switch( format )
+        {
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                return width * 4;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+                return width * 2;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+                return width;
+            default:
+                return 0;
+        }
+    }
+}
+
+// Parse Selection
+track_playback::selection track_playback::selection::parse( const std::string& text )
+{
+    selection result( 0 );
+    std::stringstream stream( text );
+    std::string item;
+    while( std::getline( stream, item, ',' ) ){
+        if( item == "all" ){
+            result.tracks |= track::all;
+        }
+        else if( item == "color" ){
+            result.tracks |= track::color;
+        }
+        else if( item == "depth" ){
+            result.tracks |= track::depth;
+        }
+        else if( item == "ir" ){
+            result.tracks |= track::infrared;
+        }
+        else if( item == "imu" ){
+            result.tracks |= track::imu;
+        }
+        else if( item.compare( 0, 7, "custom:" ) == 0 && item.size() > 7 ){
+            result.custom.push_back( item.substr( 7 ) );
+        }
+        else if( !item.empty() ){
+            throw k4a::error( "Failed to parse track \"" + item + "\" (color, depth, ir, imu, custom:NAME, all)!" );
+        }
+    }
+    return result;
+}
+
+// Get Description
+std::string track_playback::selection::describe() const
+{
+    std::string text;
+    const auto append = [&]( const std::string& name ){
+        text += ( text.empty() ? "" : "," ) + name;
+    };
+    if( tracks & track::color ){
+        append( "color" );
+    }
+    if( tracks & track::depth ){
+        append( "depth" );
+    }
+    if( tracks & track::infrared ){
+        append( "ir" );
+    }
+    if( tracks & track::imu ){
+        append( "imu" );
+    }
+    for( const std::string& name : custom ){
+        append( "custom:" + name );
+    }
+    return text.empty() ? "none" : text;
+}
+
+// Constructor
+track_playback::track_playback()
+    : playback( nullptr ),
+      select( 0 ),
+      read_captures( false )
+{
+}
+
+track_playback::track_playback( k4a::playback& playback, const selection& select )
+    : playback( &playback ),
+      select( select ),
+      read_captures( false )
+{
+    // Image Tracks in Recording
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    const image_track tracks[] = {
+        { track::color, "COLOR", configuration.color_format, 0, 0 },
+        { track::depth, "DEPTH", k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16, 0, 0 },
+        { track::infrared, "IR", k4a_image_format_t::K4A_IMAGE_FORMAT_IR16, 0, 0 }
+    };
+    const bool enabled[] = { configuration.color_track_enabled, configuration.depth_track_enabled, configuration.ir_track_enabled };
+
+    uint32_t recorded = 0;
+    for( int32_t i = 0; i < 3; i++ ){
+        if( !enabled[i] ){
+            continue;
+        }
+        recorded |= tracks[i].id;
+
+        if( !( select.tracks & tracks[i].id ) ){
+            continue;
+        }
+
+        // Get Size of Images
+        k4a_record_video_settings_t settings;
+        if( K4A_FAILED( k4a_playback_track_get_video_settings( playback.handle(), tracks[i].name, &settings ) ) ){
+            throw k4a::error( std::string( "Failed to get video settings of track " ) + tracks[i].name + "!" );
+        }
+        image_track target = tracks[i];
+        target.width = static_cast<int32_t>( settings.width );
+        target.height = static_cast<int32_t>( settings.height );
+        selected.push_back( target );
+    }
+
+    // All Recorded Image Tracks are Selected (whole captures are cheaper than blocks of each track)
+    read_captures = recorded && ( ( select.tracks & track::images & recorded ) == recorded );
+
+    // Check Custom Tracks
+    const std::vector<std::string> names = get_track_names( playback );
+    for( const std::string& name : select.custom ){
+        if( std::find( names.begin(), names.end(), name ) == names.end() ){
+            throw k4a::error( "Failed to found track \"" + name + "\" in recording!" );
+        }
+    }
+}
+
+// Get Next Capture with Selected Image Tracks
+bool track_playback::get_next_capture( k4a::capture* capture )
+{
+    if( read_captures ){
+        return playback->get_next_capture( capture );
+    }
+
+    if( selected.empty() ){
+        return false;
+    }
+
+    // Read Next Block of each Selected Track
+    k4a::capture result = k4a::capture::create();
+    for( const image_track& target : selected ){
+        k4a::data_block block;
+        if( !playback->get_next_data_block( target.name, &block ) ){
+            return false;
+        }
+
+        const k4a::image image = create_image( target, block );
+        switch( target.id )
+        {
+            case track::color:
+                result.set_color_image( image );
+                break;
+            case track::depth:
+                result.set_depth_image( image );
+                break;
+            default:
+                result.set_ir_image( image );
+                break;
+        }
+    }
+
+    *capture = std::move( result );
+    return true;
+}
+
+// Get Next IMU Sample
+bool track_playback::get_next_imu_sample( k4a_imu_sample_t* sample )
+{
+    if( !( select.tracks & track::imu ) ){
+        return false;
+    }
+
+    return playback->get_next_imu_sample( sample );
+}
+
+// Get Next Data Block of Custom Track
+bool track_playback::get_next_data_block( const std::string& name, k4a::data_block* block )
+{
+    if( std::find( select.custom.begin(), select.custom.end(), name ) == select.custom.end() ){
+        return false;
+    }
+
+    return playback->get_next_data_block( name.c_str(), block );
+}
+
+// Get Names of Tracks in Recording
+std::vector<std::string> track_playback::get_track_names( const k4a::playback& playback )
+{
+    std::vector<std::string> names;
+    const size_t count = k4a_playback_get_track_count( playback.handle() );
+    for( size_t i = 0; i < count; i++ ){
+        size_t size = 0;
+        if( k4a_playback_get_track_name( playback.handle(), i, nullptr, &size ) != K4A_BUFFER_RESULT_TOO_SMALL ){
+            continue;
+        }
+
+        std::vector<char> name( size );
+        if( k4a_playback_get_track_name( playback.handle(), i, name.data(), &size ) == K4A_BUFFER_RESULT_SUCCEEDED ){
+            names.push_back( name.data() );
+        }
+    }
+    return names;
+}
+
+// Create Image from Data Block
+k4a::image track_playback::create_image( const image_track& target, k4a::data_block& block )
+{
+    const std::chrono::microseconds timestamp = block.get_device_timestamp_usec();
+    k4a::image image;
+
+    if( target.format == k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16 || target.format == k4a_image_format_t::K4A_IMAGE_FORMAT_IR16 ){
+        // Convert Big Endian (b16g) to Little Endian
+        const size_t pixels = static_cast<size_t>( target.width ) * target.height;
+        if( block.get_buffer_size() != pixels * sizeof( uint16_t ) ){
+            throw k4a::error( std::string( "Failed to read block of track " ) + target.name + " (unexpected size)!" );
+        }
+
+        image = k4a::image::create( target.format, target.width, target.height, target.width * static_cast<int32_t>( sizeof( uint16_t ) ) );
+        const uint8_t* source = block.get_buffer();
+        uint16_t* destination = reinterpret_cast<uint16_t*>( image.get_buffer() );
+        for( size_t i = 0; i < pixels; i++ ){
+            destination[i] = static_cast<uint16_t>( ( source[i * 2] << 8 ) | source[i * 2 + 1] );
+        }
+    }
+    else{
+        // Color Image on Buffer of Block without Copy (image owns block)
+        const size_t size = block.get_buffer_size();
+        uint8_t* buffer = const_cast<uint8_t*>( block.get_buffer() );
+        k4a::data_block* owner = new k4a::data_block( std::move( block ) );
+        try{
+            image = k4a::image::create_from_buffer( target.format, target.width, target.height, get_stride( target.format, target.width ), buffer, size, release_block, owner );
+        }
+        catch( const k4a::error& ){
+            delete owner;
+            throw;
+        }
+    }
+
+    image.set_device_timestamp( timestamp );
+    return image;
+}
@@ -0,0 +1,102 @@
+#ifndef __TRACK_PLAYBACK__
+#define __TRACK_PLAYBACK__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+/*
+ This is playback that reads only tracks that caller declared as needed.
+
+ track_playback reader( playback, track_playback::selection::parse( "depth,ir" ) );
+ while( reader.get_next_capture( &capture ) ){ ... } // capture has depth and infrared images only
+
+ If all image tracks of recording are selected, captures are read with playback.get_next_capture() as before.
+ Otherwise each selected image track is read with playback.get_next_data_block( "DEPTH" ), so that blocks of
+ unselected tracks are not copied into images and color is not decoded (k4arecord converts DEPTH16/IR16 from
+ big endian on read, this is done here for blocks). Tracks are interleaved in clusters of Matroska, so disk reads
+ are per cluster, unselected blocks are skipped in memory.
+ Selected image tracks are assumed to have one block per capture (synchronized recording).
+ IMU and custom tracks are read with get_next_imu_sample() and get_next_data_block( name ) if selected.
+*/
+
+class track_playback
+{
+public:
+    // Track
+    enum track : uint32_t
+    {
+        color = 1,
+        depth = 2,
+        infrared = 4,
+        imu = 8,
+        images = color | depth | infrared,
+        all = images | imu
+    };
+
+    // Selection of Tracks
+    struct selection
+    {
+        uint32_t tracks;
+        std::vector<std::string> custom; // names of custom tracks
+
+        selection( const uint32_t tracks = track::all )
+            : tracks( tracks )
+        {
+        }
+
+        // Parse Selection ( "color,depth,ir,imu,custom:NAME" or "all" )
+        static selection parse( const std::string& text );
+
+        // Get Description
+        std::string describe() const;
+    };
+
+private:
+    // Image Track
+    struct image_track
+    {
+        track id;
+        const char* name;
+        k4a_image_format_t format;
+        int32_t width;
+        int32_t height;
+    };
+
+    k4a::playback* playback;
+    selection select;
+    std::vector<image_track> selected;
+    bool read_captures;
+
+public:
+    // Constructor
+    track_playback();
+    track_playback( k4a::playback& playback, const selection& select );
+
+    // Get Next Capture with Selected Image Tracks (returns false at end of any selected track)
+    bool get_next_capture( k4a::capture* capture );
+
+    // Get Next IMU Sample (returns false if IMU is not selected)
+    bool get_next_imu_sample( k4a_imu_sample_t* sample );
+
+    // Get Next Data Block of Custom Track (returns false if track is not selected)
+    bool get_next_data_block( const std::string& name, k4a::data_block* block );
+
+    // Get Names of Tracks in Recording
+    static std::vector<std::string> get_track_names( const k4a::playback& playback );
+
+    // Get Selection
+    const selection& get_selection() const { return select; }
+
+    // Captures are Read as Whole (all image tracks selected)
+    bool is_reading_captures() const { return read_captures; }
+
+private:
+    // Create Image from Data Block
+    static k4a::image create_image( const image_track& target, k4a::data_block& block );
+};
+
+#endif // __TRACK_PLAYBACK__
@@ -0,0 +1,394 @@
+#include "benchmark.hpp"
+#include "normals.hpp"
+#include "planes.hpp"
+#include "motion.hpp"
+#include "mesh.hpp"
+#include "mesh_widget.hpp"
+#include "cloud_widget.hpp"
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Compare Normals (mean angle [deg] on pixels valid in both, ratio of pixels valid in reference)
+    void compare( const cv::Mat& normals, const cv::Mat& reference, double& angle, double& coverage )
+    {
+        double sum = 0.0;
+        uint64_t count = 0;
+        uint64_t valid = 0;
+        for( int32_t y = 0; y < normals.rows; y++ ){
+            const cv::Vec3f* n = normals.ptr<cv::Vec3f>( y );
+            const cv::Vec3f* r = reference.ptr<cv::Vec3f>( y );
+            for( int32_t x = 0; x < normals.cols; x++ ){
+                if( r[x][2] == 0.0f && r[x][0] == 0.0f && r[x][1] == 0.0f ){
+                    continue;
+                }
+                valid++;
+
+                if( n[x][2] == 0.0f && n[x][0] == 0.0f && n[x][1] == 0.0f ){
+                    continue;
+                }
+
+                const double dot = std::min( 1.0, std::abs( static_cast<double>( n[x].dot( r[x] ) ) ) );
+                sum += std::acos( dot ) * 180.0 / CV_PI;
+                count++;
+            }
+        }
+
+        angle = count ? sum / count : 0.0;
+        coverage = valid ? static_cast<double>( count ) / valid : 0.0;
+    }
+}
+
+// Benchmark Normal Estimation
+void benchmark_normals( const std::string& file, const uint32_t frames )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    if( !playback.get_record_configuration().depth_track_enabled ){
+        throw k4a::error( "Failed to benchmark (recording has no depth track)!" );
+    }
+
+    // Create Transformation
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+
+    normal_estimator estimator;
+    cv::Mat normals, reference;
+    double window_time = 0.0;
+    double knn_time = 0.0;
+    double angle = 0.0;
+    double coverage = 0.0;
+    uint32_t count = 0;
+    cv::Size size;
+
+    k4a::capture capture;
+    while( count < frames && playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        // Transform Depth Image to Color-Registered Point Cloud
+        const k4a::image transformed_depth_image = transformation.depth_image_to_color_camera( depth_image );
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( transformed_depth_image, K4A_CALIBRATION_TYPE_COLOR );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+        size = xyz.size();
+
+        // Sliding Window Estimator
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        estimator.compute( xyz, normals );
+        window_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Naive kNN Estimator (first frame only)
+        if( !count ){
+            start = std::chrono::steady_clock::now();
+            normal_estimator::compute_knn( xyz, reference );
+            knn_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+            compare( normals, reference, angle, coverage );
+        }
+
+        count++;
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( !count ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Report
+    std::cout << "cloud    : " << size.width << "x" << size.height << ", " << count << " frames" << std::endl;
+    std::cout << "window   : " << window_time / count << " ms/frame" << std::endl;
+    std::cout << "knn      : " << knn_time << " ms/frame (first frame)" << std::endl;
+    std::cout << "compare  : " << angle << " deg mean difference, " << 100.0 * coverage << " % of knn normals covered" << std::endl;
+}
+
+// Benchmark Plane Segmentation
+void benchmark_planes( const std::string& file )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    if( !configuration.depth_track_enabled || !configuration.imu_track_enabled ){
+        throw k4a::error( "Failed to benchmark (recording has no depth or imu track)!" );
+    }
+
+    // Create Transformation, Motion Compensator (for up direction) and Plane Segmentation
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+    motion_compensator compensator( calibration, K4A_CALIBRATION_TYPE_COLOR );
+    plane_segmentation segmentation;
+
+    // Read Captures and IMU Samples in Order of Device Timestamp
+    std::vector<imu::sample> batch;
+    imu::sample pending;
+    bool has_pending = playback.get_next_imu_sample( &pending );
+
+    uint64_t frames = 0;
+    uint64_t floors = 0;
+    uint64_t planes = 0;
+    uint64_t refined = 0;
+    double segment_time = 0.0;
+    double max_segment_time = 0.0;
+    double gravity_angle = 0.0;
+    double rms = 0.0;
+    double jitter_angle = 0.0;
+    double jitter_height = 0.0;
+    uint64_t jitter_count = 0;
+    bool has_last_floor = false;
+    plane_segmentation::plane last_floor;
+
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        // Up Direction from IMU Samples up to Depth Timestamp
+        batch.clear();
+        const uint64_t timestamp = static_cast<uint64_t>( depth_image.get_device_timestamp().count() );
+        while( has_pending && pending.acc_timestamp_usec <= timestamp ){
+            batch.push_back( pending );
+            has_pending = playback.get_next_imu_sample( &pending );
+        }
+        compensator.update( batch );
+
+        // Transform Depth Image to Color-Registered Point Cloud
+        const k4a::image transformed_depth_image = transformation.depth_image_to_color_camera( depth_image );
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( transformed_depth_image, K4A_CALIBRATION_TYPE_COLOR );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+
+        // Segment Planes
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::vector<plane_segmentation::plane>& result = segmentation.segment( xyz );
+        const int32_t floor = segmentation.find_floor( compensator.get_up() );
+        const double time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        segment_time += time;
+        max_segment_time = std::max( max_segment_time, time );
+        planes += result.size();
+        for( const plane_segmentation::plane& plane : result ){
+            refined += plane.refined ? 1 : 0;
+        }
+        frames++;
+
+        if( floor < 0 ){
+            has_last_floor = false;
+            continue;
+        }
+
+        // Accuracy of Floor (against accelerometer, flatness, and stability between frames)
+        const plane_segmentation::plane& current = result[floor];
+        gravity_angle += std::acos( std::min( 1.0f, current.normal.dot( compensator.get_up() ) ) ) * 180.0 / CV_PI;
+        rms += current.rms;
+        if( has_last_floor ){
+            jitter_angle += std::acos( std::min( 1.0f, current.normal.dot( last_floor.normal ) ) ) * 180.0 / CV_PI;
+            jitter_height += std::abs( current.distance - last_floor.distance );
+            jitter_count++;
+        }
+        last_floor = current;
+        has_last_floor = true;
+        floors++;
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( !frames ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Report
+    std::cout << "frames  : " << frames << ", " << static_cast<double>( planes ) / frames << " planes/frame"
+              << " (" << ( planes ? 100.0 * refined / planes : 0.0 ) << " % refined from previous frame)" << std::endl;
+    std::cout << "segment : " << segment_time / frames << " ms/frame (max " << max_segment_time << " ms)" << std::endl;
+    std::cout << "floor   : found in " << 100.0 * floors / frames << " % of frames" << std::endl;
+    if( floors ){
+        std::cout << "accuracy: " << gravity_angle / floors << " deg from accelerometer up, " << rms / floors << " mm rms" << std::endl;
+    }
+    if( jitter_count ){
+        std::cout << "jitter  : " << jitter_angle / jitter_count << " deg, " << jitter_height / jitter_count << " mm between frames" << std::endl;
+    }
+}
+
+// Benchmark Mesh Generation
+void benchmark_mesh( const std::string& file, const std::string& output )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    if( !playback.get_record_configuration().depth_track_enabled ){
+        throw k4a::error( "Failed to benchmark (recording has no depth track)!" );
+    }
+
+    // Create Transformation
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+
+    organized_mesh mesher;
+    double build_time = 0.0;
+    uint64_t triangles = 0;
+    uint64_t changed_tiles = 0;
+    uint32_t count = 0;
+
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        // Transform Depth Image to Point Cloud (depth camera, no color)
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+
+        // Triangulate
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        mesher.build( xyz );
+        build_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        triangles += mesher.get_triangles();
+        changed_tiles += mesher.get_changed_tiles();
+        count++;
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( !count ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Export Last Mesh
+    mesher.save_ply( output + ".ply" );
+    mesher.save_obj( output + ".obj" );
+
+    // Report
+    std::cout << "mesh      : " << count << " frames, " << triangles / count << " triangles/frame" << std::endl;
+    std::cout << "build     : " << build_time / count << " ms/frame" << std::endl;
+    std::cout << "tiles     : " << 100.0 * changed_tiles / ( static_cast<double>( count ) * mesher.get_tiles() ) << " % rebuilt" << std::endl;
+    std::cout << "export    : " << output << ".ply, " << output << ".obj" << std::endl;
+}
+
+// Benchmark Point Cloud Viewer
+void benchmark_viewer( const std::string& file, const uint32_t frames )
+{
+    #ifdef HAVE_OPENCV_VIZ
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    if( !playback.get_record_configuration().depth_track_enabled ){
+        throw k4a::error( "Failed to benchmark (recording has no depth track)!" );
+    }
+
+    // Create Transformation
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+
+    // Load Point Clouds (decoding is excluded from frame time)
+    std::vector<cv::Mat> clouds;
+    k4a::capture capture;
+    while( clouds.size() < frames && playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+        clouds.push_back( xyz.clone() );
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( clouds.empty() ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Create Offscreen Viewer (no display needed, screenshot forces render)
+    cv::viz::Viz3d viewer( "offscreen" );
+    viewer.setOffScreenRendering();
+    viewer.setWindowSize( cv::Size( 1280, 720 ) );
+
+    // New WCloud per Frame
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( const cv::Mat& xyz : clouds ){
+        cv::Mat cloud;
+        xyz.convertTo( cloud, CV_32FC3 );
+        viewer.showWidget( "cloud", cv::viz::WCloud( cloud, cv::viz::Color::white() ) );
+        viewer.getScreenshot();
+    }
+    const double recreate_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    viewer.removeAllWidgets();
+
+    // Persistent Widget Updated in Place
+    cloud_widget cloud_view;
+    bool shown = false;
+    start = std::chrono::steady_clock::now();
+    for( const cv::Mat& xyz : clouds ){
+        cloud_view.write( xyz );
+        cloud_view.upload();
+        if( cloud_view.get_uploads() && ( !shown || !cloud_view.is_persistent() ) ){
+            viewer.showWidget( "cloud", cloud_view.get_widget() );
+            shown = true;
+        }
+        viewer.getScreenshot();
+    }
+    const double persistent_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    viewer.removeAllWidgets();
+
+    // New WMesh per Frame (mesh is built in both loops, so difference is upload)
+    organized_mesh mesher;
+    start = std::chrono::steady_clock::now();
+    for( const cv::Mat& xyz : clouds ){
+        mesher.build( xyz );
+        if( mesher.get_triangles() ){
+            viewer.showWidget( "mesh", cv::viz::WMesh( mesher.get_viz_mesh() ) );
+        }
+        viewer.getScreenshot();
+    }
+    const double recreate_mesh_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    viewer.removeAllWidgets();
+
+    // Persistent Mesh Widget Updated in Place (triangles only when tiles changed)
+    organized_mesh persistent_mesher;
+    mesh_widget mesh_view;
+    shown = false;
+    start = std::chrono::steady_clock::now();
+    for( const cv::Mat& xyz : clouds ){
+        persistent_mesher.build( xyz );
+        mesh_view.upload( persistent_mesher );
+        if( mesh_view.get_uploads() && ( !shown || !mesh_view.is_persistent() ) ){
+            viewer.showWidget( "mesh", mesh_view.get_widget() );
+            shown = true;
+        }
+        viewer.getScreenshot();
+    }
+    const double persistent_mesh_time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+    // Report
+    const size_t count = clouds.size();
+    std::cout << "cloud      : " << clouds.front().cols << "x" << clouds.front().rows << ", " << count << " frames" << std::endl;
+    std::cout << "recreate   : " << recreate_time / count << " ms/frame (" << clouds.front().total() * sizeof( cv::Vec3f ) / 1024 << " KB/frame)" << std::endl;
+    std::cout << "persistent : " << persistent_time / count << " ms/frame (" << cloud_view.get_uploaded_bytes() / cloud_view.get_uploads() / 1024 << " KB/frame"
+              << ( cloud_view.is_persistent() ? ")" : ", recreated without VTK)" ) << std::endl;
+    std::cout << "mesh       : " << recreate_mesh_time / count << " ms/frame (new WMesh)" << std::endl;
+    std::cout << "persistent : " << persistent_mesh_time / count << " ms/frame (" << mesh_view.get_uploaded_bytes() / std::max<uint64_t>( 1, mesh_view.get_uploads() ) / 1024 << " KB/frame, "
+              << 100.0 * mesh_view.get_cell_uploads() / std::max<uint64_t>( 1, mesh_view.get_uploads() ) << " % with triangles"
+              << ( mesh_view.is_persistent() ? ")" : ", recreated without VTK)" ) << std::endl;
+    #else
+    std::cout << "viewer benchmark needs opencv_viz (" << file << ", " << frames << " frames)" << std::endl;
+    #endif
+}
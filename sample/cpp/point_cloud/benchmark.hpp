@@ -0,0 +1,23 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+#include <string>
+
+// Benchmark Normal Estimation on Color-Registered Point Clouds of Recorded Depth Track
+// Sliding window estimator runs on every frame, naive kNN estimator runs on first frame for comparison.
+void benchmark_normals( const std::string& file, const uint32_t frames = 30 );
+
+// Benchmark Plane Segmentation on Color-Registered Point Clouds of Recorded Depth and IMU Tracks
+// Floor normal is compared with up direction measured by accelerometer, and between successive frames.
+void benchmark_planes( const std::string& file );
+
+// Benchmark Mesh Generation on Point Clouds of Recorded Depth Track (depth camera)
+// Reports triangulation time and ratio of tiles whose indices are rebuilt, last mesh is exported as <output>.ply and <output>.obj.
+void benchmark_mesh( const std::string& file, const std::string& output = "mesh" );
+
+// Benchmark Point Cloud Viewer with Headless (Offscreen) Rendering on Recorded Depth Track (depth camera)
+// Frame time of new cv::viz::WCloud (cv::viz::WMesh) per frame is compared with persistent cloud (mesh) widget updated in place.
+void benchmark_viewer( const std::string& file, const uint32_t frames = 100 );
+
+#endif // __BENCHMARK__
@@ -0,0 +1,152 @@
+#include "cloud_widget.hpp"
+
+#if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+#include <opencv2/viz/widget_accessor.hpp>
+#include <vtkActor.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyDataMapper.h>
+#endif
+
+// Constructor
+cloud_widget::cloud_widget()
+    : front( 0 ),
+      uploads( 0 ),
+      uploaded_bytes( 0 )
+{
+    counts[0] = counts[1] = 0;
+
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // Point and Color Arrays (reference front buffer, see upload())
+    point_array = vtkSmartPointer<vtkFloatArray>::New();
+    point_array->SetNumberOfComponents( 3 );
+    color_array = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    color_array->SetNumberOfComponents( 3 );
+    color_array->SetName( "Colors" );
+
+    vtkSmartPointer<vtkPoints> vtk_points = vtkSmartPointer<vtkPoints>::New();
+    vtk_points->SetData( point_array );
+
+    // One Poly Vertex Cell over all Points
+    cell_array = vtkSmartPointer<vtkIdTypeArray>::New();
+    cells = vtkSmartPointer<vtkCellArray>::New();
+
+    polydata = vtkSmartPointer<vtkPolyData>::New();
+    polydata->SetPoints( vtk_points );
+    polydata->SetVerts( cells );
+    polydata->GetPointData()->SetScalars( color_array );
+
+    // Mapper and Actor
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputData( polydata );
+    mapper->SetScalarModeToUsePointData();
+    mapper->ScalarVisibilityOn();
+
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper( mapper );
+
+    // Wrap Actor as Viz Widget
+    cv::viz::WidgetAccessor::setProp( widget, actor );
+    #endif
+}
+
+// Write Valid Points into Back Buffer
+void cloud_widget::write( const cv::Mat& xyz, const cv::Mat& color )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+    CV_Assert( color.empty() || ( color.size() == xyz.size() && ( color.type() == CV_8UC3 || color.type() == CV_8UC4 ) ) );
+
+    const int32_t back = 1 - front;
+    std::vector<float>& point_buffer = points[back];
+    std::vector<uint8_t>& color_buffer = colors[back];
+
+    // Grow Buffers to Organized Size (no reallocation after first frame)
+    const size_t capacity = xyz.total();
+    if( point_buffer.size() < capacity * 3 ){
+        point_buffer.resize( capacity * 3 );
+        color_buffer.resize( capacity * 3 );
+    }
+
+    // Compact Valid Points ( BGR(A) -> RGB )
+    const int32_t channels = color.empty() ? 0 : color.channels();
+    float* p = point_buffer.data();
+    uint8_t* c = color_buffer.data();
+    size_t count = 0;
+    for( int32_t y = 0; y < xyz.rows; y++ ){
+        const cv::Vec3s* row = xyz.ptr<cv::Vec3s>( y );
+        const uint8_t* pixels = channels ? color.ptr<uint8_t>( y ) : nullptr;
+        for( int32_t x = 0; x < xyz.cols; x++ ){
+            if( row[x][2] <= 0 ){
+                continue;
+            }
+
+            p[count * 3 + 0] = row[x][0];
+            p[count * 3 + 1] = row[x][1];
+            p[count * 3 + 2] = row[x][2];
+            if( pixels ){
+                const uint8_t* pixel = pixels + x * channels;
+                c[count * 3 + 0] = pixel[2];
+                c[count * 3 + 1] = pixel[1];
+                c[count * 3 + 2] = pixel[0];
+            }
+            else{
+                c[count * 3 + 0] = c[count * 3 + 1] = c[count * 3 + 2] = 255;
+            }
+            count++;
+        }
+    }
+    counts[back] = count;
+}
+
+// Swap Buffers and Update Widget
+void cloud_widget::upload()
+{
+    // Swap Buffers (back buffer becomes visible)
+    front = 1 - front;
+    const size_t count = counts[front];
+
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // Point and Color Arrays reference Front Buffer (save = 1, VTK does not free buffer)
+    point_array->SetArray( points[front].data(), static_cast<vtkIdType>( count * 3 ), 1 );
+    color_array->SetArray( colors[front].data(), static_cast<vtkIdType>( count * 3 ), 1 );
+    point_array->Modified();
+    color_array->Modified();
+    polydata->GetPoints()->Modified();
+
+    // Poly Vertex Cell (identity ids are filled only when grown)
+    if( ids.size() < count + 1 ){
+        const size_t filled = ids.empty() ? 0 : ids.size() - 1;
+        ids.resize( count + 1 );
+        for( size_t i = filled; i < count; i++ ){
+            ids[i + 1] = static_cast<vtkIdType>( i );
+        }
+    }
+    ids[0] = static_cast<vtkIdType>( count );
+    cell_array->SetArray( ids.data(), static_cast<vtkIdType>( count + 1 ), 1 );
+    cells->SetCells( count ? 1 : 0, cell_array );
+    polydata->Modified();
+    #elif defined( HAVE_OPENCV_VIZ )
+    // Fallback (new widget of valid points)
+    if( !count ){
+        return;
+    }
+    const cv::Mat cloud( 1, static_cast<int32_t>( count ), CV_32FC3, points[front].data() );
+    const cv::Mat color( 1, static_cast<int32_t>( count ), CV_8UC3, colors[front].data() );
+    cv::Mat bgr;
+    cv::cvtColor( color, bgr, cv::COLOR_RGB2BGR );
+    widget = cv::viz::WCloud( cloud, bgr );
+    #endif
+
+    uploads++;
+    uploaded_bytes += count * ( sizeof( float ) * 3 + sizeof( uint8_t ) * 3 );
+}
+
+// Check Widget is Updated in Place
+bool cloud_widget::is_persistent() const
+{
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    return true;
+    #else
+    return false;
+    #endif
+}
@@ -0,0 +1,90 @@
+#ifndef __CLOUD_WIDGET__
+#define __CLOUD_WIDGET__
+
+#include <opencv2/opencv.hpp>
+#ifdef HAVE_OPENCV_VIZ
+#include <opencv2/viz.hpp>
+#endif
+#if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkFloatArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkCellArray.h>
+#endif
+
+#include <vector>
+
+/*
+ This is persistent point cloud widget whose buffers are updated in place every frame.
+
+ cloud_widget cloud;
+ cloud.write( xyz, color );                  // draw: compact valid points into back buffer (CV_16SC3, CV_8UC4/CV_8UC3 or empty)
+ cloud.upload();                             // show: swap buffers and mark VTK arrays modified
+ if( cloud.is_persistent() ){ ... }          // widget needs to be shown only once
+ viewer.showWidget( "cloud", cloud.get_widget() );
+
+ cv::viz::WCloud copies whole organized cloud (including invalid points) into new VTK polydata every frame.
+ With VTK available (HAVE_VTK), this widget owns one vtkPolyData whose point and color arrays reference front buffer
+ of double buffer directly, so that only valid points are uploaded and nothing is reallocated after warm-up.
+ Back buffer is written while VTK still references front buffer, swap happens on upload() just before render.
+ Without VTK, upload() falls back to new cv::viz::WCloud of valid points.
+*/
+
+class cloud_widget
+{
+private:
+    // Double Buffer ( x, y, z [mm] and r, g, b of valid points )
+    std::vector<float> points[2];
+    std::vector<uint8_t> colors[2];
+    size_t counts[2];
+    int32_t front;
+
+    // Statistics
+    uint64_t uploads;
+    uint64_t uploaded_bytes;
+
+    #ifdef HAVE_OPENCV_VIZ
+    cv::viz::Widget3D widget;
+    #endif
+
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // VTK Objects (created once)
+    vtkSmartPointer<vtkPolyData> polydata;
+    vtkSmartPointer<vtkFloatArray> point_array;
+    vtkSmartPointer<vtkUnsignedCharArray> color_array;
+    vtkSmartPointer<vtkCellArray> cells;
+    vtkSmartPointer<vtkIdTypeArray> cell_array;
+    std::vector<vtkIdType> ids; // [ n, 0, 1, ..., n - 1 ] (one poly vertex cell)
+    #endif
+
+public:
+    // Constructor
+    cloud_widget();
+
+    // Write Valid Points into Back Buffer
+    void write( const cv::Mat& xyz, const cv::Mat& color = cv::Mat() );
+
+    // Swap Buffers and Update Widget
+    void upload();
+
+    // Check Widget is Updated in Place (needs to be shown only once)
+    bool is_persistent() const;
+
+    #ifdef HAVE_OPENCV_VIZ
+    // Get Widget
+    const cv::viz::Widget3D& get_widget() const { return widget; }
+    #endif
+
+    // Get Number of Points in Front Buffer
+    size_t get_points() const { return counts[front]; }
+
+    // Get Number of Uploads
+    uint64_t get_uploads() const { return uploads; }
+
+    // Get Total Uploaded Bytes
+    uint64_t get_uploaded_bytes() const { return uploaded_bytes; }
+};
+
+#endif // __CLOUD_WIDGET__
@@ -1,11 +1,31 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
 kinect::kinect( const uint32_t index )
-    : device_index( index )
+    : device_index( index ),
+      compensate( false ),
+      compensated_frames( 0 ),
+      compensate_time( 0.0 ),
+      estimate_normals( false ),
+      normal_frames( 0 ),
+      normal_time( 0.0 ),
+      segment_planes( false ),
+      plane_frames( 0 ),
+      plane_time( 0.0 ),
+      build_mesh( false ),
+      mesh_frames( 0 ),
+      mesh_time( 0.0 ),
+      mesh_changed_tiles( 0 ),
+      track_odometry( false ),
+      track_time( 0.0 ),
+      cloud_shown( false ),
+      mesh_shown( false ),
+      sensor_shown( false )
 {
     // Initialize
     initialize();
@@ -23,6 +43,9 @@ void kinect::initialize()
     // Initialize Sensor
     initialize_sensor();
 
+    // Initialize Motion Compensation
+    initialize_motion();
+
     // Initialize Viewer
     initialize_viewer();
 }
@@ -48,6 +71,9 @@ inline void kinect::initialize_sensor()
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
 
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
     // Get Calibration
     calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
 
@@ -55,6 +81,22 @@ inline void kinect::initialize_sensor()
     transformation = k4a::transformation( calibration );
 }
 
+// Initialize Motion Compensation
+inline void kinect::initialize_motion()
+{
+    // Start IMU and Reader Thread
+    imu_reader.reset( new imu::reader( &device ) );
+
+    // Create Motion Compensator for Color-Registered Point Cloud
+    compensator.reset( new motion_compensator( calibration, K4A_CALIBRATION_TYPE_COLOR ) );
+
+    // Reserve Batch (~1.6 kHz / 30 fps, with headroom for late frames)
+    imu_batch.reserve( 256 );
+
+    // Create ICP Odometry for Depth Camera
+    tracker.reset( new odometry( calibration.depth_camera_calibration ) );
+}
+
 // Initialize Viewer
 inline void kinect::initialize_viewer()
 {
@@ -72,6 +114,53 @@ inline void kinect::initialize_viewer()
 // Finalize
 void kinect::finalize()
 {
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Report Motion Compensation Time
+    if( compensated_frames ){
+        std::cout << "motion compensation : " << compensated_frames << " frames, " << compensate_time / compensated_frames << " ms/frame" << std::endl;
+    }
+
+    // Report Normal Estimation Time
+    if( normal_frames ){
+        std::cout << "normals : " << normal_frames << " frames, " << normal_time / normal_frames << " ms/frame" << std::endl;
+    }
+
+    // Report Plane Segmentation Time
+    if( plane_frames ){
+        std::cout << "planes : " << plane_frames << " frames, " << plane_time / plane_frames << " ms/frame" << std::endl;
+    }
+
+    // Report Mesh Time and Rebuilt Tiles (indices of unchanged tiles are reused)
+    if( mesh_frames ){
+        std::cout << "mesh : " << mesh_frames << " frames, " << mesh_time / mesh_frames << " ms/frame, "
+                  << 100.0 * mesh_changed_tiles / ( static_cast<double>( mesh_frames ) * mesher.get_tiles() ) << " % tiles rebuilt" << std::endl;
+    }
+
+    // Report Viewer Upload Size (valid points only)
+    if( cloud_view.get_uploads() ){
+        std::cout << "viewer : " << cloud_view.get_uploads() << " uploads, " << cloud_view.get_uploaded_bytes() / cloud_view.get_uploads() / 1024 << " KB/upload"
+                  << ( cloud_view.is_persistent() ? " (persistent widget)" : " (recreated widget)" ) << std::endl;
+    }
+
+    // Report Mesh Viewer Upload Size (triangles only when tiles changed)
+    if( mesh_view.get_uploads() ){
+        std::cout << "mesh viewer : " << mesh_view.get_uploads() << " uploads, " << mesh_view.get_uploaded_bytes() / mesh_view.get_uploads() / 1024 << " KB/upload, "
+                  << 100.0 * mesh_view.get_cell_uploads() / mesh_view.get_uploads() << " % with triangles"
+                  << ( mesh_view.is_persistent() ? " (persistent widget)" : " (recreated widget)" ) << std::endl;
+    }
+
+    // Report Odometry
+    if( tracker && tracker->get_frames() ){
+        std::cout << "odometry : " << tracker->get_frames() << " frames (" << tracker->get_lost_frames() << " lost), "
+                  << track_time / tracker->get_frames() << " ms/frame" << std::endl;
+    }
+
+    // Stop IMU Reader
+    imu_reader.reset();
+
     // Destroy Transformation
     transformation.destroy();
 
@@ -94,23 +183,71 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
 
-        // Draw
-        draw();
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
         if( key == 'q' ){
             break;
         }
 
+        // Toggle Motion Compensation, Rolling Shutter Correction, and Reset Reference Frame
+        if( key == 'm' ){
+            // Reference Frame is Current Pose when Compensation is Turned On
+            compensate = !compensate;
+            if( compensate ){
+                compensator->reset();
+            }
+        }
+        if( key == 'n' ){
+            estimate_normals = !estimate_normals;
+        }
+        if( key == 'p' ){
+            segment_planes = !segment_planes;
+        }
+        if( key == 'w' ){
+            build_mesh = !build_mesh;
+        }
+        if( key == 'e' && mesher.get_triangles() ){
+            mesher.save_ply( "mesh.ply" );
+            mesher.save_obj( "mesh.obj" );
+        }
+        if( key == 'o' ){
+            // Odometry Starts from Current Frame when Turned On
+            track_odometry = !track_odometry;
+            if( track_odometry ){
+                tracker->reset();
+            }
+        }
+        if( key == 's' ){
+            compensator->set_rolling_shutter( !compensator->is_rolling_shutter() );
+        }
+        if( key == 'r' ){
+            compensator->reset();
+            tracker->reset();
+        }
+
         #ifdef HAVE_OPENCV_VIZ
         if( viewer.wasStopped() ){
             break;
@@ -120,10 +257,12 @@ void kinect::run()
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Update Color
     update_color();
@@ -137,19 +276,24 @@ void kinect::update()
     // Update Point Cloud
     update_point_cloud();
 
+    // Update Motion
+    update_motion();
+
+    // Update Odometry
+    update_odometry();
+
     // Release Capture Handle
     capture.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
-    }
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
 }
 
 // Update Color
@@ -188,6 +332,34 @@ inline void kinect::update_point_cloud()
     xyz_image = transformation.depth_image_to_point_cloud( transformed_depth_image, K4A_CALIBRATION_TYPE_COLOR );
 }
 
+// Update Motion
+inline void kinect::update_motion()
+{
+    // Read IMU Samples up to Timestamp of Capture
+    imu_batch.clear();
+    imu_reader->read_until( scheduler::get_device_timestamp( capture ), imu_batch );
+
+    // Update Pose (kept up to date while compensation is off)
+    compensator->update( imu_batch );
+}
+
+// Update Odometry
+inline void kinect::update_odometry()
+{
+    if( !track_odometry || !depth_image.handle() ){
+        return;
+    }
+
+    // Transform Depth Image to Point Cloud of Depth Camera (organized, for projective data association)
+    const k4a::image depth_xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+    const cv::Mat depth_xyz( depth_xyz_image.get_height_pixels(), depth_xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( depth_xyz_image.get_buffer() ), depth_xyz_image.get_stride_bytes() );
+
+    // Track Frame
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    tracker->track( depth_xyz );
+    track_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
 // Draw
 void kinect::draw()
 {
@@ -202,6 +374,21 @@ void kinect::draw()
 
     // Draw Point Cloud
     draw_point_cloud();
+
+    // Draw Normals
+    draw_normals();
+
+    // Draw Planes
+    draw_planes();
+
+    // Draw Motion Compensation
+    draw_motion();
+
+    // Draw Mesh
+    draw_mesh();
+
+    // Draw Viewer Cloud
+    draw_viewer();
 }
 
 // Draw Color
@@ -250,13 +437,110 @@ inline void kinect::draw_point_cloud()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    xyz = k4a::get_mat( xyz_image );
+    // Copy Point Cloud as CV_16SC3 [mm] (k4a::get_mat converts to CV_32FC3 for cv::viz::WCloud)
+    const cv::Mat raw( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+    raw.copyTo( xyz );
 
     // Release Point Cloud Image Handle
     xyz_image.reset();
 }
 
+// Draw Normals
+inline void kinect::draw_normals()
+{
+    if( !estimate_normals || xyz.empty() ){
+        return;
+    }
+
+    // Estimate Normals on Organized Point Cloud (camera frame)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    estimator.compute( xyz, normals );
+    normal_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    normal_frames++;
+}
+
+// Draw Planes
+inline void kinect::draw_planes()
+{
+    if( !segment_planes || xyz.empty() || color.empty() ){
+        return;
+    }
+
+    // Segment Planes and Find Floor with Up Direction from Accelerometer (camera frame)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const std::vector<plane_segmentation::plane>& planes = segmentation.segment( xyz );
+    const int32_t floor = segmentation.find_floor( compensator->get_up() );
+    plane_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    plane_frames++;
+
+    if( floor < 0 ){
+        return;
+    }
+
+    // Paint Floor on Color Image (point cloud is registered to color camera, so pixels correspond)
+    const plane_segmentation::plane& plane = planes[floor];
+    const float threshold = segmentation.get_parameters().threshold;
+    for( int32_t y = 0; y < xyz.rows; y++ ){
+        const cv::Vec3s* points = xyz.ptr<cv::Vec3s>( y );
+        cv::Vec4b* pixels = color.ptr<cv::Vec4b>( y );
+        for( int32_t x = 0; x < xyz.cols; x++ ){
+            if( points[x][2] <= 0 ){
+                continue;
+            }
+            const float distance = plane.normal[0] * points[x][0] + plane.normal[1] * points[x][1] + plane.normal[2] * points[x][2] + plane.distance;
+            if( std::abs( distance ) < threshold ){
+                pixels[x][1] = static_cast<uint8_t>( ( pixels[x][1] + 255 ) / 2 );
+            }
+        }
+    }
+
+    // Draw Height of Camera above Floor
+    cv::putText( color, cv::format( "floor %.0f mm (%d planes)", plane.distance, static_cast<int32_t>( planes.size() ) ), cv::Point( 20, 40 ), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar( 0, 255, 0, 255 ), 2 );
+}
+
+// Draw Motion Compensation
+inline void kinect::draw_motion()
+{
+    if( !compensate || xyz.empty() ){
+        return;
+    }
+
+    // Rotate Point Cloud into Reference Frame
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    compensator->apply( xyz, compensated_xyz );
+    compensate_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    compensated_frames++;
+
+    // Swap Compensated Point Cloud (previous buffer is reused next frame)
+    cv::swap( xyz, compensated_xyz );
+}
+
+// Draw Mesh
+inline void kinect::draw_mesh()
+{
+    if( !build_mesh || xyz.empty() || color.empty() ){
+        return;
+    }
+
+    // Triangulate Organized Point Cloud (after motion compensation, so mesh is in reference frame)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    mesher.build( xyz, color );
+    mesh_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    mesh_changed_tiles += mesher.get_changed_tiles();
+    mesh_frames++;
+}
+
+// Draw Viewer Cloud
+inline void kinect::draw_viewer()
+{
+    if( xyz.empty() || color.empty() ){
+        return;
+    }
+
+    // Write Valid Points into Back Buffer of Viewer (uploaded when UI is refreshed)
+    cloud_view.write( xyz, color );
+}
+
 // Show
 void kinect::show()
 {
@@ -268,6 +552,9 @@ void kinect::show()
 
     // Show Point Cloud
     show_point_cloud();
+
+    // Show Normals
+    show_normals();
 }
 
 // Show Color
@@ -297,6 +584,22 @@ inline void kinect::show_transformation()
     cv::imshow( window_name, transformed_depth );
 }
 
+// Show Normals
+inline void kinect::show_normals()
+{
+    if( !estimate_normals || normals.empty() ){
+        return;
+    }
+
+    // Map Normal [-1, 1] to Color [0, 255]
+    cv::Mat normal_map;
+    normals.convertTo( normal_map, CV_8U, 127.5, 127.5 );
+
+    // Show Image
+    const cv::String window_name = cv::format( "normal (kinect %d)", device_index );
+    cv::imshow( window_name, normal_map );
+}
+
 // Show Point Cloud
 inline void kinect::show_point_cloud()
 {
@@ -305,11 +608,39 @@ inline void kinect::show_point_cloud()
     }
 
     #ifdef HAVE_OPENCV_VIZ
-    // Create Point Cloud Widget
-    cv::viz::WCloud cloud = cv::viz::WCloud( xyz, color );
+    if( build_mesh && mesher.get_triangles() ){
+        // Update Mesh Widget (arrays of persistent widget are updated in place, triangles only when tiles changed)
+        mesh_view.upload( mesher );
+
+        // Show Widget (replaces point cloud, only once if persistent)
+        if( !mesh_shown || !mesh_view.is_persistent() ){
+            viewer.showWidget( "cloud", mesh_view.get_widget() );
+            mesh_shown = true;
+        }
+        cloud_shown = false;
+    }
+    else{
+        // Update Point Cloud Widget (swap buffers, arrays of persistent widget are updated in place)
+        cloud_view.upload();
+
+        // Show Widget (only once if persistent)
+        if( cloud_view.get_uploads() && ( !cloud_shown || !cloud_view.is_persistent() ) ){
+            viewer.showWidget( "cloud", cloud_view.get_widget() );
+            cloud_shown = true;
+            mesh_shown = false;
+        }
+    }
 
-    // Show Widget
-    viewer.showWidget( "cloud", cloud );
+    // Show Sensor at Pose Estimated by Odometry
+    if( track_odometry ){
+        constexpr double scale = 100.0;
+        viewer.showWidget( "sensor", cv::viz::WCameraPosition( scale ), tracker->get_pose() );
+        sensor_shown = true;
+    }
+    else if( sensor_shown ){
+        viewer.removeWidget( "sensor" );
+        sensor_shown = false;
+    }
     viewer.spinOnce();
     #endif
 }
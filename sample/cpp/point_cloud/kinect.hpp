@@ -7,6 +7,20 @@
 #include <opencv2/viz.hpp>
 #endif
 
+#include <memory>
+#include <vector>
+
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "imu.hpp"
+#include "motion.hpp"
+#include "odometry.hpp"
+#include "normals.hpp"
+#include "planes.hpp"
+#include "mesh.hpp"
+#include "cloud_widget.hpp"
+#include "mesh_widget.hpp"
+
 class kinect
 {
 private:
@@ -17,6 +31,8 @@ private:
     k4a::transformation transformation;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
 
     // Color
     k4a::image color_image;
@@ -33,10 +49,49 @@ private:
     k4a::image xyz_image;
     cv::Mat xyz;
 
+    // Motion Compensation
+    std::unique_ptr<imu::reader> imu_reader;
+    std::unique_ptr<motion_compensator> compensator;
+    std::vector<imu::sample> imu_batch;
+    cv::Mat compensated_xyz;
+    bool compensate;
+    uint64_t compensated_frames;
+    double compensate_time;
+
+    // Normals
+    normal_estimator estimator;
+    cv::Mat normals;
+    bool estimate_normals;
+    uint64_t normal_frames;
+    double normal_time;
+
+    // Planes
+    plane_segmentation segmentation;
+    bool segment_planes;
+    uint64_t plane_frames;
+    double plane_time;
+
+    // Mesh
+    organized_mesh mesher;
+    bool build_mesh;
+    uint64_t mesh_frames;
+    double mesh_time;
+    uint64_t mesh_changed_tiles;
+
+    // Odometry
+    std::unique_ptr<odometry> tracker;
+    bool track_odometry;
+    double track_time;
+
     // Viewer
     #ifdef HAVE_OPENCV_VIZ
     cv::viz::Viz3d viewer;
     #endif
+    cloud_widget cloud_view;
+    mesh_widget mesh_view;
+    bool cloud_shown;
+    bool mesh_shown;
+    bool sensor_shown;
 
 public:
     // Constructor
@@ -49,7 +104,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -64,6 +119,9 @@ private:
     // Initialize Sensor
     void initialize_sensor();
 
+    // Initialize Motion Compensation
+    void initialize_motion();
+
     // Initialize Viewer
     void initialize_viewer();
 
@@ -71,7 +129,7 @@ private:
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Color
     void update_color();
@@ -85,6 +143,12 @@ private:
     // Update Point Cloud
     void update_point_cloud();
 
+    // Update Motion
+    void update_motion();
+
+    // Update Odometry
+    void update_odometry();
+
     // Draw Color
     void draw_color();
 
@@ -97,6 +161,21 @@ private:
     // Draw Point Cloud
     void draw_point_cloud();
 
+    // Draw Normals
+    void draw_normals();
+
+    // Draw Planes
+    void draw_planes();
+
+    // Draw Motion Compensation
+    void draw_motion();
+
+    // Draw Mesh
+    void draw_mesh();
+
+    // Draw Viewer Cloud
+    void draw_viewer();
+
     // Show Color
     void show_color();
 
@@ -105,6 +184,9 @@ private:
 
     // Show Point Cloud
     void show_point_cloud();
+
+    // Show Normals
+    void show_normals();
 };
 
 #endif // __KINECT__
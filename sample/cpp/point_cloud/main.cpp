@@ -1,13 +1,53 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "validate.hpp"
+#include "track.hpp"
+#include "benchmark.hpp"
 
 int main( int argc, char* argv[] )
 {
     try{
-        kinect kinect;
-        kinect.run();
+        const std::string mode = ( argc > 1 ) ? argv[1] : "live";
+        if( mode == "validate" ){
+            // Recorded Depth and IMU Tracks without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            validate( file );
+        }
+        else if( mode == "odometry" ){
+            // Recorded Depth Track without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            const std::string trajectory = ( argc > 3 ) ? argv[3] : "trajectory.txt";
+            track( file, trajectory );
+        }
+        else if( mode == "normals" ){
+            // Recorded Depth Track without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_normals( file );
+        }
+        else if( mode == "planes" ){
+            // Recorded Depth and IMU Tracks without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_planes( file );
+        }
+        else if( mode == "mesh" ){
+            // Recorded Depth Track without Device
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            const std::string output = ( argc > 3 ) ? argv[3] : "mesh";
+            benchmark_mesh( file, output );
+        }
+        else if( mode == "viewer" ){
+            // Recorded Depth Track without Device (offscreen rendering, no display)
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_viewer( file );
+        }
+        else{
+            // Device ('m' toggles motion compensation (off by default), 'n' normals, 'p' planes, 'w' mesh, 'e' exports mesh, 'o' odometry (off by default), 's' rolling shutter correction, 'r' resets reference frame and odometry)
+            kinect kinect;
+            kinect.run();
+        }
     }
     catch( const k4a::error& error ){
         std::cout << error.what() << std::endl;
@@ -0,0 +1,264 @@
+#include "mesh.hpp"
+
+#include <k4a/k4a.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    // Check Edge does not cross Depth Discontinuity
+    inline bool is_connected( const int16_t z0, const int16_t z1, const float max_edge_ratio )
+    {
+        return std::abs( z0 - z1 ) <= max_edge_ratio * std::min( z0, z1 );
+    }
+
+    // Check Triangle is Valid
+    inline bool is_valid( const int16_t z0, const int16_t z1, const int16_t z2, const float max_edge_ratio )
+    {
+        return z0 > 0 && z1 > 0 && z2 > 0
+            && is_connected( z0, z1, max_edge_ratio ) && is_connected( z1, z2, max_edge_ratio ) && is_connected( z2, z0, max_edge_ratio );
+    }
+}
+
+// Constructor
+organized_mesh::organized_mesh( const float max_edge_ratio, const int32_t tile_size )
+    : max_edge_ratio( max_edge_ratio ),
+      tile_size( std::max( 1, tile_size ) ),
+      changed_tiles( 0 ),
+      revision( 0 )
+{
+}
+
+// Build Mesh
+void organized_mesh::build( const cv::Mat& xyz, const cv::Mat& color )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+    CV_Assert( color.empty() || ( color.size() == xyz.size() && ( color.type() == CV_8UC3 || color.type() == CV_8UC4 ) ) );
+
+    // Initialize Tiles when Size Changed
+    if( grid != cv::Size( xyz.cols - 1, xyz.rows - 1 ) ){
+        initialize( xyz.size() );
+    }
+
+    // Vertices and Colors (one per pixel, uploaded every frame)
+    xyz.convertTo( vertices, CV_32FC3 );
+    if( color.empty() ){
+        colors.create( xyz.size(), CV_8UC3 );
+        colors.setTo( cv::Scalar::all( 255 ) );
+    }
+    else if( color.channels() == 4 ){
+        cv::cvtColor( color, colors, cv::COLOR_BGRA2BGR );
+    }
+    else{
+        color.copyTo( colors );
+    }
+
+    // Update Tiles (tiles are independent)
+    cv::parallel_for_( cv::Range( 0, static_cast<int32_t>( tiles.size() ) ), [&]( const cv::Range& range ){
+        for( int32_t i = range.start; i < range.end; i++ ){
+            tiles[i].changed = update( tiles[i], xyz );
+        }
+    } );
+
+    // Count Changed Tiles
+    changed_tiles = 0;
+    for( const tile& target : tiles ){
+        if( target.changed ){
+            changed_tiles++;
+        }
+    }
+
+    // Assemble Index Buffer only if any Tile Changed
+    if( !changed_tiles ){
+        return;
+    }
+
+    indices.clear();
+    for( const tile& target : tiles ){
+        indices.insert( indices.end(), target.indices.begin(), target.indices.end() );
+    }
+    revision++;
+
+    #ifdef HAVE_OPENCV_VIZ
+    // Polygons are [ 3, i0, i1, i2, 3, ... ]
+    const int32_t triangles = static_cast<int32_t>( get_triangles() );
+    polygons.create( 1, triangles * 4, CV_32SC1 );
+    int32_t* polygon = polygons.ptr<int32_t>();
+    for( int32_t i = 0; i < triangles; i++ ){
+        polygon[i * 4 + 0] = 3;
+        polygon[i * 4 + 1] = indices[i * 3 + 0];
+        polygon[i * 4 + 2] = indices[i * 3 + 1];
+        polygon[i * 4 + 3] = indices[i * 3 + 2];
+    }
+    #endif
+}
+
+#ifdef HAVE_OPENCV_VIZ
+// Get Mesh for Viz
+cv::viz::Mesh organized_mesh::get_viz_mesh() const
+{
+    cv::viz::Mesh mesh;
+    mesh.cloud = vertices.reshape( 3, 1 );
+    mesh.colors = colors.reshape( 3, 1 );
+
+    // Polygons of Last Assembled Index Buffer (shared, not copied)
+    mesh.polygons = polygons;
+    return mesh;
+}
+#endif
+
+// Save as Binary PLY
+void organized_mesh::save_ply( const std::string& file ) const
+{
+    std::vector<int32_t> vertex_indices, face_indices;
+    compact( vertex_indices, face_indices );
+
+    std::ofstream stream( file, std::ios::binary );
+    if( !stream.is_open() ){
+        throw k4a::error( "Failed to open ply file!" );
+    }
+
+    // Header
+    stream << "ply\n"
+           << "format binary_little_endian 1.0\n"
+           << "element vertex " << vertex_indices.size() << "\n"
+           << "property float x\n"
+           << "property float y\n"
+           << "property float z\n"
+           << "property uchar red\n"
+           << "property uchar green\n"
+           << "property uchar blue\n"
+           << "element face " << face_indices.size() / 3 << "\n"
+           << "property list uchar int vertex_indices\n"
+           << "end_header\n";
+
+    // Vertices (host is little endian)
+    const cv::Vec3f* points = vertices.ptr<cv::Vec3f>();
+    const cv::Vec3b* pixels = colors.ptr<cv::Vec3b>();
+    std::vector<char> buffer;
+    buffer.reserve( vertex_indices.size() * 15 );
+    for( const int32_t index : vertex_indices ){
+        const cv::Vec3b rgb( pixels[index][2], pixels[index][1], pixels[index][0] );
+        buffer.insert( buffer.end(), reinterpret_cast<const char*>( points[index].val ), reinterpret_cast<const char*>( points[index].val ) + sizeof( cv::Vec3f ) );
+        buffer.insert( buffer.end(), reinterpret_cast<const char*>( rgb.val ), reinterpret_cast<const char*>( rgb.val ) + sizeof( cv::Vec3b ) );
+    }
+    stream.write( buffer.data(), buffer.size() );
+
+    // Faces
+    buffer.clear();
+    buffer.reserve( face_indices.size() / 3 * 13 );
+    for( size_t i = 0; i < face_indices.size(); i += 3 ){
+        buffer.push_back( 3 );
+        buffer.insert( buffer.end(), reinterpret_cast<const char*>( &face_indices[i] ), reinterpret_cast<const char*>( &face_indices[i] ) + sizeof( int32_t ) * 3 );
+    }
+    stream.write( buffer.data(), buffer.size() );
+}
+
+// Save as OBJ
+void organized_mesh::save_obj( const std::string& file ) const
+{
+    std::vector<int32_t> vertex_indices, face_indices;
+    compact( vertex_indices, face_indices );
+
+    std::ofstream stream( file );
+    if( !stream.is_open() ){
+        throw k4a::error( "Failed to open obj file!" );
+    }
+
+    // Vertices with Color ( v x y z r g b, color is [0, 1] )
+    const cv::Vec3f* points = vertices.ptr<cv::Vec3f>();
+    const cv::Vec3b* pixels = colors.ptr<cv::Vec3b>();
+    for( const int32_t index : vertex_indices ){
+        stream << "v " << points[index][0] << " " << points[index][1] << " " << points[index][2] << " "
+               << pixels[index][2] / 255.0f << " " << pixels[index][1] / 255.0f << " " << pixels[index][0] / 255.0f << "\n";
+    }
+
+    // Faces (1-based)
+    for( size_t i = 0; i < face_indices.size(); i += 3 ){
+        stream << "f " << face_indices[i] + 1 << " " << face_indices[i + 1] + 1 << " " << face_indices[i + 2] + 1 << "\n";
+    }
+}
+
+// Initialize Tiles
+void organized_mesh::initialize( const cv::Size& size )
+{
+    grid = cv::Size( std::max( 0, size.width - 1 ), std::max( 0, size.height - 1 ) );
+    tiles.clear();
+    indices.clear();
+    for( int32_t y = 0; y < grid.height; y += tile_size ){
+        for( int32_t x = 0; x < grid.width; x += tile_size ){
+            tile target;
+            target.cells = cv::Rect( x, y, std::min( tile_size, grid.width - x ), std::min( tile_size, grid.height - y ) );
+            target.changed = true;
+            tiles.push_back( target );
+        }
+    }
+}
+
+// Update Tile
+bool organized_mesh::update( tile& target, const cv::Mat& xyz ) const
+{
+    // Triangle Mask of Tile ( a, c, b ) and ( b, c, d ) of cell with a b / c d
+    const size_t bits = static_cast<size_t>( target.cells.area() ) * 2;
+    std::vector<uint64_t> mask( ( bits + 63 ) / 64, 0 );
+    size_t bit = 0;
+    for( int32_t y = target.cells.y; y < target.cells.y + target.cells.height; y++ ){
+        const cv::Vec3s* top = xyz.ptr<cv::Vec3s>( y );
+        const cv::Vec3s* bottom = xyz.ptr<cv::Vec3s>( y + 1 );
+        for( int32_t x = target.cells.x; x < target.cells.x + target.cells.width; x++, bit += 2 ){
+            const int16_t a = top[x][2], b = top[x + 1][2];
+            const int16_t c = bottom[x][2], d = bottom[x + 1][2];
+            const uint64_t upper = is_valid( a, c, b, max_edge_ratio ) ? 1u : 0u;
+            const uint64_t lower = is_valid( b, c, d, max_edge_ratio ) ? 1u : 0u;
+            mask[bit / 64] |= ( upper | ( lower << 1 ) ) << ( bit % 64 );
+        }
+    }
+
+    // Reuse Indices if Triangles are Same as Previous Frame
+    if( mask == target.mask ){
+        return false;
+    }
+    target.mask.swap( mask );
+
+    // Rebuild Indices of Tile (vertex index is pixel index)
+    target.indices.clear();
+    const int32_t cols = xyz.cols;
+    bit = 0;
+    for( int32_t y = target.cells.y; y < target.cells.y + target.cells.height; y++ ){
+        for( int32_t x = target.cells.x; x < target.cells.x + target.cells.width; x++, bit += 2 ){
+            const uint64_t triangles = ( target.mask[bit / 64] >> ( bit % 64 ) ) & 3u;
+            if( !triangles ){
+                continue;
+            }
+
+            const int32_t a = y * cols + x, b = a + 1;
+            const int32_t c = a + cols, d = c + 1;
+            if( triangles & 1u ){
+                target.indices.insert( target.indices.end(), { a, c, b } );
+            }
+            if( triangles & 2u ){
+                target.indices.insert( target.indices.end(), { b, c, d } );
+            }
+        }
+    }
+    return true;
+}
+
+// Get Compact Vertices
+void organized_mesh::compact( std::vector<int32_t>& vertex_indices, std::vector<int32_t>& face_indices ) const
+{
+    // Remap Referenced Pixels to Sequential Indices
+    std::vector<int32_t> remap( vertices.total(), -1 );
+    vertex_indices.clear();
+    face_indices.resize( indices.size() );
+    for( size_t i = 0; i < indices.size(); i++ ){
+        int32_t& index = remap[indices[i]];
+        if( index < 0 ){
+            index = static_cast<int32_t>( vertex_indices.size() );
+            vertex_indices.push_back( indices[i] );
+        }
+        face_indices[i] = index;
+    }
+}
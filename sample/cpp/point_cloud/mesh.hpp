@@ -0,0 +1,109 @@
+#ifndef __MESH__
+#define __MESH__
+
+#include <opencv2/opencv.hpp>
+#ifdef HAVE_OPENCV_VIZ
+#include <opencv2/viz.hpp>
+#endif
+
+#include <string>
+#include <vector>
+
+/*
+ This is triangle mesh of organized point cloud built directly on pixel grid.
+
+ organized_mesh mesh;
+ mesh.build( xyz, color );   // CV_16SC3 [mm], CV_8UC3/CV_8UC4 (optional, registered to xyz)
+ mesh.save_ply( "mesh.ply" ); // binary little endian
+
+ Each 2x2 cell of pixels yields up to two triangles ( a, c, b ) and ( b, c, d ) facing camera,
+ triangle is rejected if any vertex is invalid or depth jumps across an edge (depth discontinuity).
+ Vertex index is pixel index, so that index buffer depends only on which triangles exist.
+ Grid is divided into tiles, triangles of tile are kept as bit mask and index buffer of tile is rebuilt only if mask changed,
+ index buffer (and polygons for viz) is assembled only if any tile changed, and revision is incremented then.
+ Viewer (mesh_widget) uploads vertices and colors every refresh, and triangles only when revision changed.
+*/
+
+class organized_mesh
+{
+private:
+    // Tile
+    struct tile
+    {
+        cv::Rect cells;                // cells of tile (cell is top-left pixel of 2x2 pixels)
+        std::vector<uint64_t> mask;    // 2 bits per cell
+        std::vector<int32_t> indices;  // triangles of tile
+        bool changed;
+    };
+
+    // Parameters
+    float max_edge_ratio;
+    int32_t tile_size;
+
+    // Vertices (one per pixel)
+    cv::Mat vertices; // CV_32FC3 [mm]
+    cv::Mat colors;   // CV_8UC3 (BGR)
+
+    // Tiles and Index Buffer
+    std::vector<tile> tiles;
+    std::vector<int32_t> indices;
+    cv::Size grid;
+    uint32_t changed_tiles;
+    uint64_t revision;
+
+    #ifdef HAVE_OPENCV_VIZ
+    // Polygons for Viz (assembled with index buffer)
+    cv::Mat polygons;
+    #endif
+
+public:
+    // Constructor (max depth jump across edge as ratio of depth, tile size in cells)
+    organized_mesh( const float max_edge_ratio = 0.05f, const int32_t tile_size = 32 );
+
+    // Build Mesh
+    void build( const cv::Mat& xyz, const cv::Mat& color = cv::Mat() );
+
+    // Get Number of Triangles
+    size_t get_triangles() const { return indices.size() / 3; }
+
+    // Get Number of Tiles whose Indices Changed in Last Build
+    uint32_t get_changed_tiles() const { return changed_tiles; }
+
+    // Get Number of Tiles
+    uint32_t get_tiles() const { return static_cast<uint32_t>( tiles.size() ); }
+
+    // Get Index Buffer (3 indices per triangle, index is pixel index)
+    const std::vector<int32_t>& get_indices() const { return indices; }
+
+    // Get Revision of Index Buffer (incremented when index buffer is assembled)
+    uint64_t get_revision() const { return revision; }
+
+    // Get Vertices (CV_32FC3 [mm], one per pixel)
+    const cv::Mat& get_vertices() const { return vertices; }
+
+    // Get Colors (CV_8UC3 (BGR), one per pixel)
+    const cv::Mat& get_colors() const { return colors; }
+
+    #ifdef HAVE_OPENCV_VIZ
+    // Get Mesh for Viz
+    cv::viz::Mesh get_viz_mesh() const;
+    #endif
+
+    // Save as Binary PLY (only referenced vertices)
+    void save_ply( const std::string& file ) const;
+
+    // Save as OBJ (only referenced vertices, vertex color extension)
+    void save_obj( const std::string& file ) const;
+
+private:
+    // Initialize Tiles
+    void initialize( const cv::Size& size );
+
+    // Update Tile (returns true if triangles changed)
+    bool update( tile& target, const cv::Mat& xyz ) const;
+
+    // Get Compact Vertices (referenced vertices and remapped indices)
+    void compact( std::vector<int32_t>& vertex_indices, std::vector<int32_t>& face_indices ) const;
+};
+
+#endif // __MESH__
@@ -0,0 +1,118 @@
+#include "mesh_widget.hpp"
+
+#if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+#include <opencv2/viz/widget_accessor.hpp>
+#include <vtkActor.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyDataMapper.h>
+#endif
+
+// Constructor
+mesh_widget::mesh_widget()
+    : uploads( 0 ),
+      uploaded_bytes( 0 ),
+      cell_uploads( 0 ),
+      revision( 0 ),
+      uploaded( false )
+{
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // Point and Color Arrays (owned by VTK, resized only when number of vertices changed)
+    point_array = vtkSmartPointer<vtkFloatArray>::New();
+    point_array->SetNumberOfComponents( 3 );
+    color_array = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    color_array->SetNumberOfComponents( 3 );
+    color_array->SetName( "Colors" );
+
+    vtkSmartPointer<vtkPoints> vtk_points = vtkSmartPointer<vtkPoints>::New();
+    vtk_points->SetData( point_array );
+
+    // Triangle Cells
+    cell_array = vtkSmartPointer<vtkIdTypeArray>::New();
+    cells = vtkSmartPointer<vtkCellArray>::New();
+
+    polydata = vtkSmartPointer<vtkPolyData>::New();
+    polydata->SetPoints( vtk_points );
+    polydata->SetPolys( cells );
+    polydata->GetPointData()->SetScalars( color_array );
+
+    // Mapper and Actor
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mapper->SetInputData( polydata );
+    mapper->SetScalarModeToUsePointData();
+    mapper->ScalarVisibilityOn();
+
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper( mapper );
+
+    // Wrap Actor as Viz Widget
+    cv::viz::WidgetAccessor::setProp( widget, actor );
+    #endif
+}
+
+// Update Widget with Mesh
+void mesh_widget::upload( const organized_mesh& mesh )
+{
+    const cv::Mat& vertices = mesh.get_vertices();
+    const cv::Mat& colors = mesh.get_colors();
+    if( vertices.empty() ){
+        return;
+    }
+    CV_Assert( vertices.type() == CV_32FC3 && colors.type() == CV_8UC3 && vertices.size() == colors.size() );
+
+    const size_t count = vertices.total();
+    const bool changed = !uploaded || revision != mesh.get_revision();
+
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // Copy Vertices and Colors into Arrays of Polydata ( BGR -> RGB )
+    point_array->SetNumberOfTuples( static_cast<vtkIdType>( count ) );
+    color_array->SetNumberOfTuples( static_cast<vtkIdType>( count ) );
+    cv::Mat points( vertices.size(), CV_32FC3, point_array->GetPointer( 0 ) );
+    cv::Mat pixels( colors.size(), CV_8UC3, color_array->GetPointer( 0 ) );
+    vertices.copyTo( points );
+    cv::cvtColor( colors, pixels, cv::COLOR_BGR2RGB );
+    point_array->Modified();
+    color_array->Modified();
+    polydata->GetPoints()->Modified();
+
+    // Triangle Cells (rebuilt only when index buffer was assembled again)
+    if( changed ){
+        const std::vector<int32_t>& indices = mesh.get_indices();
+        const size_t triangles = indices.size() / 3;
+        ids.resize( triangles * 4 );
+        for( size_t i = 0; i < triangles; i++ ){
+            ids[i * 4 + 0] = 3;
+            ids[i * 4 + 1] = indices[i * 3 + 0];
+            ids[i * 4 + 2] = indices[i * 3 + 1];
+            ids[i * 4 + 3] = indices[i * 3 + 2];
+        }
+        cell_array->SetArray( ids.data(), static_cast<vtkIdType>( ids.size() ), 1 );
+        cells->SetCells( static_cast<vtkIdType>( triangles ), cell_array );
+        cells->Modified();
+        uploaded_bytes += ids.size() * sizeof( vtkIdType );
+    }
+    polydata->Modified();
+    #elif defined( HAVE_OPENCV_VIZ )
+    // Fallback (new widget of whole mesh, polygons are uploaded every time)
+    widget = cv::viz::WMesh( mesh.get_viz_mesh() );
+    uploaded_bytes += mesh.get_indices().size() / 3 * 4 * sizeof( int32_t );
+    #endif
+
+    if( changed || !is_persistent() ){
+        cell_uploads++;
+    }
+    revision = mesh.get_revision();
+    uploaded = true;
+    uploads++;
+    uploaded_bytes += count * ( sizeof( float ) * 3 + sizeof( uint8_t ) * 3 );
+}
+
+// Check Widget is Updated in Place
+bool mesh_widget::is_persistent() const
+{
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    return true;
+    #else
+    return false;
+    #endif
+}
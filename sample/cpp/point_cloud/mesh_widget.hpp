@@ -0,0 +1,87 @@
+#ifndef __MESH_WIDGET__
+#define __MESH_WIDGET__
+
+#include <opencv2/opencv.hpp>
+#ifdef HAVE_OPENCV_VIZ
+#include <opencv2/viz.hpp>
+#endif
+#if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkFloatArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkCellArray.h>
+#endif
+
+#include <vector>
+
+#include "mesh.hpp"
+
+/*
+ This is persistent triangle mesh widget whose arrays are updated in place every refresh.
+
+ mesh_widget mesh_view;
+ mesh_view.upload( mesher );                 // show: copy vertices and colors, triangles only if revision changed
+ if( mesh_view.is_persistent() ){ ... }      // widget needs to be shown only once
+ viewer.showWidget( "cloud", mesh_view.get_widget() );
+
+ cv::viz::WMesh copies vertices, colors and polygons into new VTK polydata every refresh.
+ With VTK available (HAVE_VTK), this widget owns one vtkPolyData, vertices and colors are copied into its arrays
+ (no reallocation after warm-up), and cells are rebuilt only when revision of index buffer of organized_mesh changed,
+ so that triangles are not uploaded while tiles are reused.
+ Without VTK, upload() falls back to new cv::viz::WMesh.
+*/
+
+class mesh_widget
+{
+private:
+    // Statistics
+    uint64_t uploads;
+    uint64_t uploaded_bytes;
+    uint64_t cell_uploads;
+
+    // Revision of Uploaded Triangles
+    uint64_t revision;
+    bool uploaded;
+
+    #ifdef HAVE_OPENCV_VIZ
+    cv::viz::Widget3D widget;
+    #endif
+
+    #if defined( HAVE_OPENCV_VIZ ) && defined( HAVE_VTK )
+    // VTK Objects (created once)
+    vtkSmartPointer<vtkPolyData> polydata;
+    vtkSmartPointer<vtkFloatArray> point_array;
+    vtkSmartPointer<vtkUnsignedCharArray> color_array;
+    vtkSmartPointer<vtkCellArray> cells;
+    vtkSmartPointer<vtkIdTypeArray> cell_array;
+    std::vector<vtkIdType> ids; // [ 3, i0, i1, i2, 3, ... ] (one cell per triangle)
+    #endif
+
+public:
+    // Constructor
+    mesh_widget();
+
+    // Update Widget with Mesh
+    void upload( const organized_mesh& mesh );
+
+    // Check Widget is Updated in Place (needs to be shown only once)
+    bool is_persistent() const;
+
+    #ifdef HAVE_OPENCV_VIZ
+    // Get Widget
+    const cv::viz::Widget3D& get_widget() const { return widget; }
+    #endif
+
+    // Get Number of Uploads
+    uint64_t get_uploads() const { return uploads; }
+
+    // Get Number of Uploads with Triangles
+    uint64_t get_cell_uploads() const { return cell_uploads; }
+
+    // Get Total Uploaded Bytes
+    uint64_t get_uploaded_bytes() const { return uploaded_bytes; }
+};
+
+#endif // __MESH_WIDGET__
@@ -0,0 +1,124 @@
+#include "motion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+motion_compensator::motion_compensator( const k4a::calibration& calibration, const k4a_calibration_type_t camera )
+    : gyro_bias( 0.0, 0.0, 0.0 ),
+      still_samples( 0 ),
+      angular_velocity( 0.0f, 0.0f, 0.0f ),
+      up( 0.0f, -1.0f, 0.0f ),
+      rolling_shutter( false ),
+      readout_time( 0.0 )
+{
+    // Get Rotation from Gyro and Accelerometer to Camera (row-major)
+    const float* rotation = calibration.extrinsics[K4A_CALIBRATION_TYPE_GYRO][camera].rotation;
+    extrinsics = cv::Matx33f( rotation[0], rotation[1], rotation[2],
+                              rotation[3], rotation[4], rotation[5],
+                              rotation[6], rotation[7], rotation[8] );
+    const float* acc_rotation = calibration.extrinsics[K4A_CALIBRATION_TYPE_ACCEL][camera].rotation;
+    acc_extrinsics = cv::Matx33f( acc_rotation[0], acc_rotation[1], acc_rotation[2],
+                                  acc_rotation[3], acc_rotation[4], acc_rotation[5],
+                                  acc_rotation[6], acc_rotation[7], acc_rotation[8] );
+
+    // Reserve Batch (~1.6 kHz / 30 fps, with headroom for late frames)
+    corrected.reserve( 256 );
+}
+
+// Update Pose
+void motion_compensator::update( const std::vector<imu::sample>& batch )
+{
+    corrected.assign( batch.begin(), batch.end() );
+    if( corrected.empty() ){
+        return;
+    }
+
+    cv::Vec3d sum( 0.0, 0.0, 0.0 );
+    cv::Vec3d acc_sum( 0.0, 0.0, 0.0 );
+    for( imu::sample& imu_sample : corrected ){
+        const cv::Vec3d gyro( imu_sample.gyro_sample.xyz.x, imu_sample.gyro_sample.xyz.y, imu_sample.gyro_sample.xyz.z );
+        const cv::Vec3d acc( imu_sample.acc_sample.xyz.x, imu_sample.acc_sample.xyz.y, imu_sample.acc_sample.xyz.z );
+
+        // Track Gyro Bias while Device is Still (gravity only, small rate)
+        constexpr double gravity = 9.81;
+        constexpr double acc_threshold = 0.3;
+        constexpr double gyro_threshold = 0.05;
+        constexpr double alpha = 0.01;
+        if( std::abs( cv::norm( acc ) - gravity ) < acc_threshold && cv::norm( gyro - gyro_bias ) < gyro_threshold ){
+            gyro_bias = ( still_samples ? ( 1.0 - alpha ) * gyro_bias + alpha * gyro : gyro );
+            still_samples++;
+        }
+
+        // Remove Gyro Bias
+        const cv::Vec3d rate = gyro - gyro_bias;
+        imu_sample.gyro_sample.xyz.x = static_cast<float>( rate[0] );
+        imu_sample.gyro_sample.xyz.y = static_cast<float>( rate[1] );
+        imu_sample.gyro_sample.xyz.z = static_cast<float>( rate[2] );
+        sum += rate;
+        acc_sum += acc;
+    }
+
+    // Integrate Orientation (gyro frame)
+    integrator.integrate( corrected );
+
+    // Mean Angular Velocity of Frame (camera frame)
+    const cv::Vec3d mean = sum * ( 1.0 / corrected.size() );
+    angular_velocity = extrinsics * cv::Vec3f( static_cast<float>( mean[0] ), static_cast<float>( mean[1] ), static_cast<float>( mean[2] ) );
+
+    // Up Direction (accelerometer measures reaction to gravity, it points up while device is not accelerating)
+    const double acc_norm = cv::norm( acc_sum );
+    if( acc_norm > 0.0 ){
+        const cv::Vec3d acc_mean = acc_sum * ( 1.0 / acc_norm );
+        up = acc_extrinsics * cv::Vec3f( static_cast<float>( acc_mean[0] ), static_cast<float>( acc_mean[1] ), static_cast<float>( acc_mean[2] ) );
+    }
+}
+
+// Apply Correction
+void motion_compensator::apply( const cv::Mat& xyz, cv::Mat& compensated ) const
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+
+    // Rotation from Current Camera Frame to Reference Frame
+    const cv::Matx33f pose = get_pose();
+
+    if( !rolling_shutter ){
+        // Rigid Correction of Whole Frame
+        cv::transform( xyz, compensated, pose );
+        return;
+    }
+
+    // Rigid and Rolling Shutter Correction for each Row
+    // NOTE: Row is rotated back to center of exposure with small angle rotation ( I + [w]x ), w = angular velocity x row time.
+    compensated.create( xyz.size(), xyz.type() );
+    const int32_t rows = xyz.rows;
+    for( int32_t row = 0; row < rows; row++ ){
+        const double time = ( static_cast<double>( row ) / std::max( 1, rows - 1 ) - 0.5 ) * readout_time;
+        const cv::Vec3f w = angular_velocity * static_cast<float>( time );
+        const cv::Matx33f skew( 1.0f, -w[2],  w[1],
+                                 w[2],  1.0f, -w[0],
+                                -w[1],  w[0],  1.0f );
+        cv::Mat destination = compensated.row( row );
+        cv::transform( xyz.row( row ), destination, pose * skew );
+    }
+}
+
+// Reset Reference Frame
+void motion_compensator::reset()
+{
+    integrator.reset();
+}
+
+// Set Rolling Shutter Correction
+void motion_compensator::set_rolling_shutter( const bool enabled, const std::chrono::microseconds readout_time )
+{
+    rolling_shutter = enabled;
+    this->readout_time = readout_time.count() / 1000000.0;
+}
+
+// Get Pose
+cv::Matx33f motion_compensator::get_pose() const
+{
+    // Conjugate Rotation into Camera Frame
+    return extrinsics * integrator.get_orientation().to_matrix() * extrinsics.t();
+}
@@ -0,0 +1,87 @@
+#ifndef __MOTION__
+#define __MOTION__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include "imu.hpp"
+
+/*
+ This is motion compensation of point cloud that uses IMU samples between frames.
+
+ motion_compensator compensator( calibration, K4A_CALIBRATION_TYPE_COLOR );
+ compensator.update( batch );   // IMU samples up to timestamp of frame
+ compensator.apply( xyz, out ); // rotate point cloud (CV_16SC3) into reference frame
+
+ Point cloud is buffer of depth_image_to_point_cloud wrapped as CV_16SC3 [mm], not CV_32FC3 of k4a::get_mat.
+
+ Per-frame correction rotates cloud of frame k into camera frame of first frame (or last reset).
+ Gyro rate is integrated in gyro frame and conjugated into camera frame with factory extrinsics.
+ Accelerometer is used to detect when device is still and to track gyro bias then, and gives up direction.
+ Translation is not estimated, double integration of acceleration drifts within a few frames.
+
+ Rolling shutter correction (optional, color camera) rotates each row back to center of exposure
+ with angular velocity of frame, row r is exposed at ( r / ( rows - 1 ) - 0.5 ) x readout time.
+*/
+
+class motion_compensator
+{
+private:
+    // Gyro and Accelerometer to Camera Rotation
+    cv::Matx33f extrinsics;
+    cv::Matx33f acc_extrinsics;
+
+    // Orientation (gyro frame)
+    imu::integrator integrator;
+    std::vector<imu::sample> corrected;
+
+    // Gyro Bias (gyro frame, rad/s)
+    cv::Vec3d gyro_bias;
+    uint64_t still_samples;
+
+    // Angular Velocity of Last Frame (camera frame, rad/s)
+    cv::Vec3f angular_velocity;
+
+    // Up Direction of Last Frame (camera frame, unit)
+    cv::Vec3f up;
+
+    // Rolling Shutter
+    bool rolling_shutter;
+    double readout_time;
+
+public:
+    // Constructor
+    motion_compensator( const k4a::calibration& calibration, const k4a_calibration_type_t camera = K4A_CALIBRATION_TYPE_COLOR );
+
+    // Update Pose with IMU Samples between Previous and Current Frame
+    void update( const std::vector<imu::sample>& batch );
+
+    // Apply Correction to Point Cloud (CV_16SC3 [mm], output is CV_16SC3)
+    void apply( const cv::Mat& xyz, cv::Mat& compensated ) const;
+
+    // Reset Reference Frame to Current Frame
+    void reset();
+
+    // Set Rolling Shutter Correction
+    void set_rolling_shutter( const bool enabled, const std::chrono::microseconds readout_time = std::chrono::microseconds( 16000 ) );
+
+    // Check Rolling Shutter Correction is Enabled
+    bool is_rolling_shutter() const { return rolling_shutter; }
+
+    // Get Rotation from Current Camera Frame to Reference Frame
+    cv::Matx33f get_pose() const;
+
+    // Get Angular Velocity of Last Frame (camera frame, rad/s)
+    cv::Vec3f get_angular_velocity() const { return angular_velocity; }
+
+    // Get Up Direction of Last Frame from Accelerometer (camera frame, unit)
+    cv::Vec3f get_up() const { return up; }
+
+    // Get Number of Samples used for Gyro Bias
+    uint64_t get_still_samples() const { return still_samples; }
+};
+
+#endif // __MOTION__
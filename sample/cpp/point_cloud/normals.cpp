@@ -0,0 +1,266 @@
+#include "normals.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Channels of Window Sums ( count, x, y, z, xx, xy, xz, yy, yz, zz )
+    constexpr int32_t channels = 10;
+
+    // Sum Row over Horizontal Window ( 2 x radius + 1 ) of each Column
+    void sum_row( const cv::Vec3s* points, const int32_t cols, const int32_t radius, int64_t* values, int64_t* sums )
+    {
+        // Values of Pixels (zero for invalid point)
+        for( int32_t x = 0; x < cols; x++ ){
+            int64_t* value = values + x * channels;
+            const int64_t px = points[x][0], py = points[x][1], pz = points[x][2];
+            if( pz <= 0 ){
+                std::fill( value, value + channels, 0 );
+                continue;
+            }
+            value[0] = 1;
+            value[1] = px; value[2] = py; value[3] = pz;
+            value[4] = px * px; value[5] = px * py; value[6] = px * pz;
+            value[7] = py * py; value[8] = py * pz; value[9] = pz * pz;
+        }
+
+        // Sliding Window along Row
+        int64_t sum[channels] = {};
+        for( int32_t x = 0; x < std::min( cols, radius ); x++ ){
+            for( int32_t c = 0; c < channels; c++ ){
+                sum[c] += values[x * channels + c];
+            }
+        }
+        for( int32_t x = 0; x < cols; x++ ){
+            const int32_t entering = x + radius;
+            const int32_t leaving = x - radius - 1;
+            for( int32_t c = 0; c < channels; c++ ){
+                if( entering < cols ){
+                    sum[c] += values[entering * channels + c];
+                }
+                if( leaving >= 0 ){
+                    sum[c] -= values[leaving * channels + c];
+                }
+                sums[x * channels + c] = sum[c];
+            }
+        }
+    }
+
+    // Get Unit Eigenvector of Smallest Eigenvalue of Symmetric 3x3 Matrix (returns false if degenerate)
+    bool get_smallest_eigenvector( const double c[6], cv::Vec3f& normal, float& curvature )
+    {
+        // c = { xx, xy, xz, yy, yz, zz }
+        const double trace = c[0] + c[3] + c[5];
+        const double q = trace / 3.0;
+        const double p1 = c[1] * c[1] + c[2] * c[2] + c[4] * c[4];
+        const double p2 = ( c[0] - q ) * ( c[0] - q ) + ( c[3] - q ) * ( c[3] - q ) + ( c[5] - q ) * ( c[5] - q ) + 2.0 * p1;
+        if( trace <= 0.0 || p2 <= 1e-12 * trace * trace ){
+            return false;
+        }
+
+        // Smallest Eigenvalue (trigonometric solution of characteristic polynomial)
+        const double p = std::sqrt( p2 / 6.0 );
+        const double b00 = ( c[0] - q ) / p, b01 = c[1] / p, b02 = c[2] / p;
+        const double b11 = ( c[3] - q ) / p, b12 = c[4] / p, b22 = ( c[5] - q ) / p;
+        const double r = std::max( -1.0, std::min( 1.0, 0.5 * ( b00 * ( b11 * b22 - b12 * b12 ) - b01 * ( b01 * b22 - b12 * b02 ) + b02 * ( b01 * b12 - b11 * b02 ) ) ) );
+        const double phi = std::acos( r ) / 3.0;
+        const double lambda = q + 2.0 * p * std::cos( phi + 2.0 * CV_PI / 3.0 );
+
+        // Eigenvector is Largest Cross Product of Rows of ( C - lambda I )
+        const cv::Vec3d row0( c[0] - lambda, c[1], c[2] );
+        const cv::Vec3d row1( c[1], c[3] - lambda, c[4] );
+        const cv::Vec3d row2( c[2], c[4], c[5] - lambda );
+        const cv::Vec3d candidates[3] = { row0.cross( row1 ), row0.cross( row2 ), row1.cross( row2 ) };
+        double max_length = 0.0;
+        int32_t index = 0;
+        for( int32_t i = 0; i < 3; i++ ){
+            const double length = candidates[i].dot( candidates[i] );
+            if( length > max_length ){
+                max_length = length;
+                index = i;
+            }
+        }
+
+        if( max_length <= 0.0 ){
+            return false;
+        }
+
+        const cv::Vec3d eigenvector = candidates[index] * ( 1.0 / std::sqrt( max_length ) );
+        normal = cv::Vec3f( static_cast<float>( eigenvector[0] ), static_cast<float>( eigenvector[1] ), static_cast<float>( eigenvector[2] ) );
+        curvature = static_cast<float>( std::max( 0.0, lambda ) / trace );
+        return true;
+    }
+
+    // Orient Normal towards Camera
+    inline cv::Vec3f orient( const cv::Vec3f& normal, const cv::Vec3s& point )
+    {
+        const float dot = normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2];
+        return ( dot > 0.0f ) ? normal * -1.0f : normal;
+    }
+}
+
+// Constructor
+normal_estimator::normal_estimator( const int32_t radius, const int32_t min_count )
+    : radius( radius ),
+      min_count( min_count )
+{
+}
+
+// Compute Normals
+void normal_estimator::compute( const cv::Mat& xyz, cv::Mat& normals, cv::Mat* curvature )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+
+    normals.create( xyz.size(), CV_32FC3 );
+    if( curvature ){
+        curvature->create( xyz.size(), CV_32FC1 );
+    }
+
+    // Covariance of Window from Sliding Window Sums (one stripe of rows per thread)
+    const int32_t rows = xyz.rows;
+    const int32_t cols = xyz.cols;
+    const int32_t ring = 2 * radius + 2;
+    const size_t width = static_cast<size_t>( cols ) * channels;
+    const double stripes = std::max( 1, cv::getNumThreads() );
+    cv::parallel_for_( cv::Range( 0, rows ), [&]( const cv::Range& range ){
+        // Row Sums of Rows in Window (ring), Column Sums over Window, Values of Row
+        std::vector<int64_t> row_sums( ring * width );
+        std::vector<int64_t> window( width, 0 );
+        std::vector<int64_t> values( width );
+
+        // Add Row to Window
+        const auto enter = [&]( const int32_t y ){
+            int64_t* sums = &row_sums[( y % ring ) * width];
+            sum_row( xyz.ptr<cv::Vec3s>( y ), cols, radius, values.data(), sums );
+            for( size_t i = 0; i < width; i++ ){
+                window[i] += sums[i];
+            }
+        };
+
+        // Remove Row from Window (row sums are still in ring)
+        const auto leave = [&]( const int32_t y ){
+            const int64_t* sums = &row_sums[( y % ring ) * width];
+            for( size_t i = 0; i < width; i++ ){
+                window[i] -= sums[i];
+            }
+        };
+
+        // First Window of Stripe (rows above first row)
+        for( int32_t y = std::max( 0, range.start - radius ); y < std::min( rows, range.start + radius ); y++ ){
+            enter( y );
+        }
+
+        for( int32_t y = range.start; y < range.end; y++ ){
+            // Slide Window Down
+            if( y > range.start && y - radius - 1 >= 0 ){
+                leave( y - radius - 1 );
+            }
+            if( y + radius < rows ){
+                enter( y + radius );
+            }
+
+            const cv::Vec3s* points = xyz.ptr<cv::Vec3s>( y );
+            cv::Vec3f* normal = normals.ptr<cv::Vec3f>( y );
+            float* curve = curvature ? curvature->ptr<float>( y ) : nullptr;
+            for( int32_t x = 0; x < cols; x++ ){
+                normal[x] = cv::Vec3f( 0.0f, 0.0f, 0.0f );
+                if( curve ){
+                    curve[x] = 0.0f;
+                }
+
+                if( points[x][2] <= 0 ){
+                    continue;
+                }
+
+                const int64_t* sum = &window[x * channels];
+                const int64_t count = sum[0];
+                if( count < min_count ){
+                    continue;
+                }
+
+                // Covariance ( n^2 C = n E[pp^T] n - E[p] n E[p]^T n, exact in integers )
+                const double scale = 1.0 / ( static_cast<double>( count ) * count );
+                const double covariance[6] = {
+                    static_cast<double>( count * sum[4] - sum[1] * sum[1] ) * scale,
+                    static_cast<double>( count * sum[5] - sum[1] * sum[2] ) * scale,
+                    static_cast<double>( count * sum[6] - sum[1] * sum[3] ) * scale,
+                    static_cast<double>( count * sum[7] - sum[2] * sum[2] ) * scale,
+                    static_cast<double>( count * sum[8] - sum[2] * sum[3] ) * scale,
+                    static_cast<double>( count * sum[9] - sum[3] * sum[3] ) * scale
+                };
+
+                cv::Vec3f n;
+                float c;
+                if( !get_smallest_eigenvector( covariance, n, c ) ){
+                    continue;
+                }
+
+                normal[x] = orient( n, points[x] );
+                if( curve ){
+                    curve[x] = c;
+                }
+            }
+        }
+    }, stripes );
+}
+
+// Compute Normals with Naive kNN
+void normal_estimator::compute_knn( const cv::Mat& xyz, cv::Mat& normals, const int32_t k )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+
+    // Collect Valid Points
+    std::vector<cv::Point> pixels;
+    std::vector<cv::Point3f> cloud;
+    for( int32_t y = 0; y < xyz.rows; y++ ){
+        const cv::Vec3s* row = xyz.ptr<cv::Vec3s>( y );
+        for( int32_t x = 0; x < xyz.cols; x++ ){
+            if( row[x][2] <= 0 ){
+                continue;
+            }
+            cloud.push_back( cv::Point3f( row[x][0], row[x][1], row[x][2] ) );
+            pixels.push_back( cv::Point( x, y ) );
+        }
+    }
+    const cv::Mat points = cv::Mat( cloud ).reshape( 1 );
+
+    normals.create( xyz.size(), CV_32FC3 );
+    normals.setTo( cv::Scalar::all( 0.0 ) );
+    if( points.rows < k ){
+        return;
+    }
+
+    // Search k Nearest Neighbors with KD-Tree
+    cv::flann::Index index( points, cv::flann::KDTreeIndexParams( 4 ) );
+    cv::Mat indices, distances;
+    index.knnSearch( points, indices, distances, k, cv::flann::SearchParams( 32 ) );
+
+    // PCA of Neighbors
+    cv::parallel_for_( cv::Range( 0, points.rows ), [&]( const cv::Range& range ){
+        for( int32_t i = range.start; i < range.end; i++ ){
+            const int32_t* neighbors = indices.ptr<int32_t>( i );
+            cv::Vec3d mean( 0.0, 0.0, 0.0 );
+            for( int32_t j = 0; j < k; j++ ){
+                const float* point = points.ptr<float>( neighbors[j] );
+                mean += cv::Vec3d( point[0], point[1], point[2] );
+            }
+            mean = mean * ( 1.0 / k );
+
+            cv::Matx33d covariance = cv::Matx33d::zeros();
+            for( int32_t j = 0; j < k; j++ ){
+                const float* point = points.ptr<float>( neighbors[j] );
+                const cv::Vec3d d = cv::Vec3d( point[0], point[1], point[2] ) - mean;
+                covariance = covariance + d * d.t();
+            }
+
+            // Eigenvectors are sorted by descending eigenvalues
+            cv::Mat eigenvalues, eigenvectors;
+            cv::eigen( covariance, eigenvalues, eigenvectors );
+            const cv::Vec3f n( eigenvectors.at<double>( 2, 0 ), eigenvectors.at<double>( 2, 1 ), eigenvectors.at<double>( 2, 2 ) );
+
+            const cv::Point& pixel = pixels[i];
+            normals.at<cv::Vec3f>( pixel ) = orient( n, xyz.at<cv::Vec3s>( pixel ) );
+        }
+    } );
+}
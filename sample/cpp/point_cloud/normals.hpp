@@ -0,0 +1,43 @@
+#ifndef __NORMALS__
+#define __NORMALS__
+
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+
+/*
+ This is normal estimation on organized point cloud with sliding box sums.
+
+ normal_estimator estimator( 4 );
+ estimator.compute( xyz, normals ); // CV_16SC3 [mm] -> CV_32FC3 (unit normal, zero is invalid)
+
+ Input is int16 buffer of depth_image_to_point_cloud as is (k4a::get_mat converts it to CV_32FC3, which is rejected).
+
+ Sums of count, XYZ and upper triangle of XYZ^T XYZ (10 channels) over ( 2 x radius + 1 )^2 window are updated by
+ sliding window (add entering row/column, subtract leaving one), so that cost is same for every pixel regardless of radius.
+ Sums are 64 bit integers of millimeters (exact, no drift and no cancellation in E[pp^T] - E[p]E[p]^T), only sums of
+ rows in window are kept ( 2 x radius + 2 rows of ring, about 1 MB for 1280 columns ) instead of full integral image.
+ Invalid points (zero) are excluded from window by count channel, window with too few valid points yields invalid normal.
+ Normal is eigenvector of smallest eigenvalue of covariance (closed form for 3x3), oriented towards camera.
+ Row stripes are computed in parallel (cv::parallel_for_), each stripe sums first window of its own.
+*/
+
+class normal_estimator
+{
+private:
+    // Parameters
+    int32_t radius;
+    int32_t min_count;
+
+public:
+    // Constructor (radius of window, min number of valid points in window)
+    normal_estimator( const int32_t radius = 4, const int32_t min_count = 9 );
+
+    // Compute Normals (curvature is smallest eigenvalue / sum of eigenvalues, optional)
+    void compute( const cv::Mat& xyz, cv::Mat& normals, cv::Mat* curvature = nullptr );
+
+    // Compute Normals with Naive kNN and PCA (for comparison, slow)
+    static void compute_knn( const cv::Mat& xyz, cv::Mat& normals, const int32_t k = 16 );
+};
+
+#endif // __NORMALS__
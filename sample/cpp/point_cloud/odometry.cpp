@@ -0,0 +1,240 @@
+#include "odometry.hpp"
+
+#include <cmath>
+#include <mutex>
+
+// Constructor
+odometry::odometry( const k4a_calibration_camera_t& camera, const parameters& params )
+    : params( params ),
+      fx( camera.intrinsics.parameters.param.fx ),
+      fy( camera.intrinsics.parameters.param.fy ),
+      cx( camera.intrinsics.parameters.param.cx ),
+      cy( camera.intrinsics.parameters.param.cy ),
+      pose( cv::Affine3d::Identity() ),
+      motion( cv::Affine3d::Identity() ),
+      frames( 0 ),
+      lost_frames( 0 ),
+      inlier_ratio( 0.0 )
+{
+    if( params.iterations.empty() ){
+        throw k4a::error( "Failed to create odometry (no pyramid level)!" );
+    }
+}
+
+// Track Frame
+bool odometry::track( const cv::Mat& xyz )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+
+    // Build Pyramid of Current Frame
+    build( xyz, current );
+    frames++;
+
+    // First Frame Defines Origin
+    if( previous.empty() ){
+        std::swap( previous, current );
+        return true;
+    }
+
+    // Align Current Frame to Previous Frame (initial estimate is motion of last frame)
+    cv::Affine3d estimate = motion;
+    const bool result = align( estimate );
+    if( result ){
+        motion = estimate;
+        pose = pose * motion;
+    }
+    else{
+        // Lost (restart from current frame, keep pose)
+        motion = cv::Affine3d::Identity();
+        lost_frames++;
+    }
+
+    std::swap( previous, current );
+    return result;
+}
+
+// Reset Pose
+void odometry::reset()
+{
+    pose = cv::Affine3d::Identity();
+    motion = cv::Affine3d::Identity();
+    previous.clear();
+}
+
+// Build Pyramid
+void odometry::build( const cv::Mat& xyz, std::vector<level>& pyramid ) const
+{
+    pyramid.resize( params.iterations.size() );
+    for( size_t i = 0; i < pyramid.size(); i++ ){
+        level& target = pyramid[i];
+
+        // Subsample Points (nearest, so that invalid points are not blended into valid ones)
+        if( i == 0 ){
+            xyz.convertTo( target.points, CV_32F );
+        }
+        else{
+            cv::resize( pyramid[i - 1].points, target.points, cv::Size( pyramid[i - 1].points.cols / 2, pyramid[i - 1].points.rows / 2 ), 0.0, 0.0, cv::INTER_NEAREST );
+        }
+
+        // Intrinsics of Level (pixel center is kept)
+        const float scale = 1.0f / static_cast<float>( 1 << i );
+        target.fx = fx * scale;
+        target.fy = fy * scale;
+        target.cx = ( cx + 0.5f ) * scale - 0.5f;
+        target.cy = ( cy + 0.5f ) * scale - 0.5f;
+
+        // Compute Normals
+        compute_normals( target );
+    }
+}
+
+// Compute Normals
+void odometry::compute_normals( level& target )
+{
+    // Cross Product of Central Differences on Organized Cloud
+    const cv::Mat& points = target.points;
+    target.normals.create( points.size(), CV_32FC3 );
+    target.normals.setTo( cv::Scalar::all( 0.0 ) );
+    for( int32_t y = 1; y < points.rows - 1; y++ ){
+        const cv::Vec3f* up     = points.ptr<cv::Vec3f>( y - 1 );
+        const cv::Vec3f* center = points.ptr<cv::Vec3f>( y );
+        const cv::Vec3f* down   = points.ptr<cv::Vec3f>( y + 1 );
+        cv::Vec3f* normal = target.normals.ptr<cv::Vec3f>( y );
+        for( int32_t x = 1; x < points.cols - 1; x++ ){
+            if( center[x][2] <= 0.0f || center[x - 1][2] <= 0.0f || center[x + 1][2] <= 0.0f || up[x][2] <= 0.0f || down[x][2] <= 0.0f ){
+                continue;
+            }
+
+            const cv::Vec3f n = ( center[x + 1] - center[x - 1] ).cross( down[x] - up[x] );
+            const float length = static_cast<float>( cv::norm( n ) );
+            if( length <= 0.0f ){
+                continue;
+            }
+
+            // Orient towards Camera
+            normal[x] = ( n.dot( center[x] ) > 0.0f ? -1.0f : 1.0f ) / length * n;
+        }
+    }
+}
+
+// Align Current Frame to Previous Frame
+bool odometry::align( cv::Affine3d& estimate )
+{
+    // Coarse to Fine
+    system result = {};
+    for( int32_t i = static_cast<int32_t>( params.iterations.size() ) - 1; i >= 0; i-- ){
+        for( int32_t iteration = 0; iteration < params.iterations[i]; iteration++ ){
+            // Accumulate Normal Equations
+            result = system();
+            accumulate( current[i], previous[i], estimate, result );
+            if( result.count < 6 ){
+                return false;
+            }
+
+            // Solve ( J^T J ) x = -J^T r
+            cv::Matx66d a;
+            cv::Vec6d b;
+            for( int32_t row = 0, k = 0; row < 6; row++ ){
+                for( int32_t column = row; column < 6; column++, k++ ){
+                    a( row, column ) = a( column, row ) = result.a[k];
+                }
+                b[row] = -result.b[row];
+            }
+
+            cv::Vec6d x;
+            if( !cv::solve( a, b, x, cv::DECOMP_CHOLESKY ) ){
+                return false;
+            }
+
+            // Update Estimate with Increment ( rotation vector, translation )
+            const cv::Affine3d increment( cv::Vec3d( x[0], x[1], x[2] ), cv::Vec3d( x[3], x[4], x[5] ) );
+            estimate = increment * estimate;
+
+            // Converged
+            constexpr double min_rotation = 1e-5;
+            constexpr double min_translation = 1e-2;
+            if( cv::norm( cv::Vec3d( x[0], x[1], x[2] ) ) < min_rotation && cv::norm( cv::Vec3d( x[3], x[4], x[5] ) ) < min_translation ){
+                break;
+            }
+        }
+    }
+
+    // Check Ratio of Pairs on Finest Level
+    const int32_t valid = cv::countNonZero( current[0].points.reshape( 1, static_cast<int32_t>( current[0].points.total() ) ).col( 2 ) );
+    inlier_ratio = valid ? static_cast<double>( result.count ) / valid : 0.0;
+    return inlier_ratio >= params.min_inlier_ratio;
+}
+
+// Accumulate Normal Equations
+void odometry::accumulate( const level& source, const level& target, const cv::Affine3d& estimate, system& result ) const
+{
+    const cv::Matx33f rotation = estimate.rotation();
+    const cv::Vec3f translation = estimate.translation();
+    const float max_distance = params.max_distance * params.max_distance;
+    const float huber = params.huber;
+
+    std::mutex mutex;
+    cv::parallel_for_( cv::Range( 0, source.points.rows ), [&]( const cv::Range& range ){
+        system local = {};
+        for( int32_t y = range.start; y < range.end; y++ ){
+            const cv::Vec3f* points = source.points.ptr<cv::Vec3f>( y );
+            for( int32_t x = 0; x < source.points.cols; x++ ){
+                if( points[x][2] <= 0.0f ){
+                    continue;
+                }
+
+                // Transform Point into Previous Camera and Project
+                const cv::Vec3f q = rotation * points[x] + translation;
+                if( q[2] <= 0.0f ){
+                    continue;
+                }
+
+                const int32_t u = static_cast<int32_t>( target.fx * q[0] / q[2] + target.cx + 0.5f );
+                const int32_t v = static_cast<int32_t>( target.fy * q[1] / q[2] + target.cy + 0.5f );
+                if( u < 0 || v < 0 || u >= target.points.cols || v >= target.points.rows ){
+                    continue;
+                }
+
+                // Pair (point and normal of previous frame)
+                const cv::Vec3f& p = target.points.at<cv::Vec3f>( v, u );
+                const cv::Vec3f& n = target.normals.at<cv::Vec3f>( v, u );
+                if( p[2] <= 0.0f || ( n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f ) ){
+                    continue;
+                }
+
+                const cv::Vec3f difference = q - p;
+                if( difference.dot( difference ) > max_distance ){
+                    continue;
+                }
+
+                // Point-to-Plane Residual and Jacobian ( d/dw = q x n, d/dt = n )
+                const float r = n.dot( difference );
+                const cv::Vec3f c = q.cross( n );
+                const float j[6] = { c[0], c[1], c[2], n[0], n[1], n[2] };
+                const float w = ( std::abs( r ) <= huber ) ? 1.0f : huber / std::abs( r );
+
+                // Accumulate Upper Triangle
+                for( int32_t row = 0, k = 0; row < 6; row++ ){
+                    const float wj = w * j[row];
+                    for( int32_t column = row; column < 6; column++, k++ ){
+                        local.a[k] += wj * j[column];
+                    }
+                    local.b[row] += wj * r;
+                }
+                local.error += w * r * r;
+                local.count++;
+            }
+        }
+
+        // Reduce
+        std::lock_guard<std::mutex> lock( mutex );
+        for( int32_t k = 0; k < 21; k++ ){
+            result.a[k] += local.a[k];
+        }
+        for( int32_t k = 0; k < 6; k++ ){
+            result.b[k] += local.b[k];
+        }
+        result.error += local.error;
+        result.count += local.count;
+    } );
+}
@@ -0,0 +1,113 @@
+#ifndef __ODOMETRY__
+#define __ODOMETRY__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+
+/*
+ This is frame-to-frame point-to-plane ICP odometry on organized point cloud of depth camera.
+
+ odometry odometry( calibration.depth_camera_calibration );
+ odometry.track( xyz ); // CV_16SC3 point cloud from depth_image_to_point_cloud (depth camera)
+ cv::Affine3d pose = odometry.get_pose(); // current camera to first camera [mm]
+
+ Correspondence is found by projective data association, point of current frame is transformed by current estimate
+ and projected into previous frame with pinhole intrinsics, point and normal at that pixel are its pair.
+ Alignment runs coarse-to-fine on pyramid of subsampled clouds.
+ Normal equations of ( rotation, translation ) increment are accumulated over rows in parallel (cv::parallel_for_),
+ fixed size accumulation of each point is written so that compiler can vectorize it.
+*/
+
+class odometry
+{
+public:
+    // Parameters
+    struct parameters
+    {
+        std::vector<int32_t> iterations; // from finest to coarsest level
+        float max_distance;              // max distance of pair [mm]
+        float huber;                     // huber threshold of point-to-plane residual [mm]
+        float min_inlier_ratio;          // min ratio of pairs on finest level to accept estimate
+
+        parameters()
+            : iterations( { 10, 5, 4 } ),
+              max_distance( 100.0f ),
+              huber( 10.0f ),
+              min_inlier_ratio( 0.1f )
+        {
+        }
+    };
+
+private:
+    // Level of Pyramid
+    struct level
+    {
+        cv::Mat points;  // CV_32FC3 [mm]
+        cv::Mat normals; // CV_32FC3 (zero is invalid)
+        float fx, fy, cx, cy;
+    };
+
+    // Normal Equations (upper triangle of 6x6 matrix)
+    struct system
+    {
+        double a[21];
+        double b[6];
+        double error;
+        uint64_t count;
+    };
+
+    // Parameters and Intrinsics
+    parameters params;
+    float fx, fy, cx, cy;
+
+    // Pyramids of Previous and Current Frame
+    std::vector<level> previous;
+    std::vector<level> current;
+
+    // Pose
+    cv::Affine3d pose;
+    cv::Affine3d motion;
+
+    // Statistics
+    uint64_t frames;
+    uint64_t lost_frames;
+    double inlier_ratio;
+
+public:
+    // Constructor
+    odometry( const k4a_calibration_camera_t& camera, const parameters& params = parameters() );
+
+    // Track Frame (returns false if frame could not be aligned, pose is kept then)
+    bool track( const cv::Mat& xyz );
+
+    // Reset Pose
+    void reset();
+
+    // Get Pose (current camera to first camera) [mm]
+    cv::Affine3d get_pose() const { return pose; }
+
+    // Get Motion of Last Frame (current camera to previous camera) [mm]
+    cv::Affine3d get_motion() const { return motion; }
+
+    // Get Statistics
+    uint64_t get_frames() const { return frames; }
+    uint64_t get_lost_frames() const { return lost_frames; }
+    double get_inlier_ratio() const { return inlier_ratio; }
+
+private:
+    // Build Pyramid
+    void build( const cv::Mat& xyz, std::vector<level>& pyramid ) const;
+
+    // Compute Normals
+    static void compute_normals( level& target );
+
+    // Align Current Frame to Previous Frame
+    bool align( cv::Affine3d& estimate );
+
+    // Accumulate Normal Equations
+    void accumulate( const level& source, const level& target, const cv::Affine3d& estimate, system& result ) const;
+};
+
+#endif // __ODOMETRY__
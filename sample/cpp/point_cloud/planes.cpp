@@ -0,0 +1,258 @@
+#include "planes.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+plane_segmentation::plane_segmentation( const parameters& params )
+    : params( params ),
+      valid_points( 0 ),
+      random( 5489u )
+{
+}
+
+// Segment Planes
+const std::vector<plane_segmentation::plane>& plane_segmentation::segment( const cv::Mat& xyz )
+{
+    CV_Assert( xyz.type() == CV_16SC3 );
+
+    // Collect Subsampled Valid Points
+    collect( xyz );
+
+    std::swap( previous, planes );
+    planes.clear();
+    if( !valid_points ){
+        return planes;
+    }
+
+    // Refine Planes of Previous Frame
+    const float min_cos = std::cos( params.max_angle * static_cast<float>( CV_PI ) / 180.0f );
+    for( const plane& last : previous ){
+        plane result;
+        const cv::Vec4f coefficients( last.normal[0], last.normal[1], last.normal[2], last.distance );
+        if( !fit( coefficients, result ) || result.normal.dot( last.normal ) < min_cos ){
+            continue;
+        }
+
+        result.refined = true;
+        planes.push_back( result );
+        remove_inliers( result );
+    }
+
+    // Search New Planes with RANSAC
+    while( planes.size() < params.max_planes ){
+        plane result;
+        if( !search( result ) ){
+            break;
+        }
+
+        result.refined = false;
+        planes.push_back( result );
+        remove_inliers( result );
+    }
+
+    return planes;
+}
+
+// Find Floor
+int32_t plane_segmentation::find_floor( const cv::Vec3f& up, const float max_angle ) const
+{
+    const float min_cos = std::cos( max_angle * static_cast<float>( CV_PI ) / 180.0f );
+    int32_t floor = -1;
+    float max_height = 0.0f;
+    for( size_t i = 0; i < planes.size(); i++ ){
+        // Normal towards Camera must be Up
+        if( planes[i].normal.dot( up ) < min_cos ){
+            continue;
+        }
+
+        // Lowest Plane (camera is above by distance)
+        if( floor < 0 || planes[i].distance > max_height ){
+            floor = static_cast<int32_t>( i );
+            max_height = planes[i].distance;
+        }
+    }
+    return floor;
+}
+
+// Get Level Transform
+cv::Affine3d plane_segmentation::get_level_transform( const plane& floor )
+{
+    // Axes of Level Coordinate System in Camera Frame ( y is normal, z is camera forward projected onto plane )
+    const cv::Vec3d y( floor.normal[0], floor.normal[1], floor.normal[2] );
+    cv::Vec3d z = cv::Vec3d( 0.0, 0.0, 1.0 ) - y * y[2];
+    const double length = cv::norm( z );
+    z = ( length > 1e-6 ) ? z * ( 1.0 / length ) : cv::Vec3d( 1.0, 0.0, 0.0 ).cross( y );
+    const cv::Vec3d x = y.cross( z );
+
+    // Foot of Camera on Plane
+    const cv::Vec3d foot = y * -static_cast<double>( floor.distance );
+
+    const cv::Matx33d rotation( x[0], x[1], x[2],
+                                y[0], y[1], y[2],
+                                z[0], z[1], z[2] );
+    return cv::Affine3d( rotation, rotation * foot * -1.0 );
+}
+
+// Collect Subsampled Valid Points
+void plane_segmentation::collect( const cv::Mat& xyz )
+{
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    for( int32_t y = 0; y < xyz.rows; y += params.step ){
+        const cv::Vec3s* row = xyz.ptr<cv::Vec3s>( y );
+        for( int32_t x = 0; x < xyz.cols; x += params.step ){
+            if( row[x][2] <= 0 ){
+                continue;
+            }
+            xs.push_back( row[x][0] );
+            ys.push_back( row[x][1] );
+            zs.push_back( row[x][2] );
+        }
+    }
+    valid_points = zs.size();
+}
+
+// Count Inliers
+uint64_t plane_segmentation::count_inliers( const cv::Vec4f& coefficients ) const
+{
+    // Branch-free Loop (vectorized by compiler)
+    const float a = coefficients[0], b = coefficients[1], c = coefficients[2], d = coefficients[3];
+    const float threshold = params.threshold;
+    const float* x = xs.data();
+    const float* y = ys.data();
+    const float* z = zs.data();
+    const size_t size = zs.size();
+    uint32_t count = 0;
+    for( size_t i = 0; i < size; i++ ){
+        count += ( std::abs( a * x[i] + b * y[i] + c * z[i] + d ) < threshold ) ? 1u : 0u;
+    }
+    return count;
+}
+
+// Fit Plane to Inliers
+bool plane_segmentation::fit( const cv::Vec4f& coefficients, plane& result ) const
+{
+    cv::Vec4f current = coefficients;
+    const uint64_t min_inliers = static_cast<uint64_t>( params.min_inlier_ratio * valid_points );
+
+    // Refit Twice (inliers of refined plane are slightly different)
+    for( int32_t iteration = 0; iteration < 2; iteration++ ){
+        // Centroid and Covariance of Inliers
+        cv::Vec3d sum( 0.0, 0.0, 0.0 );
+        cv::Matx33d products = cv::Matx33d::zeros();
+        uint64_t count = 0;
+        for( size_t i = 0; i < zs.size(); i++ ){
+            if( std::abs( current[0] * xs[i] + current[1] * ys[i] + current[2] * zs[i] + current[3] ) >= params.threshold ){
+                continue;
+            }
+            const cv::Vec3d p( xs[i], ys[i], zs[i] );
+            sum += p;
+            products = products + p * p.t();
+            count++;
+        }
+
+        if( count < std::max<uint64_t>( 3, min_inliers ) ){
+            return false;
+        }
+
+        const cv::Vec3d centroid = sum * ( 1.0 / count );
+        const cv::Matx33d covariance = products * ( 1.0 / count ) - centroid * centroid.t();
+
+        // Normal is Eigenvector of Smallest Eigenvalue (eigenvectors are sorted by descending eigenvalues)
+        cv::Mat eigenvalues, eigenvectors;
+        cv::eigen( covariance, eigenvalues, eigenvectors );
+        cv::Vec3d normal( eigenvectors.at<double>( 2, 0 ), eigenvectors.at<double>( 2, 1 ), eigenvectors.at<double>( 2, 2 ) );
+        double distance = -normal.dot( centroid );
+
+        // Orient towards Camera
+        if( distance < 0.0 ){
+            normal = normal * -1.0;
+            distance = -distance;
+        }
+
+        current = cv::Vec4f( static_cast<float>( normal[0] ), static_cast<float>( normal[1] ), static_cast<float>( normal[2] ), static_cast<float>( distance ) );
+        result.normal = cv::Vec3f( current[0], current[1], current[2] );
+        result.distance = current[3];
+        result.centroid = cv::Vec3f( static_cast<float>( centroid[0] ), static_cast<float>( centroid[1] ), static_cast<float>( centroid[2] ) );
+        result.inliers = count;
+        result.rms = static_cast<float>( std::sqrt( std::max( 0.0, eigenvalues.at<double>( 2 ) ) ) );
+    }
+
+    return true;
+}
+
+// Remove Inliers
+void plane_segmentation::remove_inliers( const plane& target )
+{
+    size_t size = 0;
+    for( size_t i = 0; i < zs.size(); i++ ){
+        const float distance = target.normal[0] * xs[i] + target.normal[1] * ys[i] + target.normal[2] * zs[i] + target.distance;
+        if( std::abs( distance ) < params.threshold ){
+            continue;
+        }
+        xs[size] = xs[i];
+        ys[size] = ys[i];
+        zs[size] = zs[i];
+        size++;
+    }
+    xs.resize( size );
+    ys.resize( size );
+    zs.resize( size );
+}
+
+// Search Plane with RANSAC
+bool plane_segmentation::search( plane& result )
+{
+    const size_t size = zs.size();
+    const uint64_t min_inliers = static_cast<uint64_t>( params.min_inlier_ratio * valid_points );
+    if( size < 3 || size < min_inliers ){
+        return false;
+    }
+
+    std::uniform_int_distribution<size_t> distribution( 0, size - 1 );
+    cv::Vec4f best;
+    uint64_t best_inliers = 0;
+    uint32_t iterations = params.iterations;
+    for( uint32_t iteration = 0; iteration < iterations; iteration++ ){
+        // Hypothesis from 3 Random Points
+        const size_t i0 = distribution( random ), i1 = distribution( random ), i2 = distribution( random );
+        const cv::Vec3f p0( xs[i0], ys[i0], zs[i0] );
+        const cv::Vec3f p1( xs[i1], ys[i1], zs[i1] );
+        const cv::Vec3f p2( xs[i2], ys[i2], zs[i2] );
+        cv::Vec3f normal = ( p1 - p0 ).cross( p2 - p0 );
+        const float length = static_cast<float>( cv::norm( normal ) );
+        if( length < 1e-3f ){
+            continue;
+        }
+        normal = normal * ( 1.0f / length );
+        const cv::Vec4f coefficients( normal[0], normal[1], normal[2], -normal.dot( p0 ) );
+
+        // Count Inliers
+        const uint64_t inliers = count_inliers( coefficients );
+        if( inliers <= best_inliers ){
+            continue;
+        }
+
+        best = coefficients;
+        best_inliers = inliers;
+
+        // Adaptive Number of Iterations (99% probability to draw 3 inliers once)
+        // NOTE: Needed iterations grow far beyond uint32_t for low inlier ratio, so it is clamped in double before cast.
+        const double ratio = static_cast<double>( inliers ) / size;
+        const double cube = ratio * ratio * ratio;
+        if( cube >= 1.0 ){
+            break;
+        }
+        const double needed = std::log( 1.0 - 0.99 ) / std::log1p( -cube );
+        iterations = static_cast<uint32_t>( std::min<double>( params.iterations, std::ceil( needed ) ) );
+    }
+
+    if( best_inliers < std::max<uint64_t>( 3, min_inliers ) ){
+        return false;
+    }
+
+    // Refine with Least Squares
+    return fit( best, result );
+}
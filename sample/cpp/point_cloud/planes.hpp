@@ -0,0 +1,109 @@
+#ifndef __PLANES__
+#define __PLANES__
+
+#include <opencv2/opencv.hpp>
+
+#include <random>
+#include <vector>
+
+/*
+ This is plane segmentation of organized point cloud with RANSAC (floor and walls).
+
+ plane_segmentation segmentation;
+ const std::vector<plane_segmentation::plane>& planes = segmentation.segment( xyz ); // CV_16SC3 [mm]
+ const int32_t floor = segmentation.find_floor( up );                                  // up vector in camera frame
+
+ Points are subsampled into structure of arrays, so that inlier counting is branch-free loop that compiler can vectorize.
+ Planes of previous frame are refined first (inliers of previous plane -> least squares fit), RANSAC searches only
+ points that are not explained by them. Inliers of each accepted plane are removed before next plane is searched.
+ Plane is n.p + d = 0 with unit normal oriented towards camera (d > 0).
+*/
+
+class plane_segmentation
+{
+public:
+    // Plane
+    struct plane
+    {
+        cv::Vec3f normal;
+        float distance;     // d of n.p + d = 0 [mm]
+        cv::Vec3f centroid; // [mm]
+        uint64_t inliers;   // number of inliers (subsampled)
+        float rms;          // rms of point-to-plane distance of inliers [mm]
+        bool refined;       // refined from previous frame (false: found by RANSAC)
+    };
+
+    // Parameters
+    struct parameters
+    {
+        int32_t step;           // subsampling step of pixels
+        float threshold;        // inlier threshold [mm]
+        uint32_t iterations;    // max iterations of RANSAC
+        uint32_t max_planes;    // max number of planes
+        float min_inlier_ratio; // min ratio of inliers to valid points to accept plane
+        float max_angle;        // max change of normal to keep plane of previous frame [deg]
+
+        parameters()
+            : step( 4 ),
+              threshold( 15.0f ),
+              iterations( 300 ),
+              max_planes( 4 ),
+              min_inlier_ratio( 0.05f ),
+              max_angle( 10.0f )
+        {
+        }
+    };
+
+private:
+    parameters params;
+
+    // Points (structure of arrays, remaining points)
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+    size_t valid_points;
+
+    // Planes
+    std::vector<plane> planes;
+    std::vector<plane> previous;
+
+    // Random
+    std::mt19937 random;
+
+public:
+    // Constructor
+    plane_segmentation( const parameters& params = parameters() );
+
+    // Segment Planes
+    const std::vector<plane>& segment( const cv::Mat& xyz );
+
+    // Find Floor (plane facing up and farthest from camera along up, returns -1 if not found)
+    int32_t find_floor( const cv::Vec3f& up, const float max_angle = 15.0f ) const;
+
+    // Get Planes
+    const std::vector<plane>& get_planes() const { return planes; }
+
+    // Get Parameters
+    const parameters& get_parameters() const { return params; }
+
+    // Get Transform from Camera to Level Coordinate System on Plane (y is up, origin is foot of camera)
+    static cv::Affine3d get_level_transform( const plane& floor );
+
+private:
+    // Collect Subsampled Valid Points
+    void collect( const cv::Mat& xyz );
+
+    // Count Inliers
+    uint64_t count_inliers( const cv::Vec4f& coefficients ) const;
+
+    // Fit Plane to Inliers with Least Squares (returns false if too few inliers)
+    bool fit( const cv::Vec4f& coefficients, plane& result ) const;
+
+    // Remove Inliers
+    void remove_inliers( const plane& target );
+
+    // Search Plane with RANSAC
+    bool search( plane& result );
+};
+
+#endif // __PLANES__
@@ -0,0 +1,140 @@
+#ifndef __RING__
+#define __RING__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*
+ This is lock-free single producer single consumer ring buffer.
+
+ Producer : push() (returns false if ring is full)
+ Consumer : front() / pop() / pop( values, count )
+
+ Capacity is rounded up to power of two, indices are free-running and masked on access.
+ Each side caches index of the other side, so that shared index is loaded only when cached one runs out.
+*/
+
+template<typename type>
+class spsc_ring
+{
+private:
+    // Cache Line Size
+    static constexpr size_t cache_line = 64;
+
+    // Buffer
+    std::vector<type> buffer;
+    size_t mask;
+
+    // Consumer Index (written by consumer only)
+    char padding0[cache_line];
+    std::atomic<size_t> head;
+    size_t cached_tail;
+
+    // Producer Index (written by producer only)
+    char padding1[cache_line];
+    std::atomic<size_t> tail;
+    size_t cached_head;
+    char padding2[cache_line];
+
+public:
+    // Constructor
+    explicit spsc_ring( const size_t capacity )
+        : buffer( round_up( capacity ) ),
+          mask( buffer.size() - 1 ),
+          head( 0 ),
+          cached_tail( 0 ),
+          tail( 0 ),
+          cached_head( 0 )
+    {
+    }
+
+    // Push (Producer)
+    bool push( const type& value )
+    {
+        const size_t index = tail.load( std::memory_order_relaxed );
+        if( index - cached_head == buffer.size() ){
+            cached_head = head.load( std::memory_order_acquire );
+            if( index - cached_head == buffer.size() ){
+                return false;
+            }
+        }
+
+        buffer[index & mask] = value;
+        tail.store( index + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Peek Front (Consumer, returns nullptr if ring is empty)
+    const type* front()
+    {
+        const size_t index = head.load( std::memory_order_relaxed );
+        if( index == cached_tail ){
+            cached_tail = tail.load( std::memory_order_acquire );
+            if( index == cached_tail ){
+                return nullptr;
+            }
+        }
+
+        return &buffer[index & mask];
+    }
+
+    // Pop (Consumer)
+    bool pop( type& value )
+    {
+        const type* value_front = front();
+        if( !value_front ){
+            return false;
+        }
+
+        value = *value_front;
+        head.store( head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Pop Batch (Consumer, returns number of values)
+    size_t pop( type* values, const size_t count )
+    {
+        const size_t index = head.load( std::memory_order_relaxed );
+        if( cached_tail - index < count ){
+            cached_tail = tail.load( std::memory_order_acquire );
+        }
+
+        const size_t available = std::min( count, cached_tail - index );
+        for( size_t i = 0; i < available; i++ ){
+            values[i] = buffer[( index + i ) & mask];
+        }
+
+        head.store( index + available, std::memory_order_release );
+        return available;
+    }
+
+    // Get Size (approximate while other side is running)
+    size_t size() const
+    {
+        return tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire );
+    }
+
+    // Get Capacity
+    size_t capacity() const
+    {
+        return buffer.size();
+    }
+
+private:
+    // Round Up to Power of Two
+    static size_t round_up( const size_t capacity )
+    {
+        size_t size = 1;
+        while( size < capacity ){
+            size <<= 1;
+        }
+        return size;
+    }
+
+    spsc_ring( const spsc_ring& ) = delete;
+    spsc_ring& operator=( const spsc_ring& ) = delete;
+};
+
+#endif // __RING__
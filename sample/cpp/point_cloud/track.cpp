@@ -0,0 +1,93 @@
+#include "track.hpp"
+#include "odometry.hpp"
+
+#include <k4arecord/playback.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    // Write Pose in TUM Format
+    void write_pose( std::ofstream& stream, const std::chrono::microseconds timestamp, const cv::Affine3d& pose )
+    {
+        // Rotation Matrix to Quaternion
+        const cv::Matx33d r = pose.rotation();
+        const double w = std::sqrt( std::max( 0.0, 1.0 + r( 0, 0 ) + r( 1, 1 ) + r( 2, 2 ) ) ) * 0.5;
+        double x = std::sqrt( std::max( 0.0, 1.0 + r( 0, 0 ) - r( 1, 1 ) - r( 2, 2 ) ) ) * 0.5;
+        double y = std::sqrt( std::max( 0.0, 1.0 - r( 0, 0 ) + r( 1, 1 ) - r( 2, 2 ) ) ) * 0.5;
+        double z = std::sqrt( std::max( 0.0, 1.0 - r( 0, 0 ) - r( 1, 1 ) + r( 2, 2 ) ) ) * 0.5;
+        x = std::copysign( x, r( 2, 1 ) - r( 1, 2 ) );
+        y = std::copysign( y, r( 0, 2 ) - r( 2, 0 ) );
+        z = std::copysign( z, r( 1, 0 ) - r( 0, 1 ) );
+
+        // Translation [mm] to [m]
+        const cv::Vec3d t = pose.translation() * 0.001;
+        stream << std::fixed << std::setprecision( 6 ) << timestamp.count() / 1000000.0 << " "
+               << t[0] << " " << t[1] << " " << t[2] << " "
+               << x << " " << y << " " << z << " " << w << "\n";
+    }
+}
+
+// Track
+void track( const std::string& file, const std::string& trajectory )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    if( !playback.get_record_configuration().depth_track_enabled ){
+        throw k4a::error( "Failed to track (recording has no depth track)!" );
+    }
+
+    // Create Transformation and Odometry for Depth Camera
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+    odometry odometry( calibration.depth_camera_calibration );
+
+    // Open Trajectory File
+    std::ofstream stream( trajectory );
+    if( !stream ){
+        throw k4a::error( "Failed to open trajectory file!" );
+    }
+
+    double track_time = 0.0;
+    double max_track_time = 0.0;
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        // Transform Depth Image to Point Cloud
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+
+        // Track Frame
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        odometry.track( xyz );
+        const double time = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        track_time += time;
+        max_track_time = std::max( max_track_time, time );
+
+        // Write Pose
+        write_pose( stream, depth_image.get_device_timestamp(), odometry.get_pose() );
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( !odometry.get_frames() ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Report
+    const cv::Vec3d translation = odometry.get_pose().translation();
+    std::cout << "frames     : " << odometry.get_frames() << " (" << odometry.get_lost_frames() << " lost)" << std::endl;
+    std::cout << "track      : " << track_time / odometry.get_frames() << " ms/frame (max " << max_track_time << " ms)" << std::endl;
+    std::cout << "distance   : " << cv::norm( translation ) << " mm from origin" << std::endl;
+    std::cout << "trajectory : " << trajectory << std::endl;
+}
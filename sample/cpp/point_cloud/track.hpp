@@ -0,0 +1,10 @@
+#ifndef __TRACK__
+#define __TRACK__
+
+#include <string>
+
+// Track Recorded Depth Sequence with ICP Odometry and Write Trajectory
+// Trajectory is written in TUM format ( timestamp [s] tx ty tz [m] qx qy qz qw ) for each frame.
+void track( const std::string& file, const std::string& trajectory = "trajectory.txt" );
+
+#endif // __TRACK__
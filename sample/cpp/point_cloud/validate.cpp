@@ -0,0 +1,159 @@
+#include "validate.hpp"
+#include "motion.hpp"
+
+#include <k4arecord/playback.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Residual of Cloud against Depth Image
+    struct residual
+    {
+        double sum = 0.0;
+        uint64_t points = 0;
+        uint64_t inliers = 0;
+    };
+
+    // Accumulate Residual of Previous Cloud Rotated into Current Camera against Current Depth
+    // NOTE: Projection ignores lens distortion, which is small near center of NFOV image and same for both poses.
+    void accumulate( const cv::Mat& previous_xyz, const cv::Matx33f& relative, const cv::Mat& depth, const k4a_calibration_intrinsic_parameters_t& intrinsics, residual& result )
+    {
+        constexpr int32_t step = 4;
+        constexpr double max_residual = 100.0;
+        for( int32_t y = 0; y < previous_xyz.rows; y += step ){
+            const cv::Vec3s* row = previous_xyz.ptr<cv::Vec3s>( y );
+            for( int32_t x = 0; x < previous_xyz.cols; x += step ){
+                if( row[x][2] <= 0 ){
+                    continue;
+                }
+
+                // Rotate Point into Current Camera and Project
+                const cv::Vec3f point = relative * cv::Vec3f( row[x][0], row[x][1], row[x][2] );
+                if( point[2] <= 0.0f ){
+                    continue;
+                }
+
+                const int32_t u = static_cast<int32_t>( std::lround( intrinsics.param.fx * point[0] / point[2] + intrinsics.param.cx ) );
+                const int32_t v = static_cast<int32_t>( std::lround( intrinsics.param.fy * point[1] / point[2] + intrinsics.param.cy ) );
+                if( u < 0 || v < 0 || u >= depth.cols || v >= depth.rows ){
+                    continue;
+                }
+
+                const uint16_t z = depth.at<uint16_t>( v, u );
+                if( !z ){
+                    continue;
+                }
+
+                // Residual of Depth (outliers are counted but not averaged)
+                const double difference = std::abs( static_cast<double>( z ) - point[2] );
+                result.points++;
+                if( difference < max_residual ){
+                    result.sum += difference;
+                    result.inliers++;
+                }
+            }
+        }
+    }
+
+    // Report Residual
+    void report( const char* name, const residual& result )
+    {
+        std::cout << name << " : " << ( result.inliers ? result.sum / result.inliers : 0.0 ) << " mm mean residual"
+                  << ", " << ( result.points ? 100.0 * result.inliers / result.points : 0.0 ) << " % inliers" << std::endl;
+    }
+}
+
+// Validate
+void validate( const std::string& file, const bool rolling_shutter )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    if( !configuration.imu_track_enabled || !configuration.depth_track_enabled ){
+        throw k4a::error( "Failed to validate (recording has no depth or imu track)!" );
+    }
+
+    // Create Transformation and Motion Compensator for Depth Camera
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+    motion_compensator compensator( calibration, K4A_CALIBRATION_TYPE_DEPTH );
+    compensator.set_rolling_shutter( rolling_shutter );
+
+    // Read Captures and IMU Samples in Order of Device Timestamp
+    // NOTE: Playback handle is not thread-safe, so IMU samples are pulled on this thread instead of reader thread.
+    std::vector<imu::sample> batch;
+    batch.reserve( 256 );
+    imu::sample pending;
+    bool has_pending = playback.get_next_imu_sample( &pending );
+
+    cv::Mat xyz, compensated, previous_xyz;
+    cv::Matx33f previous_pose = cv::Matx33f::eye();
+    residual raw_residual, compensated_residual;
+    uint64_t frames = 0;
+    uint64_t empty_batches = 0;
+    double update_time = 0.0;
+    double apply_time = 0.0;
+
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        const k4a::image depth_image = capture.get_depth_image();
+        if( !depth_image.handle() ){
+            continue;
+        }
+
+        // Collect IMU Samples up to Depth Timestamp
+        batch.clear();
+        const uint64_t timestamp = static_cast<uint64_t>( depth_image.get_device_timestamp().count() );
+        while( has_pending && pending.gyro_timestamp_usec <= timestamp ){
+            batch.push_back( pending );
+            has_pending = playback.get_next_imu_sample( &pending );
+        }
+        if( batch.empty() ){
+            empty_batches++;
+        }
+
+        // Update Pose
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        compensator.update( batch );
+        update_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Transform Depth Image to Point Cloud and Apply Correction
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+        xyz = cv::Mat( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+        start = std::chrono::steady_clock::now();
+        compensator.apply( xyz, compensated );
+        apply_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Compare Previous Cloud with Current Depth (without and with rotation between frames)
+        const cv::Mat depth( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( depth_image.get_buffer() ), depth_image.get_stride_bytes() );
+        const cv::Matx33f pose = compensator.get_pose();
+        if( !previous_xyz.empty() ){
+            accumulate( previous_xyz, cv::Matx33f::eye(), depth, calibration.depth_camera_calibration.intrinsics.parameters, raw_residual );
+            accumulate( previous_xyz, pose.t() * previous_pose, depth, calibration.depth_camera_calibration.intrinsics.parameters, compensated_residual );
+        }
+
+        xyz.copyTo( previous_xyz );
+        previous_pose = pose;
+        frames++;
+    }
+
+    // Close Playback
+    playback.close();
+
+    if( !frames ){
+        std::cout << "no depth frames in " << file << std::endl;
+        return;
+    }
+
+    // Report
+    std::cout << "frames       : " << frames << " (" << empty_batches << " without imu samples)" << std::endl;
+    std::cout << "gyro bias    : " << compensator.get_still_samples() << " still samples" << std::endl;
+    std::cout << "update       : " << update_time / frames << " ms/frame" << std::endl;
+    std::cout << "apply        : " << apply_time / frames << " ms/frame" << ( rolling_shutter ? " (rolling shutter)" : "" ) << std::endl;
+    report( "uncompensated", raw_residual );
+    report( "compensated  ", compensated_residual );
+}
@@ -0,0 +1,10 @@
+#ifndef __VALIDATE__
+#define __VALIDATE__
+
+#include <string>
+
+// Validate Motion Compensation on Recorded Depth and IMU Tracks
+// Residual of previous cloud against current depth is reported without and with IMU rotation between frames.
+void validate( const std::string& file, const bool rolling_shutter = false );
+
+#endif // __VALIDATE__
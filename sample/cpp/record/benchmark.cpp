@@ -0,0 +1,224 @@
+#include "benchmark.hpp"
+#include "raw_capture.hpp"
+#include "profile.hpp"
+#include "results.hpp"
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+#include <k4arecord/record.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Synthetic Capture Source (new images for each capture like device)
+    class source
+    {
+    private:
+        raw::track tracks[3];
+        std::vector<uint8_t> pattern;
+        uint64_t frame;
+
+    public:
+        source( const k4a_device_configuration_t& configuration )
+            : frame( 0 )
+        {
+            uint64_t slot_bytes = 0;
+            raw_writer::get_tracks( configuration, tracks, &slot_bytes );
+            pattern.resize( std::max( { tracks[0].max_bytes, tracks[1].max_bytes, tracks[2].max_bytes } ) + 64 );
+            for( size_t i = 0; i < pattern.size(); i++ ){
+                pattern[i] = static_cast<uint8_t>( i * 31 );
+            }
+        }
+
+        // Get Bytes of Capture
+        uint64_t get_bytes() const
+        {
+            return static_cast<uint64_t>( tracks[0].max_bytes ) + tracks[1].max_bytes + tracks[2].max_bytes;
+        }
+
+        // Create Next Capture
+        k4a::capture next()
+        {
+            const std::chrono::microseconds timestamp( static_cast<int64_t>( frame++ * 66666 ) ); // 15 fps
+            k4a::capture capture = k4a::capture::create();
+            for( int32_t i = 0; i < 3; i++ ){
+                const raw::track& track = tracks[i];
+                if( !track.max_bytes ){
+                    continue;
+                }
+
+                k4a::image image = k4a::image::create( track.format, track.width, track.height, track.stride );
+                std::memcpy( image.get_buffer(), pattern.data() + ( frame % 64 ), track.max_bytes );
+                image.set_device_timestamp( timestamp );
+                switch( i )
+                {
+                    case 0:
+                        capture.set_color_image( image );
+                        break;
+                    case 1:
+                        capture.set_depth_image( image );
+                        break;
+                    default:
+                        capture.set_ir_image( image );
+                        break;
+                }
+            }
+            return capture;
+        }
+    };
+
+    // Report Result
+    void report( const std::string& name, const uint32_t frames, const uint64_t bytes, const std::chrono::steady_clock::duration time )
+    {
+        const double seconds = std::chrono::duration<double>( time ).count();
+        std::cout << name << " : " << frames << " captures, " << seconds << " s, " << bytes / ( 1024.0 * 1024.0 ) / seconds << " MB/s, "
+                  << frames / seconds << " fps (" << frames / seconds / 15.0 << "x real-time of 15 fps)" << std::endl;
+    }
+}
+
+// Benchmark Sustained Write of Synthetic Captures
+void benchmark_raw( const std::string& directory, const uint32_t frames )
+{
+    // Configuration of High Bandwidth Session
+    k4a_device_configuration_t configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    configuration.color_format     = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
+    configuration.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_2160P;
+    configuration.depth_mode       = k4a_depth_mode_t::K4A_DEPTH_MODE_WFOV_UNBINNED;
+    configuration.camera_fps       = k4a_fps_t::K4A_FRAMES_PER_SECOND_15;
+
+    source captures( configuration );
+    std::cout << "benchmark : " << captures.get_bytes() / ( 1024.0 * 1024.0 ) << " MB/capture, " << frames << " captures in " << directory << std::endl;
+
+    // k4a::record::write_capture() into MKV
+    {
+        const std::string file = directory + "/benchmark.mkv";
+        k4a::record record = k4a::record::create( file.c_str(), k4a::device(), configuration );
+        record.write_header();
+
+        std::chrono::steady_clock::duration time( 0 );
+        for( uint32_t i = 0; i < frames; i++ ){
+            const k4a::capture capture = captures.next();
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            record.write_capture( capture );
+            time += std::chrono::steady_clock::now() - start;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        record.flush();
+        record.close();
+        time += std::chrono::steady_clock::now() - start;
+
+        report( "k4a::record", frames, captures.get_bytes() * frames, time );
+        std::remove( file.c_str() );
+    }
+
+    // raw_writer into Raw File
+    {
+        const std::string file = directory + "/benchmark.k4araw";
+        const uint32_t seconds = frames / 15 + 1;
+        raw_writer writer;
+        writer.open( file, configuration, std::vector<uint8_t>(), raw_writer::options( seconds, 8 ) );
+
+        std::chrono::steady_clock::duration time( 0 );
+        for( uint32_t i = 0; i < frames; i++ ){
+            const k4a::capture capture = captures.next();
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            writer.push( capture, true );
+            time += std::chrono::steady_clock::now() - start;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        writer.close();
+        time += std::chrono::steady_clock::now() - start;
+
+        report( "raw_writer", frames, captures.get_bytes() * frames, time );
+        writer.report( std::cout );
+        std::remove( file.c_str() );
+    }
+}
+
+// Benchmark Builtin Recording Profiles on Recording
+void benchmark_profiles( const std::string& file )
+{
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    const uint32_t recorded_fps = recording_profile::get_fps( configuration.camera_fps );
+    std::cout << "benchmark : " << file << " (" << recorded_fps << " fps)" << std::endl;
+
+    for( const std::string& name : recording_profile::get_builtin_names() ){
+        recording_profile::settings settings = recording_profile::get_builtin( name );
+
+        // Skip Profile that needs Streams or Modes not in Recording
+        const bool needs_color = ( settings.streams & recording_profile::stream::color ) && settings.color_resolution != k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+        const bool matches_color = !needs_color || ( configuration.color_track_enabled && configuration.color_resolution == settings.color_resolution && configuration.color_format == settings.color_format );
+        const bool matches_depth = configuration.depth_mode == settings.depth_mode;
+        const uint32_t profile_fps = recording_profile::get_fps( settings.camera_fps );
+        if( !matches_color || !matches_depth || profile_fps > recorded_fps ){
+            std::cout << "profile " << name << " : skipped (streams, depth mode or frame rate are not in recording)" << std::endl;
+            continue;
+        }
+
+        // Emulate Frame Rate by Decimation
+        settings.decimation *= recorded_fps / profile_fps;
+        settings.camera_fps = configuration.camera_fps;
+        recording_profile profile( settings );
+
+        // Write Captures of Recording through Profile (and processed results into custom tracks)
+        const std::string output = file + "." + name + ".mkv";
+        result_recorder results;
+        {
+            k4a::record record = k4a::record::create( output.c_str(), k4a::device(), profile.get_record_configuration() );
+            profile.add_tracks( record );
+            const k4a::calibration calibration = playback.get_calibration();
+            if( settings.processed ){
+                results.add_tracks( record, calibration, profile_fps );
+            }
+            record.write_header();
+
+            std::mutex record_mutex;
+            if( settings.processed ){
+                results.start( record, record_mutex, calibration );
+            }
+
+            playback.seek_timestamp( std::chrono::microseconds( 0 ), K4A_PLAYBACK_SEEK_BEGIN );
+            k4a::capture capture;
+            while( playback.get_next_capture( &capture ) ){
+                bool written;
+                {
+                    std::lock_guard<std::mutex> lock( record_mutex );
+                    written = profile.write( record, capture );
+                }
+
+                // Playback is faster than device, wait for worker instead of dropping
+                if( written && settings.processed ){
+                    results.push( capture, true );
+                }
+            }
+
+            results.stop();
+            record.flush();
+            record.close();
+        }
+
+        // Report Bitrate, CPU Cost and Size of File
+        profile.report( std::cout );
+        if( settings.processed ){
+            results.report( std::cout );
+        }
+        if( !( settings.streams & recording_profile::stream::infrared ) && settings.depth_mode != k4a_depth_mode_t::K4A_DEPTH_MODE_OFF ){
+            std::cout << "  IR track is in file but empty (k4arecord creates it with depth, only track header is written)" << std::endl;
+        }
+        std::ifstream stream( output, std::ios::binary | std::ios::ate );
+        std::cout << "  file " << static_cast<double>( stream.tellg() ) / ( 1024.0 * 1024.0 ) << " MB (cpu includes playback)" << std::endl;
+        stream.close();
+        std::remove( output.c_str() );
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+#include <string>
+
+// Benchmark Sustained Write of Synthetic Captures (2160p BGRA, WFOV unbinned depth and infrared) into Directory
+// Same captures are written with k4a::record::write_capture() into MKV and with raw_writer into raw file.
+// Time of sink calls (write, push, flush and close) is measured, files are removed after benchmark.
+void benchmark_raw( const std::string& directory = ".", const uint32_t frames = 150 );
+
+// Benchmark Builtin Recording Profiles on Recording (recorded with full profile, MJPG 720p and NFOV unbinned recommended)
+// Each profile writes captures of recording into temporary MKV, reports bitrate, file size and cpu cost.
+// Frame rate of profile is emulated by decimation, profiles that need streams not in recording are skipped.
+// Processed results of "processed" profile are computed for every written capture (no drop, playback waits for worker).
+void benchmark_profiles( const std::string& file );
+
+#endif // __BENCHMARK__
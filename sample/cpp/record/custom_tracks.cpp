@@ -0,0 +1,163 @@
+#include "custom_tracks.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+// Constructor
+custom_track_writer::custom_track_writer()
+    : record( nullptr ),
+      record_mutex( nullptr ),
+      pending_bytes( 0 ),
+      max_bytes( 0 ),
+      stopping( false ),
+      error_logged( false ),
+      written( 0 ),
+      dropped( 0 ),
+      failed( 0 ),
+      written_bytes( 0 ),
+      batches( 0 ),
+      max_batch( 0 ),
+      lock_time( 0 )
+{
+}
+
+// Destructor
+custom_track_writer::~custom_track_writer()
+{
+    // Stop
+    stop();
+}
+
+// Add Video Track
+void custom_track_writer::add_video_track( k4a::record& record, const char* name, const track_format::video_format& format, const uint32_t fps )
+{
+    const std::vector<uint8_t> context = track_format::make_codec_context( format );
+
+    k4a_record_video_settings_t video_settings;
+    video_settings.width      = static_cast<uint64_t>( format.width );
+    video_settings.height     = static_cast<uint64_t>( format.height );
+    video_settings.frame_rate = fps;
+    record.add_custom_video_track( name, track_format::video_codec, context.data(), context.size(), &video_settings );
+}
+
+// Add Data Track
+void custom_track_writer::add_data_track( k4a::record& record, const char* name, const char* codec )
+{
+    // One Block per Frame (not high frequency data like IMU)
+    k4a_record_subtitle_settings_t subtitle_settings;
+    subtitle_settings.high_freq_data = false;
+    record.add_custom_subtitle_track( name, codec, nullptr, 0, &subtitle_settings );
+}
+
+// Start Writer
+void custom_track_writer::start( k4a::record& record, std::mutex& record_mutex, const size_t max_bytes )
+{
+    // Stop Previous Writer
+    stop();
+
+    this->record = &record;
+    this->record_mutex = &record_mutex;
+    this->max_bytes = max_bytes;
+    stopping = false;
+    error_logged = false;
+
+    // Start Writer Thread
+    writer = std::thread( &custom_track_writer::work, this );
+}
+
+// Stop Writer
+void custom_track_writer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    block_available.notify_all();
+
+    if( writer.joinable() ){
+        writer.join();
+    }
+}
+
+// Queue Block
+bool custom_track_writer::write( const char* track, const std::chrono::microseconds timestamp, std::vector<uint8_t>&& data )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( !writer.joinable() || stopping || pending_bytes + data.size() > max_bytes ){
+            dropped++;
+            return false;
+        }
+
+        pending_bytes += data.size();
+        pending.push_back( block{ track, timestamp, std::move( data ) } );
+    }
+    block_available.notify_one();
+    return true;
+}
+
+// Report Statistics
+void custom_track_writer::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    stream << "custom tracks : " << written << " blocks written (" << static_cast<double>( written_bytes ) / ( 1024.0 * 1024.0 ) << " MB), "
+           << dropped << " dropped (" << failed << " rejected by record), " << batches << " batches (max " << max_batch << "), "
+           << ( batches ? std::chrono::duration<double, std::milli>( lock_time ).count() / batches : 0.0 ) << " ms/batch in lock of record" << std::endl;
+}
+
+// Writer Loop
+void custom_track_writer::work()
+{
+    std::deque<block> batch;
+    while( true ){
+        // Take All Queued Blocks as Batch
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            block_available.wait( lock, [&](){ return stopping || !pending.empty(); } );
+            if( pending.empty() ){
+                return;
+            }
+
+            batch.swap( pending );
+            pending_bytes = 0;
+        }
+
+        // Write Batch with One Lock of Record
+        // NOTE: Exception can not cross thread boundary, rejected block is counted and writer keeps going.
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint64_t blocks = 0;
+        uint64_t bytes = 0;
+        uint64_t rejected = 0;
+        std::string message;
+        {
+            std::lock_guard<std::mutex> lock( *record_mutex );
+            for( block& target : batch ){
+                try{
+                    record->write_custom_track_data( target.track.c_str(), target.timestamp, target.data.data(), target.data.size() );
+                    blocks++;
+                    bytes += target.data.size();
+                }
+                catch( const k4a::error& exception ){
+                    rejected++;
+                    if( message.empty() ){
+                        message = std::string( exception.what() ) + " (track " + target.track + ")";
+                    }
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock( mutex );
+        if( !message.empty() && !error_logged ){
+            std::cerr << message << ", later rejected blocks are counted only" << std::endl;
+            error_logged = true;
+        }
+        written += blocks;
+        written_bytes += bytes;
+        dropped += rejected;
+        failed += rejected;
+        batches++;
+        max_batch = std::max( max_batch, static_cast<uint32_t>( batch.size() ) );
+        lock_time += std::chrono::steady_clock::now() - start;
+        batch.clear();
+    }
+}
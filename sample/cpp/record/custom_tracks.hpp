@@ -0,0 +1,105 @@
+#ifndef __CUSTOM_TRACKS__
+#define __CUSTOM_TRACKS__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+
+#include "track_format.hpp"
+
+/*
+ This is writer of custom tracks that writes processed results into recording in batches on its own thread.
+
+ custom_track_writer writer;
+ writer.add_video_track( record, track_format::depth_filtered, { 640, 576, 16, track_format::make_fourcc( "b16g" ) }, 30 ); // before write_header()
+ writer.add_data_track( record, track_format::body_joints, track_format::joints_codec );
+ record.write_header();
+ writer.start( record, record_mutex );
+ writer.write( track_format::body_joints, timestamp, std::move( block ) ); // any thread, never waits for disk
+ writer.stop();                                                             // before record.close()
+
+ Writer thread takes all queued blocks and writes them with one lock of record mutex (record is shared with thread
+ that writes captures, k4a::record is not used from two threads at once).
+ k4arecord can not write blocks older than clusters that are already written (about 2 s), so queue is bounded by
+ max bytes, and blocks are dropped instead of waiting if writer falls behind.
+ Block that k4arecord rejects (e.g. older than written cluster) is counted as dropped and writer keeps going,
+ first error is logged.
+*/
+
+class custom_track_writer
+{
+private:
+    // Block
+    struct block
+    {
+        std::string track;
+        std::chrono::microseconds timestamp;
+        std::vector<uint8_t> data;
+    };
+
+    // Record
+    k4a::record* record;
+    std::mutex* record_mutex;
+
+    // Writer
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable block_available;
+    std::deque<block> pending;
+    size_t pending_bytes;
+    size_t max_bytes;
+    bool stopping;
+    bool error_logged;
+
+    // Statistics
+    uint64_t written;
+    uint64_t dropped;
+    uint64_t failed; // blocks rejected by k4arecord
+    uint64_t written_bytes;
+    uint64_t batches;
+    uint32_t max_batch;
+    std::chrono::steady_clock::duration lock_time;
+
+public:
+    // Constructor
+    custom_track_writer();
+
+    // Destructor
+    ~custom_track_writer();
+
+    custom_track_writer( const custom_track_writer& ) = delete;
+    custom_track_writer& operator=( const custom_track_writer& ) = delete;
+
+    // Add Video Track (before write_header)
+    static void add_video_track( k4a::record& record, const char* name, const track_format::video_format& format, const uint32_t fps );
+
+    // Add Data Track (before write_header)
+    static void add_data_track( k4a::record& record, const char* name, const char* codec );
+
+    // Start Writer (after write_header)
+    void start( k4a::record& record, std::mutex& record_mutex, const size_t max_bytes = 64 * 1024 * 1024 );
+
+    // Stop Writer (writes queued blocks, before close of record)
+    void stop();
+
+    // Queue Block (returns false if block is dropped)
+    bool write( const char* track, const std::chrono::microseconds timestamp, std::vector<uint8_t>&& data );
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Writer Loop
+    void work();
+};
+
+#endif // __CUSTOM_TRACKS__
@@ -1,14 +1,22 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <iostream>
 #include <ostream>
 
 // Constructor
-kinect::kinect( const uint32_t index )
-    : device_index( index )
+kinect::kinect( const uint32_t index, const record_mode mode, const recording_profile::settings& profile, const ring_recorder::options& ring_options, const segment_recorder::options& segment_options, const raw_writer::options& raw_options )
+    : device_index( index ),
+      mode( mode ),
+      profile( profile ),
+      ring_options( ring_options ),
+      motion_trigger( false ),
+      segment_options( segment_options ),
+      raw_options( raw_options )
 {
     // Initialize
     initialize();
@@ -27,7 +35,21 @@ void kinect::initialize()
     initialize_sensor();
 
     // Initialize Record
-    initialize_record();
+    switch( mode )
+    {
+        case record_mode::trigger:
+            initialize_ring();
+            break;
+        case record_mode::segment:
+            initialize_segments();
+            break;
+        case record_mode::raw:
+            initialize_raw();
+            break;
+        default:
+            initialize_record();
+            break;
+    }
 }
 
 // Initialize Sensor
@@ -42,20 +64,24 @@ inline void kinect::initialize_sensor()
     // Open Device
     device = k4a::device::open( device_index );
 
-    // Start Cameras with Configuration
-    device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
-    device_configuration.color_format             = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG;
-    device_configuration.color_resolution         = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
-    device_configuration.depth_mode               = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
-    device_configuration.synchronized_images_only = true;
-    device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    // Start Cameras with Configuration of Profile
+    device_configuration = profile.get_device_configuration();
+    if( mode == record_mode::raw ){
+        // High Bandwidth Session (uncompressed color is written as is)
+        device_configuration.color_format     = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
+        device_configuration.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_2160P;
+        device_configuration.depth_mode       = k4a_depth_mode_t::K4A_DEPTH_MODE_WFOV_UNBINNED;
+        device_configuration.camera_fps       = k4a_fps_t::K4A_FRAMES_PER_SECOND_15;
+    }
     device.start_cameras( &device_configuration );
+
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
 }
 
-// Initialize Record
-inline void kinect::initialize_record()
+// Generate Record Name from Date (YYYY_MM_DD_hhmmss)
+std::string kinect::generate_record_name()
 {
-    // Generate Record File Name from Date (YYYY_MM_DD_hhmmss)
     const std::chrono::system_clock::time_point time_point = std::chrono::system_clock::now();
     const std::time_t time = std::chrono::system_clock::to_time_t( time_point );
     const tm tm = *localtime( &time );
@@ -67,24 +93,114 @@ inline void kinect::initialize_record()
         << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_hour
         << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_min
         << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_sec;
+    return oss.str();
+}
 
+// Initialize Record
+inline void kinect::initialize_record()
+{
     // Create Record
-    record_file = "./" + oss.str() + ".mkv";
-    record = k4a::record::create( record_file.generic_string().c_str(), device, device_configuration );
-    std::cout << record_file.generic_string().c_str() << std::endl;
+    record_file = "./" + generate_record_name() + ".mkv";
+    record = k4a::record::create( record_file.generic_string().c_str(), device, profile.get_record_configuration() );
+    std::cout << record_file.generic_string().c_str() << " (profile " << profile.get_settings().name << ")" << std::endl;
+
+    // Add Custom Tracks of Profile
+    profile.add_tracks( record );
+
+    // Add Custom Tracks of Processed Results
+    const recording_profile::settings& settings = profile.get_settings();
+    const k4a::calibration calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
+    if( settings.processed ){
+        results.add_tracks( record, calibration, recording_profile::get_fps( settings.camera_fps ) / settings.decimation );
+    }
 
     // Write Header
     record.write_header();
+
+    // Start Processing Results
+    if( settings.processed ){
+        results.start( record, record_mutex, calibration );
+    }
+}
+
+// Initialize Ring Record
+inline void kinect::initialize_ring()
+{
+    // Start Ring Recorder (records event on trigger)
+    ring.start( device, device_configuration, ring_options );
+    std::cout << "pre-trigger record : press 't' to trigger, 'm' to toggle motion trigger" << std::endl;
+}
+
+// Initialize Segment Record
+inline void kinect::initialize_segments()
+{
+    // Start Segment Recorder (files and manifest are named from date)
+    record_file = "./" + generate_record_name();
+    segments.start( device, device_configuration, record_file.generic_string(), segment_options );
+    std::cout << record_file.generic_string() << ".csv" << std::endl;
+}
+
+// Initialize Raw Record
+inline void kinect::initialize_raw()
+{
+    // Open Raw File (preallocated, calibration is stored for conversion to MKV)
+    record_file = "./" + generate_record_name() + ".k4araw";
+    raw_record.open( record_file.generic_string(), device_configuration, device.get_raw_calibration(), raw_options );
+    std::cout << record_file.generic_string() << std::endl;
 }
 
 // Finalize
 void kinect::finalize()
 {
-    // Flash Record
-    record.flush();
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    switch( mode )
+    {
+        case record_mode::trigger:
+            // Report Ring Record Statistics
+            ring.report( std::cout );
+
+            // Stop Ring Record (finishes current event)
+            ring.stop();
+            break;
+        case record_mode::segment:
+            // Report Segment Record Statistics
+            segments.report( std::cout );
+
+            // Stop Segment Record (finalizes all segments)
+            segments.stop();
+            break;
+        case record_mode::raw:
+            // Close Raw Record (writes header and index)
+            try{
+                raw_record.close();
+            }
+            catch( const k4a::error& error ){
+                std::cout << error.what() << std::endl;
+            }
+
+            // Report Raw Record Statistics
+            raw_record.report( std::cout );
+            break;
+        default:
+            // Stop Processing Results (writes remaining results before record is closed)
+            if( profile.get_settings().processed ){
+                results.stop();
+                results.report( std::cout );
+            }
 
-    // Close Record
-    record.close();
+            // Report Bitrate and CPU Cost of Profile
+            profile.report( std::cout );
+
+            // Flash Record
+            record.flush();
+
+            // Close Record
+            record.close();
+            break;
+    }
 
     // Stop Cameras
     device.stop_cameras();
@@ -100,15 +216,27 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
-    while (true){
-        // Update
-        update();
+    bool updated = false;
+    while( true ){
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
 
-        // Draw
-        draw();
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
         constexpr int32_t delay = 1;
@@ -116,14 +244,26 @@ void kinect::run()
         if( key == 'q' ){
             break;
         }
+
+        // Trigger Pre-Trigger Record
+        if( mode == record_mode::trigger && key == 't' ){
+            ring.trigger( "key" );
+        }
+        if( mode == record_mode::trigger && key == 'm' ){
+            motion_trigger = !motion_trigger;
+            motion.reset();
+            std::cout << "motion trigger : " << ( motion_trigger ? "on" : "off" ) << std::endl;
+        }
     }
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Write Frame
     write_frame();
@@ -134,26 +274,69 @@ void kinect::update()
     // Update Depth
     update_depth();
 
+    // Detect Motion
+    detect_motion();
+
     // Release Capture Handle
     capture.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        throw k4a::error( "Failed to capture!" );
-    }
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
 }
 
 // Write Frame
 inline void kinect::write_frame()
 {
-    // Write Capture Frame
-    record.write_capture( capture );
+    switch( mode )
+    {
+        case record_mode::trigger:
+            // Keep Capture in Ring (written to file on trigger)
+            ring.push( capture );
+            break;
+        case record_mode::segment:
+            // Write Capture Frame to Current Segment
+            segments.write( capture );
+            break;
+        case record_mode::raw:
+            // Copy Capture Frame into Slot (dropped if all slots are in flight)
+            raw_record.push( capture );
+            break;
+        default:
+        {
+            // Write Capture Frame through Profile (decimate, drop streams, downsample color)
+            bool written;
+            {
+                std::lock_guard<std::mutex> lock( record_mutex );
+                written = profile.write( record, capture );
+            }
+
+            // Process Written Capture on Worker Thread (dropped if worker is busy)
+            if( written && profile.get_settings().processed ){
+                results.push( capture );
+            }
+            break;
+        }
+    }
+}
+
+// Detect Motion
+inline void kinect::detect_motion()
+{
+    if( mode != record_mode::trigger || !motion_trigger ){
+        return;
+    }
+
+    // Trigger Pre-Trigger Record by Motion in Depth
+    if( motion.detect( depth_image ) ){
+        ring.trigger( "motion" );
+    }
 }
 
 // Update Color
@@ -225,6 +408,11 @@ inline void kinect::show_color()
         return;
     }
 
+    // Draw Recording Indicator
+    if( mode == record_mode::trigger && ring.is_recording() ){
+        cv::circle( color, cv::Point( 30, 30 ), 15, cv::Scalar( 0, 0, 255, 255 ), cv::FILLED );
+    }
+
     // Show Image
     const cv::String window_name = cv::format( "color (kinect %d)", device_index );
     cv::imshow( window_name, color );
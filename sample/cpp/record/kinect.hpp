@@ -1,10 +1,21 @@
 #ifndef __KINECT__
 #define __KINECT__
 
+#include <mutex>
+
 #include <k4a/k4a.hpp>
 #include <k4arecord/record.hpp>
 #include <opencv2/opencv.hpp>
 
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "ring_recorder.hpp"
+#include "segment_recorder.hpp"
+#include "raw_capture.hpp"
+#include "profile.hpp"
+#include "results.hpp"
+#include "motion_detector.hpp"
+
 #if __has_include(<filesystem>)
 #include <filesystem>
 namespace filesystem = std::filesystem;
@@ -19,6 +30,16 @@ namespace filesystem = std::experimental::filesystem;
 
 class kinect
 {
+public:
+    // Record Mode
+    enum class record_mode
+    {
+        continuous, // one file for whole session
+        trigger,    // pre-trigger ring, one file per event
+        segment,    // files rolled over by duration or size
+        raw         // raw file (2160p BGRA, WFOV unbinned depth), converted to MKV later
+    };
+
 private:
     // Kinect
     k4a::device device;
@@ -26,7 +47,29 @@ private:
     k4a::capture capture;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
     filesystem::path record_file;
+    record_mode mode;
+    recording_profile profile;
+
+    // Processed Results (custom tracks share record with capture thread)
+    std::mutex record_mutex;
+    result_recorder results;
+
+    // Pre-Trigger Record
+    ring_recorder::options ring_options;
+    ring_recorder ring;
+    motion_detector motion;
+    bool motion_trigger;
+
+    // Segmented Record
+    segment_recorder::options segment_options;
+    segment_recorder segments;
+
+    // Raw Record
+    raw_writer::options raw_options;
+    raw_writer raw_record;
 
     // Color
     k4a::image color_image;
@@ -38,7 +81,7 @@ private:
 
 public:
     // Constructor
-    kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT, const record_mode mode = record_mode::continuous, const recording_profile::settings& profile = recording_profile::get_builtin( "full" ), const ring_recorder::options& ring_options = ring_recorder::options(), const segment_recorder::options& segment_options = segment_recorder::options(), const raw_writer::options& raw_options = raw_writer::options() );
 
     // Destructor
     ~kinect();
@@ -47,7 +90,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -65,15 +108,30 @@ private:
     // Initialize Record
     void initialize_record();
 
+    // Initialize Ring Record
+    void initialize_ring();
+
+    // Initialize Segment Record
+    void initialize_segments();
+
+    // Initialize Raw Record
+    void initialize_raw();
+
+    // Generate Record Name from Date (YYYY_MM_DD_hhmmss)
+    std::string generate_record_name();
+
     // Finalize
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Write Frame
     void write_frame();
 
+    // Detect Motion
+    void detect_motion();
+
     // Update Color
     void update_color();
 
@@ -1,14 +1,61 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "raw_capture.hpp"
+#include "benchmark.hpp"
 
 int main(int argc, char *argv[])
 {
     try
     {
-        kinect kinect;
-        kinect.run();
+        // Mode ( "continuous <profile> <decimation>", "profiles <mkv file>", "trigger <pre-roll [s]> <post-roll [s]> <max [MB]>", "segment <duration [s]> <max [MB]>",
+        //        "raw <length [s]> <buffers>", "convert <raw file> <mkv file>" or "benchmark <directory> <captures>" )
+        const std::string mode = ( argc > 1 ) ? argv[1] : "continuous";
+        if( mode == "trigger" ){
+            const uint32_t pre_seconds = ( argc > 2 ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 5;
+            const uint32_t post_seconds = ( argc > 3 ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 10;
+            const size_t max_mega_bytes = ( argc > 4 ) ? static_cast<size_t>( std::stoul( argv[4] ) ) : 512;
+            const ring_recorder::options ring_options( pre_seconds, post_seconds, max_mega_bytes * 1024 * 1024 );
+
+            kinect kinect( K4A_DEVICE_DEFAULT, kinect::record_mode::trigger, recording_profile::get_builtin( "full" ), ring_options );
+            kinect.run();
+        }
+        else if( mode == "segment" ){
+            const uint32_t seconds = ( argc > 2 ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 600;
+            const uint64_t mega_bytes = ( argc > 3 ) ? static_cast<uint64_t>( std::stoull( argv[3] ) ) : 0;
+            const segment_recorder::options segment_options( seconds, mega_bytes );
+
+            kinect kinect( K4A_DEVICE_DEFAULT, kinect::record_mode::segment, recording_profile::get_builtin( "full" ), ring_recorder::options(), segment_options );
+            kinect.run();
+        }
+        else if( mode == "raw" ){
+            const uint32_t seconds = ( argc > 2 ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 10;
+            const uint32_t buffers = ( argc > 3 ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 8;
+            const raw_writer::options raw_options( seconds, buffers );
+
+            kinect kinect( K4A_DEVICE_DEFAULT, kinect::record_mode::raw, recording_profile::get_builtin( "full" ), ring_recorder::options(), segment_recorder::options(), raw_options );
+            kinect.run();
+        }
+        else if( mode == "convert" && argc > 3 ){
+            convert_raw( argv[2], argv[3] );
+        }
+        else if( mode == "benchmark" ){
+            const std::string directory = ( argc > 2 ) ? argv[2] : ".";
+            const uint32_t frames = ( argc > 3 ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 150;
+            benchmark_raw( directory, frames );
+        }
+        else if( mode == "profiles" && argc > 2 ){
+            benchmark_profiles( argv[2] );
+        }
+        else{
+            recording_profile::settings profile = recording_profile::get_builtin( ( argc > 2 ) ? argv[2] : "full" );
+            profile.decimation = ( argc > 3 ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 1;
+
+            kinect kinect( K4A_DEVICE_DEFAULT, kinect::record_mode::continuous, profile );
+            kinect.run();
+        }
     }
     catch (const k4a::error &error)
     {
@@ -16,4 +63,4 @@ int main(int argc, char *argv[])
     }
 
     return 0;
-}
\ No newline at end of file
+}
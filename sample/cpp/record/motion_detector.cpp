@@ -0,0 +1,55 @@
+#include "motion_detector.hpp"
+
+#include <cstdlib>
+
+// Constructor
+motion_detector::motion_detector( const uint16_t threshold, const double ratio, const int32_t scale )
+    : threshold( threshold ),
+      ratio( ratio ),
+      scale( scale )
+{
+}
+
+// Detect Motion from Previous Depth Image
+bool motion_detector::detect( const k4a::image& depth_image )
+{
+    if( !depth_image.handle() ){
+        return false;
+    }
+
+    // Down-Sample Depth (without copy of full resolution image)
+    const cv::Mat depth( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( depth_image.get_buffer() ), depth_image.get_stride_bytes() );
+    cv::resize( depth, current, cv::Size( depth.cols / scale, depth.rows / scale ), 0.0, 0.0, cv::INTER_NEAREST );
+
+    if( previous.size() != current.size() ){
+        current.copyTo( previous );
+        return false;
+    }
+
+    // Count Changed Pixels (valid in both images)
+    int32_t valid = 0;
+    int32_t changed = 0;
+    for( int32_t y = 0; y < current.rows; y++ ){
+        const uint16_t* current_row = current.ptr<uint16_t>( y );
+        const uint16_t* previous_row = previous.ptr<uint16_t>( y );
+        for( int32_t x = 0; x < current.cols; x++ ){
+            if( !current_row[x] || !previous_row[x] ){
+                continue;
+            }
+
+            valid++;
+            if( std::abs( current_row[x] - previous_row[x] ) > threshold ){
+                changed++;
+            }
+        }
+    }
+
+    cv::swap( previous, current );
+    return valid && static_cast<double>( changed ) / valid > ratio;
+}
+
+// Reset Previous Depth Image
+void motion_detector::reset()
+{
+    previous.release();
+}
@@ -0,0 +1,39 @@
+#ifndef __MOTION_DETECTOR__
+#define __MOTION_DETECTOR__
+
+#include <cstdint>
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+/*
+ This is motion detector that compares depth image with previous one at low resolution.
+
+ motion_detector detector( 50, 0.02 ); // difference of depth [mm], ratio of changed pixels
+ if( detector.detect( depth_image ) ){ recorder.trigger( "motion" ); }
+
+ Depth is down-sampled by scale (nearest, no filtering) so that detection is cheap on capture thread.
+ Pixels that are invalid (0) in either image are ignored.
+*/
+
+class motion_detector
+{
+private:
+    uint16_t threshold;
+    double ratio;
+    int32_t scale;
+    cv::Mat previous;
+    cv::Mat current;
+
+public:
+    // Constructor
+    motion_detector( const uint16_t threshold = 50, const double ratio = 0.02, const int32_t scale = 8 );
+
+    // Detect Motion from Previous Depth Image
+    bool detect( const k4a::image& depth_image );
+
+    // Reset Previous Depth Image
+    void reset();
+};
+
+#endif // __MOTION_DETECTOR__
@@ -0,0 +1,294 @@
+#include "profile.hpp"
+
+#include <algorithm>
+
+#include <opencv2/opencv.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+    // Name of Custom Track for Downsampled Color
+    constexpr const char* scaled_color_track = "COLOR_SCALED";
+
+    // Get Size of Color Resolution
+    cv::Size get_color_size( const k4a_color_resolution_t resolution )
+    {
+        switch( resolution )
+        {
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P:  return cv::Size( 1280, 720 );
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1080P: return cv::Size( 1920, 1080 );
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1440P: return cv::Size( 2560, 1440 );
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1536P: return cv::Size( 2048, 1536 );
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_2160P: return cv::Size( 3840, 2160 );
+            case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_3072P: return cv::Size( 4096, 3072 );
+            default: return cv::Size();
+        }
+    }
+
+    // Get CPU Time of Process [ms] (all threads, std::clock is wall time on Windows)
+    double get_process_cpu_time()
+    {
+        #ifdef _WIN32
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        if( !GetProcessTimes( GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time ) ){
+            return 0.0;
+        }
+        const uint64_t kernel = ( static_cast<uint64_t>( kernel_time.dwHighDateTime ) << 32 ) | kernel_time.dwLowDateTime;
+        const uint64_t user   = ( static_cast<uint64_t>( user_time.dwHighDateTime ) << 32 ) | user_time.dwLowDateTime;
+        return ( kernel + user ) / 10000.0;
+        #else
+        timespec time;
+        clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &time );
+        return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+        #endif
+    }
+}
+
+// Constructor
+recording_profile::recording_profile( const settings& config )
+    : config( config ),
+      captures( 0 ),
+      written( 0 ),
+      bytes( 0 ),
+      first_timestamp( 0 ),
+      last_timestamp( 0 ),
+      process_time( 0 ),
+      start_cpu( 0.0 )
+{
+    this->config.decimation = std::max( this->config.decimation, 1u );
+
+    // Downsampled Color is Decoded with Reduced Scale of JPEG
+    if( this->config.color_scale > 1 ){
+        if( this->config.color_format != k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG ){
+            throw k4a::error( "Failed to create profile " + config.name + " (downsampled color requires MJPG)!" );
+        }
+        if( this->config.color_scale != 2 && this->config.color_scale != 4 && this->config.color_scale != 8 ){
+            throw k4a::error( "Failed to create profile " + config.name + " (scale of color must be 2, 4 or 8)!" );
+        }
+    }
+}
+
+// Get Builtin Profile
+recording_profile::settings recording_profile::get_builtin( const std::string& name )
+{
+    settings full;
+    full.name             = "full";
+    full.color_format     = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG;
+    full.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    full.depth_mode       = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    full.camera_fps       = k4a_fps_t::K4A_FRAMES_PER_SECOND_30;
+    full.streams          = stream::all;
+    full.decimation       = 1;
+    full.color_scale      = 1;
+    full.jpeg_quality     = 90;
+    full.processed        = false;
+
+    settings profile = full;
+    profile.name = name;
+    if( name == "full" ){
+        return profile;
+    }
+    else if( name == "depth" ){
+        profile.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+        profile.streams = stream::depth;
+    }
+    else if( name == "depth_ir" ){
+        profile.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+        profile.streams = stream::depth | stream::infrared;
+    }
+    else if( name == "color_half" ){
+        profile.streams = stream::color | stream::depth;
+        profile.color_scale = 2;
+        profile.jpeg_quality = 80;
+    }
+    else if( name == "low_rate" ){
+        profile.camera_fps = k4a_fps_t::K4A_FRAMES_PER_SECOND_5;
+    }
+    else if( name == "processed" ){
+        profile.processed = true;
+    }
+    else{
+        std::string names;
+        for( const std::string& builtin : get_builtin_names() ){
+            names += ( names.empty() ? "" : ", " ) + builtin;
+        }
+        throw k4a::error( "Failed to found profile \"" + name + "\" (" + names + ")!" );
+    }
+    return profile;
+}
+
+// Get Frames per Second
+uint32_t recording_profile::get_fps( const k4a_fps_t fps )
+{
+    switch( fps )
+    {
+        case k4a_fps_t::K4A_FRAMES_PER_SECOND_5:
+            return 5;
+        case k4a_fps_t::K4A_FRAMES_PER_SECOND_15:
+            return 15;
+        default:
+            return 30;
+    }
+}
+
+// Get Names of Builtin Profiles
+std::vector<std::string> recording_profile::get_builtin_names()
+{
+    return { "full", "depth", "depth_ir", "color_half", "low_rate", "processed" };
+}
+
+// Get Configuration of Device
+k4a_device_configuration_t recording_profile::get_device_configuration() const
+{
+    // Color is Disabled on Device if it is not Written
+    const bool has_color = ( config.streams & stream::color ) && config.color_resolution != k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+    const bool has_depth = ( config.streams & ( stream::depth | stream::infrared ) ) && config.depth_mode != k4a_depth_mode_t::K4A_DEPTH_MODE_OFF;
+
+    k4a_device_configuration_t configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    configuration.color_format             = config.color_format;
+    configuration.color_resolution         = has_color ? config.color_resolution : k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+    configuration.depth_mode               = has_depth ? config.depth_mode : k4a_depth_mode_t::K4A_DEPTH_MODE_OFF;
+    configuration.camera_fps               = config.camera_fps;
+    configuration.synchronized_images_only = has_color && has_depth;
+    configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    return configuration;
+}
+
+// Get Configuration of Record
+k4a_device_configuration_t recording_profile::get_record_configuration() const
+{
+    // Downsampled Color is Written into Custom Track instead of Color Track
+    k4a_device_configuration_t configuration = get_device_configuration();
+    if( config.color_scale > 1 ){
+        configuration.color_resolution = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF;
+    }
+    return configuration;
+}
+
+// Add Custom Tracks to Record
+void recording_profile::add_tracks( k4a::record& record ) const
+{
+    if( config.color_scale <= 1 || get_device_configuration().color_resolution == k4a_color_resolution_t::K4A_COLOR_RESOLUTION_OFF ){
+        return;
+    }
+
+    // Add Video Track of Downsampled Color (MJPG)
+    const cv::Size size = get_color_size( config.color_resolution );
+    k4a_record_video_settings_t video_settings;
+    video_settings.width      = static_cast<uint64_t>( size.width / config.color_scale );
+    video_settings.height     = static_cast<uint64_t>( size.height / config.color_scale );
+    video_settings.frame_rate = get_fps( config.camera_fps ) / config.decimation;
+    record.add_custom_video_track( scaled_color_track, "V_MJPEG", nullptr, 0, &video_settings );
+}
+
+// Write Capture through Profile
+bool recording_profile::write( k4a::record& record, const k4a::capture& capture )
+{
+    if( !captures ){
+        start_time = std::chrono::steady_clock::now();
+        start_cpu = get_process_cpu_time();
+    }
+
+    // Decimate Captures
+    if( captures++ % config.decimation ){
+        return false;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Keep Streams of Profile
+    k4a::capture output = k4a::capture::create();
+    std::chrono::microseconds timestamp( 0 );
+    bool has_image = false;
+    bool has_scaled = false;
+
+    const k4a::image color_image = capture.get_color_image();
+    if( color_image.handle() && ( config.streams & stream::color ) ){
+        timestamp = std::max( timestamp, color_image.get_device_timestamp() );
+        if( config.color_scale > 1 ){
+            const size_t scaled_bytes = write_scaled_color( record, color_image );
+            bytes += scaled_bytes;
+            has_scaled = scaled_bytes > 0;
+        }
+        else{
+            output.set_color_image( color_image );
+            bytes += color_image.get_size();
+            has_image = true;
+        }
+    }
+
+    const k4a::image depth_image = capture.get_depth_image();
+    if( depth_image.handle() && ( config.streams & stream::depth ) ){
+        timestamp = std::max( timestamp, depth_image.get_device_timestamp() );
+        output.set_depth_image( depth_image );
+        bytes += depth_image.get_size();
+        has_image = true;
+    }
+
+    const k4a::image ir_image = capture.get_ir_image();
+    if( ir_image.handle() && ( config.streams & stream::infrared ) ){
+        timestamp = std::max( timestamp, ir_image.get_device_timestamp() );
+        output.set_ir_image( ir_image );
+        bytes += ir_image.get_size();
+        has_image = true;
+    }
+
+    // Write Capture
+    if( has_image ){
+        record.write_capture( output );
+    }
+    process_time += std::chrono::steady_clock::now() - start;
+
+    // Count only Captures that wrote Anything (timestamps span written captures for bitrate)
+    if( !has_image && !has_scaled ){
+        return false;
+    }
+
+    if( !written ){
+        first_timestamp = timestamp;
+    }
+    last_timestamp = timestamp;
+    written++;
+    return true;
+}
+
+// Write Downsampled Color into Custom Track
+size_t recording_profile::write_scaled_color( k4a::record& record, const k4a::image& color_image ) const
+{
+    // Decode at Reduced Scale (IDCT of JPEG is done at 1/n, no resize)
+    const int32_t flag = ( config.color_scale == 8 ) ? cv::IMREAD_REDUCED_COLOR_8 : ( config.color_scale == 4 ) ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_COLOR_2;
+    const cv::Mat data( 1, static_cast<int32_t>( color_image.get_size() ), CV_8UC1, const_cast<uint8_t*>( color_image.get_buffer() ) );
+    const cv::Mat scaled = cv::imdecode( data, flag );
+    if( scaled.empty() ){
+        return 0;
+    }
+
+    // Encode and Write
+    std::vector<uint8_t> encoded;
+    cv::imencode( ".jpg", scaled, encoded, { cv::IMWRITE_JPEG_QUALITY, config.jpeg_quality } );
+    record.write_custom_track_data( scaled_color_track, color_image.get_device_timestamp(), encoded.data(), encoded.size() );
+    return encoded.size();
+}
+
+// Report Bitrate and CPU Cost
+void recording_profile::report( std::ostream& stream ) const
+{
+    const double seconds = std::chrono::duration<double>( last_timestamp - first_timestamp ).count();
+    const double wall = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    const double cpu = ( get_process_cpu_time() - start_cpu ) / 1000.0;
+    const double megabits = static_cast<double>( bytes ) * 8.0 / ( 1000.0 * 1000.0 );
+    const double rate = ( seconds > 0.0 ) ? megabits / seconds : 0.0;
+
+    stream << "profile " << config.name << " : " << written << " of " << captures << " captures written (decimation " << config.decimation << "), "
+           << static_cast<double>( bytes ) / ( 1024.0 * 1024.0 ) << " MB, " << rate << " Mbit/s (" << rate * 3600.0 / 8.0 / 1000.0 << " GB/hour), "
+           << ( written ? std::chrono::duration<double, std::milli>( process_time ).count() / written : 0.0 ) << " ms/capture processing, "
+           << ( captures && wall > 0.0 ? cpu / wall : 0.0 ) << " cores of process cpu" << std::endl;
+}
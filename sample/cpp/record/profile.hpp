@@ -0,0 +1,115 @@
+#ifndef __PROFILE__
+#define __PROFILE__
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+
+/*
+ This is recording profile that decides what device captures and what is written to recording.
+
+ recording_profile profile( recording_profile::get_builtin( "depth_ir" ) );
+ device.start_cameras( &profile.get_device_configuration() );
+ k4a::record record = k4a::record::create( file, device, profile.get_record_configuration() );
+ profile.add_tracks( record );         // before write_header()
+ record.write_header();
+ profile.write( record, capture );     // decimate, drop streams, downsample color
+ profile.report( std::cout );          // bitrate and cpu cost
+
+ full       : MJPG 720p color, NFOV unbinned depth and infrared, 30 fps
+ depth      : NFOV unbinned depth only (infrared is dropped), 30 fps
+ depth_ir   : NFOV unbinned depth and infrared, 30 fps
+ color_half : MJPG color decoded at 1/2 (640x360) and re-encoded into custom track COLOR_SCALED, depth, 30 fps
+ low_rate   : MJPG 720p color, NFOV unbinned depth and infrared, 5 fps
+ processed  : full, and processed results (filtered depth, bodies) into custom tracks (see results.hpp)
+
+ Streams that are not written are disabled on device if possible (color), otherwise dropped before write_capture().
+ Depth and infrared can not be disabled separately, k4arecord creates IR track with depth track, so recording of depth
+ profile has empty IR track (track header only, bitrate and size figures count no infrared).
+ Decimation writes every n-th capture (e.g. 30 fps device, decimation 3 is 10 fps recording).
+ Bitrate is bytes of written images per device time, cpu cost is process cpu time per wall time (includes writer
+ thread of k4arecord), processing time is time of write() per written capture.
+*/
+
+class recording_profile
+{
+public:
+    // Stream
+    enum stream : uint32_t
+    {
+        color = 1,
+        depth = 2,
+        infrared = 4,
+        all = color | depth | infrared
+    };
+
+    // Settings
+    struct settings
+    {
+        std::string name;
+        k4a_image_format_t color_format;
+        k4a_color_resolution_t color_resolution;
+        k4a_depth_mode_t depth_mode;
+        k4a_fps_t camera_fps;
+        uint32_t streams;     // streams that are written
+        uint32_t decimation;  // write every n-th capture
+        int32_t color_scale;  // 2, 4 or 8 writes MJPG color decoded at 1/n into custom track (1 is original color track)
+        int32_t jpeg_quality; // quality of re-encoded color
+        bool processed;       // write processed results into custom tracks
+    };
+
+private:
+    settings config;
+
+    // Statistics
+    uint64_t captures;
+    uint64_t written;
+    uint64_t bytes;
+    std::chrono::microseconds first_timestamp;
+    std::chrono::microseconds last_timestamp;
+    std::chrono::steady_clock::duration process_time;
+    std::chrono::steady_clock::time_point start_time;
+    double start_cpu; // [ms]
+
+public:
+    // Constructor
+    recording_profile( const settings& config = get_builtin( "full" ) );
+
+    // Get Builtin Profile
+    static settings get_builtin( const std::string& name );
+
+    // Get Names of Builtin Profiles
+    static std::vector<std::string> get_builtin_names();
+
+    // Get Frames per Second
+    static uint32_t get_fps( const k4a_fps_t fps );
+
+    // Get Settings
+    const settings& get_settings() const { return config; }
+
+    // Get Configuration of Device (what device captures)
+    k4a_device_configuration_t get_device_configuration() const;
+
+    // Get Configuration of Record (tracks that are written)
+    k4a_device_configuration_t get_record_configuration() const;
+
+    // Add Custom Tracks to Record (before write_header)
+    void add_tracks( k4a::record& record ) const;
+
+    // Write Capture through Profile (returns false if capture is decimated or has no image of profile)
+    bool write( k4a::record& record, const k4a::capture& capture );
+
+    // Report Bitrate and CPU Cost
+    void report( std::ostream& stream ) const;
+
+private:
+    // Write Downsampled Color into Custom Track
+    size_t write_scaled_color( k4a::record& record, const k4a::image& color_image ) const;
+};
+
+#endif // __PROFILE__
@@ -0,0 +1,580 @@
+#include "raw_capture.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Alignment of O_DIRECT (offset, size and address of buffer)
+    constexpr uint64_t alignment = 4096;
+
+    // Magic and Version of Raw File
+    constexpr char magic[8] = { 'K', '4', 'A', 'R', 'A', 'W', '0', '1' };
+    constexpr uint32_t version = 1;
+
+    // Align Size
+    uint64_t align( const uint64_t size )
+    {
+        return ( size + alignment - 1 ) / alignment * alignment;
+    }
+
+    // Get Size of Header Region (header + calibration)
+    uint64_t get_header_bytes( const uint32_t calibration_bytes )
+    {
+        return align( sizeof( raw::header ) + calibration_bytes );
+    }
+
+    // Get Frames per Second
+    uint32_t get_fps( const k4a_fps_t fps )
+    {
+        switch( fps )
+        {
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_5:
+                return 5;
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_15:
+                return 15;
+            default:
+                return 30;
+        }
+    }
+
+    // Get System Error Message
+    std::string get_system_error( const std::string& message )
+    {
+        return message + " (" + std::strerror( errno ) + ")!";
+    }
+
+    // Release Buffer of Image
+    void release_buffer( void* buffer, void* context )
+    {
+        delete[] static_cast<uint8_t*>( buffer );
+    }
+}
+
+// Constructor
+raw_writer::raw_writer()
+    : file_descriptor( -1 ),
+      direct( false ),
+      header(),
+      stopping( false ),
+      dropped( 0 ),
+      batches( 0 ),
+      max_batch( 0 ),
+      written_bytes( 0 ),
+      elapsed( 0 )
+{
+}
+
+// Destructor
+raw_writer::~raw_writer()
+{
+    // NOTE: Exception can not be thrown from destructor, error of close is reported here.
+    try{
+        close();
+    }
+    catch( const k4a::error& exception ){
+        std::cerr << exception.what() << std::endl;
+    }
+}
+
+// Get Layout of Tracks from Configuration
+void raw_writer::get_tracks( const k4a_device_configuration_t& configuration, raw::track* tracks, uint64_t* slot_bytes )
+{
+    // Color
+    int32_t width = 0;
+    int32_t height = 0;
+    switch( configuration.color_resolution )
+    {
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P:  width = 1280; height = 720;  break;
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1080P: width = 1920; height = 1080; break;
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1440P: width = 2560; height = 1440; break;
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_1536P: width = 2048; height = 1536; break;
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_2160P: width = 3840; height = 2160; break;
+        case k4a_color_resolution_t::K4A_COLOR_RESOLUTION_3072P: width = 4096; height = 3072; break;
+        default: break;
+    }
+
+    raw::track& color = tracks[0];
+    color = raw::track{ configuration.color_format, width, height, 0, 0, 0 };
+    switch( configuration.color_format )
+    {
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+            color.stride = width * 4;
+            color.max_bytes = color.stride * height;
+            break;
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+            color.stride = width * 2;
+            color.max_bytes = color.stride * height;
+            break;
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+            color.stride = width;
+            color.max_bytes = color.stride * height * 3 / 2;
+            break;
+        default:
+            // MJPG (larger frame than bound is dropped)
+            color.max_bytes = width * height * 2;
+            break;
+    }
+
+    // Depth and Infrared
+    width = 0;
+    height = 0;
+    switch( configuration.depth_mode )
+    {
+        case k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_2X2BINNED: width = 320;  height = 288;  break;
+        case k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED:  width = 640;  height = 576;  break;
+        case k4a_depth_mode_t::K4A_DEPTH_MODE_WFOV_2X2BINNED: width = 512;  height = 512;  break;
+        case k4a_depth_mode_t::K4A_DEPTH_MODE_WFOV_UNBINNED:  width = 1024; height = 1024; break;
+        case k4a_depth_mode_t::K4A_DEPTH_MODE_PASSIVE_IR:     width = 1024; height = 1024; break;
+        default: break;
+    }
+
+    const bool has_depth = configuration.depth_mode != k4a_depth_mode_t::K4A_DEPTH_MODE_PASSIVE_IR;
+    tracks[1] = raw::track{ k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16, width, height, width * 2, has_depth ? static_cast<uint32_t>( width * height * 2 ) : 0, 0 };
+    tracks[2] = raw::track{ k4a_image_format_t::K4A_IMAGE_FORMAT_IR16, width, height, width * 2, static_cast<uint32_t>( width * height * 2 ), 0 };
+
+    // Offsets in Slot (each image starts at 64 bytes boundary)
+    uint64_t offset = 0;
+    for( int32_t i = 0; i < 3; i++ ){
+        tracks[i].offset = static_cast<uint32_t>( offset );
+        offset += ( tracks[i].max_bytes + 63 ) / 64 * 64;
+    }
+    *slot_bytes = align( offset );
+}
+
+// Open Raw File
+void raw_writer::open( const std::string& file, const k4a_device_configuration_t& configuration, const std::vector<uint8_t>& calibration, const options& config )
+{
+    // Close Previous File
+    close();
+
+    #if defined( _WIN32 )
+    throw k4a::error( "Failed to open raw file (raw capture is supported only on Linux)!" );
+    #else
+    this->config = options( std::max( config.seconds, 1u ), std::max( config.depth, 1u ) );
+    this->calibration = calibration;
+
+    // Layout of File
+    header = raw::header();
+    std::memcpy( header.magic, magic, sizeof( magic ) );
+    header.version = version;
+    header.calibration_bytes = static_cast<uint32_t>( calibration.size() );
+    header.configuration = configuration;
+    get_tracks( configuration, header.tracks, &header.slot_bytes );
+    header.slot_count = static_cast<uint64_t>( this->config.seconds ) * get_fps( configuration.camera_fps );
+    header.data_offset = get_header_bytes( header.calibration_bytes ) + align( header.slot_count * sizeof( raw::entry ) );
+    header.frame_count = 0;
+    index.assign( header.slot_count, raw::entry() );
+
+    // Open File without Page Cache (file systems that do not support O_DIRECT fall back to buffered writes)
+    direct = true;
+    file_descriptor = ::open( file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644 );
+    if( file_descriptor < 0 && errno == EINVAL ){
+        direct = false;
+        file_descriptor = ::open( file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    }
+    if( file_descriptor < 0 ){
+        throw k4a::error( get_system_error( "Failed to open raw file " + file ) );
+    }
+
+    // Release File and Buffers on Failure
+    const auto fail = [&]( const std::string& message ){
+        for( uint8_t* buffer : buffers ){
+            free( buffer );
+        }
+        buffers.clear();
+        ::close( file_descriptor );
+        file_descriptor = -1;
+        throw k4a::error( message );
+    };
+
+    // Preallocate Slots
+    const uint64_t file_bytes = header.data_offset + header.slot_count * header.slot_bytes;
+    if( posix_fallocate( file_descriptor, 0, static_cast<off_t>( file_bytes ) ) != 0 ){
+        fail( "Failed to preallocate " + std::to_string( file_bytes / ( 1024 * 1024 ) ) + " MB for raw file " + file + "!" );
+    }
+
+    // Allocate Slot Buffers (aligned for O_DIRECT)
+    for( uint32_t i = 0; i < this->config.depth; i++ ){
+        void* buffer = nullptr;
+        if( posix_memalign( &buffer, alignment, header.slot_bytes ) != 0 ){
+            fail( "Failed to allocate slot buffer of raw file!" );
+        }
+        std::memset( buffer, 0, header.slot_bytes );
+        buffers.push_back( static_cast<uint8_t*>( buffer ) );
+    }
+    free_buffers = buffers;
+
+    #if defined( HAVE_LIBURING )
+    // Create Submission Queue
+    const int32_t result = io_uring_queue_init( this->config.depth, &ring, 0 );
+    if( result < 0 ){
+        errno = -result;
+        fail( get_system_error( "Failed to initialize io_uring" ) );
+    }
+    #endif
+
+    // Start Writer Thread
+    stopping = false;
+    error.clear();
+    dropped = 0;
+    batches = 0;
+    max_batch = 0;
+    written_bytes = 0;
+    start_time = std::chrono::steady_clock::now();
+    writer = std::thread( &raw_writer::write, this );
+    #endif
+}
+
+// Close Raw File
+void raw_writer::close()
+{
+    if( file_descriptor < 0 ){
+        return;
+    }
+
+    // Error of Writer or Finalization (thrown after buffers are released)
+    std::string message;
+
+    #if !defined( _WIN32 )
+    // Stop Writer (writes remaining slots)
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    slot_ready.notify_all();
+
+    writer.join();
+    elapsed = std::chrono::steady_clock::now() - start_time;
+
+    #if defined( HAVE_LIBURING )
+    io_uring_queue_exit( &ring );
+    #endif
+
+    // Write Header and Index, Truncate Unused Slots
+    message = error;
+    if( message.empty() ){
+        const uint64_t header_bytes = get_header_bytes( header.calibration_bytes );
+        void* buffer = nullptr;
+        if( posix_memalign( &buffer, alignment, header.data_offset ) == 0 ){
+            uint8_t* region = static_cast<uint8_t*>( buffer );
+            std::memset( region, 0, header.data_offset );
+            std::memcpy( region, &header, sizeof( raw::header ) );
+            if( !calibration.empty() ){
+                std::memcpy( region + sizeof( raw::header ), calibration.data(), calibration.size() );
+            }
+            std::memcpy( region + header_bytes, index.data(), header.frame_count * sizeof( raw::entry ) );
+
+            if( pwrite( file_descriptor, region, header.data_offset, 0 ) != static_cast<ssize_t>( header.data_offset ) ){
+                message = get_system_error( "Failed to write header of raw file" );
+            }
+            free( buffer );
+        }
+        else{
+            message = "Failed to allocate header of raw file!";
+        }
+
+        if( message.empty() && ftruncate( file_descriptor, static_cast<off_t>( header.data_offset + header.frame_count * header.slot_bytes ) ) != 0 ){
+            message = get_system_error( "Failed to truncate raw file" );
+        }
+    }
+
+    ::close( file_descriptor );
+    file_descriptor = -1;
+    #endif
+
+    // Release Buffers
+    for( uint8_t* buffer : buffers ){
+        free( buffer );
+    }
+    buffers.clear();
+    free_buffers.clear();
+    ready.clear();
+
+    // NOTE: Exception can not cross thread boundary, error of writer is thrown here.
+    if( !message.empty() ){
+        throw k4a::error( message );
+    }
+}
+
+// Push Capture
+bool raw_writer::push( const k4a::capture& capture, const bool wait )
+{
+    if( file_descriptor < 0 || !capture.handle() ){
+        return false;
+    }
+
+    // Get Free Buffer (capture thread does not wait for disk unless requested)
+    uint8_t* buffer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        if( !error.empty() ){
+            throw k4a::error( error );
+        }
+
+        if( header.frame_count >= header.slot_count ){
+            dropped++;
+            return false;
+        }
+
+        if( wait ){
+            buffer_available.wait( lock, [&](){ return !free_buffers.empty() || !error.empty(); } );
+        }
+        if( free_buffers.empty() ){
+            dropped++;
+            return false;
+        }
+
+        buffer = free_buffers.back();
+        free_buffers.pop_back();
+    }
+
+    // Copy Images into Slot
+    const k4a::image images[] = { capture.get_color_image(), capture.get_depth_image(), capture.get_ir_image() };
+    raw::entry entry = raw::entry();
+    for( int32_t i = 0; i < 3; i++ ){
+        const raw::track& track = header.tracks[i];
+        if( !images[i].handle() || !track.max_bytes ){
+            continue;
+        }
+
+        const size_t size = images[i].get_size();
+        if( size > track.max_bytes ){
+            std::lock_guard<std::mutex> lock( mutex );
+            free_buffers.push_back( buffer );
+            dropped++;
+            return false;
+        }
+
+        std::memcpy( buffer + track.offset, images[i].get_buffer(), size );
+        entry.timestamps[i] = images[i].get_device_timestamp().count();
+        entry.bytes[i] = static_cast<uint32_t>( size );
+    }
+
+    // Queue Slot to Writer
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        const uint64_t slot_index = header.frame_count++;
+        index[slot_index] = entry;
+        ready.push_back( slot{ slot_index, buffer } );
+    }
+    slot_ready.notify_one();
+    return true;
+}
+
+// Report Statistics
+void raw_writer::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    const double seconds = std::chrono::duration<double>( elapsed.count() ? elapsed : std::chrono::steady_clock::now() - start_time ).count();
+    stream << "raw writer : " << ( direct ? "O_DIRECT" : "buffered" ) << ", "
+           #if defined( HAVE_LIBURING )
+           << "io_uring, "
+           #else
+           << "pwrite, "
+           #endif
+           << header.slot_bytes / 1024 << " KB/slot, " << header.frame_count << " of " << header.slot_count << " slots, "
+           << dropped << " dropped, " << batches << " batches (max " << max_batch << "), "
+           << written_bytes / ( 1024.0 * 1024.0 ) / ( seconds > 0.0 ? seconds : 1.0 ) << " MB/s" << std::endl;
+}
+
+// Writer Loop
+void raw_writer::write()
+{
+    std::vector<slot> batch;
+    while( true ){
+        // Take All Ready Slots as Batch
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            slot_ready.wait( lock, [&](){ return stopping || !ready.empty(); } );
+            if( ready.empty() ){
+                return;
+            }
+
+            batch.assign( ready.begin(), ready.end() );
+            ready.clear();
+        }
+
+        // NOTE: Exception can not cross thread boundary, error is passed to capture thread.
+        try{
+            write_batch( batch );
+        }
+        catch( const k4a::error& exception ){
+            std::lock_guard<std::mutex> lock( mutex );
+            error = exception.what();
+        }
+
+        // Return Buffers
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            for( const slot& target : batch ){
+                free_buffers.push_back( target.buffer );
+            }
+            batches++;
+            max_batch = std::max( max_batch, static_cast<uint32_t>( batch.size() ) );
+        }
+        buffer_available.notify_all();
+    }
+}
+
+// Write Batch of Slots
+void raw_writer::write_batch( std::vector<slot>& batch )
+{
+    #if !defined( _WIN32 )
+    const auto get_offset = [&]( const slot& target ){
+        return static_cast<off_t>( header.data_offset + target.index * header.slot_bytes );
+    };
+
+    #if defined( HAVE_LIBURING )
+    // Submit All Writes of Batch at Once (batch is not larger than depth of queue)
+    for( const slot& target : batch ){
+        io_uring_sqe* sqe = io_uring_get_sqe( &ring );
+        io_uring_prep_write( sqe, file_descriptor, target.buffer, static_cast<unsigned>( header.slot_bytes ), get_offset( target ) );
+    }
+
+    int32_t result = io_uring_submit( &ring );
+    if( result < 0 ){
+        errno = -result;
+        throw k4a::error( get_system_error( "Failed to submit writes of raw file" ) );
+    }
+
+    // Wait Completions
+    std::string message;
+    for( size_t i = 0; i < batch.size(); i++ ){
+        io_uring_cqe* cqe = nullptr;
+        result = io_uring_wait_cqe( &ring, &cqe );
+        if( result < 0 ){
+            errno = -result;
+            throw k4a::error( get_system_error( "Failed to wait writes of raw file" ) );
+        }
+
+        if( cqe->res != static_cast<int32_t>( header.slot_bytes ) && message.empty() ){
+            errno = ( cqe->res < 0 ) ? -cqe->res : EIO;
+            message = get_system_error( "Failed to write slot of raw file" );
+        }
+        io_uring_cqe_seen( &ring, cqe );
+    }
+
+    if( !message.empty() ){
+        throw k4a::error( message );
+    }
+    #else
+    // Write Slots in Order
+    for( const slot& target : batch ){
+        if( pwrite( file_descriptor, target.buffer, header.slot_bytes, get_offset( target ) ) != static_cast<ssize_t>( header.slot_bytes ) ){
+            throw k4a::error( get_system_error( "Failed to write slot of raw file" ) );
+        }
+    }
+    #endif
+
+    std::lock_guard<std::mutex> lock( mutex );
+    written_bytes += batch.size() * header.slot_bytes;
+    #endif
+}
+
+// Convert Raw File to MKV
+void convert_raw( const std::string& raw_file, const std::string& mkv_file )
+{
+    #if defined( _WIN32 )
+    throw k4a::error( "Failed to open raw file (raw capture is supported only on Linux)!" );
+    #else
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Open Raw File
+    const int32_t file_descriptor = ::open( raw_file.c_str(), O_RDONLY );
+    if( file_descriptor < 0 ){
+        throw k4a::error( get_system_error( "Failed to open raw file " + raw_file ) );
+    }
+
+    // NOTE: File descriptor is closed on error too.
+    try{
+        // Read Header, Calibration and Index
+        raw::header header;
+        if( pread( file_descriptor, &header, sizeof( raw::header ), 0 ) != sizeof( raw::header ) || std::memcmp( header.magic, magic, sizeof( magic ) ) != 0 || header.version != version ){
+            throw k4a::error( "Failed to read header of raw file " + raw_file + "!" );
+        }
+
+        std::vector<uint8_t> calibration( header.calibration_bytes );
+        std::vector<raw::entry> index( header.frame_count );
+        const size_t index_bytes = index.size() * sizeof( raw::entry );
+        if( pread( file_descriptor, calibration.data(), calibration.size(), sizeof( raw::header ) ) != static_cast<ssize_t>( calibration.size() ) ||
+            pread( file_descriptor, index.data(), index_bytes, get_header_bytes( header.calibration_bytes ) ) != static_cast<ssize_t>( index_bytes ) ){
+            throw k4a::error( "Failed to read index of raw file " + raw_file + "!" );
+        }
+
+        // Create Record (calibration of device is restored from raw file)
+        k4a::record record = k4a::record::create( mkv_file.c_str(), k4a::device(), header.configuration );
+        if( !calibration.empty() ){
+            record.add_tag( "K4A_CALIBRATION_FILE", "calibration.json" );
+            record.add_attachment( "calibration.json", calibration.data(), calibration.size() );
+        }
+        record.write_header();
+
+        // Convert Slots to Captures
+        std::vector<uint8_t> slot( header.slot_bytes );
+        for( uint64_t i = 0; i < header.frame_count; i++ ){
+            const off_t offset = static_cast<off_t>( header.data_offset + i * header.slot_bytes );
+            if( pread( file_descriptor, slot.data(), slot.size(), offset ) != static_cast<ssize_t>( slot.size() ) ){
+                throw k4a::error( "Failed to read slot " + std::to_string( i ) + " of raw file " + raw_file + "!" );
+            }
+
+            k4a::capture capture = k4a::capture::create();
+            for( int32_t t = 0; t < 3; t++ ){
+                const raw::track& track = header.tracks[t];
+                const uint32_t bytes = index[i].bytes[t];
+                if( !bytes ){
+                    continue;
+                }
+
+                // Image owns Copy of Slot (MJPG has variable size)
+                uint8_t* buffer = new uint8_t[bytes];
+                std::memcpy( buffer, slot.data() + track.offset, bytes );
+                k4a::image image;
+                try{
+                    image = k4a::image::create_from_buffer( track.format, track.width, track.height, track.stride, buffer, bytes, release_buffer, nullptr );
+                }
+                catch( const k4a::error& ){
+                    delete[] buffer;
+                    throw;
+                }
+                image.set_device_timestamp( std::chrono::microseconds( index[i].timestamps[t] ) );
+
+                switch( t )
+                {
+                    case 0:
+                        capture.set_color_image( image );
+                        break;
+                    case 1:
+                        capture.set_depth_image( image );
+                        break;
+                    default:
+                        capture.set_ir_image( image );
+                        break;
+                }
+            }
+
+            record.write_capture( capture );
+        }
+
+        record.flush();
+        record.close();
+
+        const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        std::cout << raw_file << " -> " << mkv_file << " : " << header.frame_count << " captures, " << seconds << " s" << std::endl;
+    }
+    catch( const k4a::error& ){
+        ::close( file_descriptor );
+        throw;
+    }
+
+    ::close( file_descriptor );
+    #endif
+}
@@ -0,0 +1,170 @@
+#ifndef __RAW_CAPTURE__
+#define __RAW_CAPTURE__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+
+#if defined( HAVE_LIBURING )
+#include <liburing.h>
+#endif
+
+/*
+ This is raw capture sink that writes images into fixed-size frame slots of preallocated file.
+
+ raw_writer writer;
+ writer.open( "capture.k4araw", configuration, device.get_raw_calibration(), raw_writer::options( 10, 8 ) ); // 10 s, 8 buffers
+ writer.push( capture );  // copy images into free slot buffer (returns false and drops if no buffer is free)
+ writer.close();          // write header and index
+ convert_raw( "capture.k4araw", "capture.mkv" );
+
+ file   : [ header + calibration ][ index (entry per slot) ][ slot 0 ][ slot 1 ] ... (regions aligned to 4 KiB)
+ slot   : color, depth, infrared images at fixed offsets (max size of each image is decided from configuration)
+
+ File is preallocated for seconds * fps slots and opened with O_DIRECT, so that writes do not go through page cache.
+ Dedicated thread submits all slots that are ready as one batch (io_uring if HAVE_LIBURING, pwrite otherwise), and
+ returns buffers to capture thread when writes are completed. Header and index are written on close.
+ Raw file is not portable (host byte order, no compression), it is intended for short sessions and conversion.
+*/
+
+namespace raw
+{
+    // Track of Raw File
+    struct track
+    {
+        k4a_image_format_t format;
+        int32_t width;
+        int32_t height;
+        int32_t stride;
+        uint32_t max_bytes; // 0 is disabled track
+        uint32_t offset;    // offset in slot
+    };
+
+    // Header of Raw File
+    struct header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t calibration_bytes;
+        uint64_t data_offset;
+        uint64_t slot_bytes;
+        uint64_t slot_count;
+        uint64_t frame_count;
+        k4a_device_configuration_t configuration;
+        track tracks[3]; // color, depth, infrared
+    };
+
+    // Entry of Index
+    struct entry
+    {
+        int64_t timestamps[3]; // device timestamp [usec]
+        uint32_t bytes[3];
+        uint32_t reserved;
+    };
+}
+
+class raw_writer
+{
+public:
+    // Options
+    struct options
+    {
+        uint32_t seconds; // preallocated length
+        uint32_t depth;   // slot buffers (max writes in flight)
+
+        options( const uint32_t seconds = 10, const uint32_t depth = 8 )
+            : seconds( seconds ),
+              depth( depth )
+        {
+        }
+    };
+
+private:
+    // Slot that is Ready to Write
+    struct slot
+    {
+        uint64_t index;
+        uint8_t* buffer;
+    };
+
+    // File
+    int file_descriptor;
+    bool direct;
+    raw::header header;
+    std::vector<uint8_t> calibration;
+    std::vector<raw::entry> index;
+    options config;
+
+    // Buffers
+    std::vector<uint8_t*> buffers;
+    std::vector<uint8_t*> free_buffers;
+    std::deque<slot> ready;
+
+    // Writer
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable slot_ready;
+    std::condition_variable buffer_available;
+    bool stopping;
+    std::string error;
+    #if defined( HAVE_LIBURING )
+    io_uring ring;
+    #endif
+
+    // Statistics
+    uint64_t dropped;
+    uint64_t batches;
+    uint32_t max_batch;
+    uint64_t written_bytes;
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::duration elapsed;
+
+public:
+    // Constructor
+    raw_writer();
+
+    // Destructor
+    ~raw_writer();
+
+    raw_writer( const raw_writer& ) = delete;
+    raw_writer& operator=( const raw_writer& ) = delete;
+
+    // Open Raw File (preallocates slots)
+    void open( const std::string& file, const k4a_device_configuration_t& configuration, const std::vector<uint8_t>& calibration, const options& config = options() );
+
+    // Close Raw File (writes header and index)
+    void close();
+
+    // Push Capture (copies images into slot buffer, returns false if capture is dropped)
+    bool push( const k4a::capture& capture, const bool wait = false );
+
+    // Get Number of Frames
+    uint64_t get_frame_count() const { return header.frame_count; }
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+    // Get Layout of Tracks from Configuration
+    static void get_tracks( const k4a_device_configuration_t& configuration, raw::track* tracks, uint64_t* slot_bytes );
+
+private:
+    // Writer Loop
+    void write();
+
+    // Write Batch of Slots
+    void write_batch( std::vector<slot>& batch );
+};
+
+// Convert Raw File to MKV
+void convert_raw( const std::string& raw_file, const std::string& mkv_file );
+
+#endif // __RAW_CAPTURE__
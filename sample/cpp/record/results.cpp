@@ -0,0 +1,245 @@
+#include "results.hpp"
+
+#include <iostream>
+
+// Constructor
+result_recorder::result_recorder( const options& config )
+    : config( config ),
+      has_depth( false ),
+      has_bodies( false ),
+      stopping( false ),
+      processed( 0 ),
+      dropped( 0 ),
+      failed( 0 ),
+      process_time( 0 )
+{
+}
+
+// Destructor
+result_recorder::~result_recorder()
+{
+    // Stop
+    stop();
+}
+
+// Add Custom Tracks of Results
+void result_recorder::add_tracks( k4a::record& record, const k4a::calibration& calibration, const uint32_t fps )
+{
+    const int32_t width = calibration.depth_camera_calibration.resolution_width;
+    const int32_t height = calibration.depth_camera_calibration.resolution_height;
+    has_depth = calibration.depth_mode != k4a_depth_mode_t::K4A_DEPTH_MODE_OFF && calibration.depth_mode != k4a_depth_mode_t::K4A_DEPTH_MODE_PASSIVE_IR;
+    if( !has_depth ){
+        return;
+    }
+
+    // Filtered Depth
+    custom_track_writer::add_video_track( record, track_format::depth_filtered, { width, height, 16, track_format::make_fourcc( "b16g" ) }, fps );
+
+    // Body Index Map and Joints
+    #if defined( HAVE_K4ABT )
+    has_bodies = config.bodies;
+    if( has_bodies ){
+        custom_track_writer::add_video_track( record, track_format::body_index, { width, height, 8, track_format::make_fourcc( "Y800" ) }, fps );
+        custom_track_writer::add_data_track( record, track_format::body_joints, track_format::joints_codec );
+    }
+    #endif
+}
+
+// Start Worker
+void result_recorder::start( k4a::record& record, std::mutex& record_mutex, const k4a::calibration& calibration )
+{
+    // Stop Previous Worker
+    stop();
+
+    if( !has_depth ){
+        return;
+    }
+
+    #if defined( HAVE_K4ABT )
+    // Create Tracker
+    if( has_bodies ){
+        tracker = k4abt::tracker::create( calibration );
+        if( !tracker ){
+            throw k4a::error( "Failed to create tracker!" );
+        }
+    }
+    #endif
+
+    // Start Writer and Worker Threads
+    writer.start( record, record_mutex );
+    stopping = false;
+    worker = std::thread( &result_recorder::work, this );
+}
+
+// Stop Worker
+void result_recorder::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    capture_available.notify_all();
+    capture_taken.notify_all();
+
+    if( worker.joinable() ){
+        worker.join();
+    }
+
+    // Write Remaining Results
+    writer.stop();
+
+    #if defined( HAVE_K4ABT )
+    if( tracker ){
+        tracker.destroy();
+    }
+    #endif
+}
+
+// Push Capture
+bool result_recorder::push( const k4a::capture& capture, const bool wait )
+{
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        if( wait ){
+            capture_taken.wait( lock, [&](){ return !worker.joinable() || stopping || captures.size() < config.depth; } );
+        }
+        if( !worker.joinable() || stopping || captures.size() >= config.depth ){
+            dropped++;
+            return false;
+        }
+
+        captures.push_back( capture );
+    }
+    capture_available.notify_one();
+    return true;
+}
+
+// Report Statistics
+void result_recorder::report( std::ostream& stream )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stream << "results : " << processed << " captures processed, " << dropped << " dropped (worker busy), " << failed << " failed, "
+               << ( processed ? std::chrono::duration<double, std::milli>( process_time ).count() / processed : 0.0 ) << " ms/capture, tracks "
+               << ( has_depth ? track_format::depth_filtered : "none" );
+        if( has_bodies ){
+            stream << ", " << track_format::body_index << ", " << track_format::body_joints;
+        }
+        stream << std::endl;
+    }
+    writer.report( stream );
+}
+
+// Worker Loop
+void result_recorder::work()
+{
+    while( true ){
+        // Wait Capture
+        k4a::capture capture;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            capture_available.wait( lock, [&](){ return stopping || !captures.empty(); } );
+            if( captures.empty() ){
+                return;
+            }
+            capture = std::move( captures.front() );
+            captures.pop_front();
+        }
+        capture_taken.notify_one();
+
+        // NOTE: Exception can not cross thread boundary, failed capture is counted and worker keeps going.
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::string message;
+        try{
+            process( capture );
+        }
+        catch( const k4a::error& exception ){
+            message = exception.what();
+        }
+        catch( const cv::Exception& exception ){
+            message = exception.what();
+        }
+
+        std::lock_guard<std::mutex> lock( mutex );
+        if( !message.empty() ){
+            if( !failed++ ){
+                std::cerr << message << ", later failed captures are counted only" << std::endl;
+            }
+            continue;
+        }
+        processed++;
+        process_time += std::chrono::steady_clock::now() - start;
+    }
+}
+
+// Process Capture
+void result_recorder::process( const k4a::capture& capture )
+{
+    const k4a::image depth_image = capture.get_depth_image();
+    if( !depth_image.handle() ){
+        return;
+    }
+
+    // Filtered Depth
+    const cv::Mat depth( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( depth_image.get_buffer() ), depth_image.get_stride_bytes() );
+    cv::Mat filtered;
+    cv::medianBlur( depth, filtered, config.filter_size );
+    writer.write( track_format::depth_filtered, depth_image.get_device_timestamp(), encode_depth( filtered ) );
+
+    #if defined( HAVE_K4ABT )
+    if( !has_bodies ){
+        return;
+    }
+
+    // Track Bodies
+    if( !tracker.enqueue_capture( capture ) ){
+        return;
+    }
+    k4abt::frame frame = tracker.pop_result();
+    if( !frame ){
+        return;
+    }
+    const std::chrono::microseconds timestamp = frame.get_device_timestamp();
+
+    // Body Index Map
+    const k4a::image body_index_map = frame.get_body_index_map();
+    if( body_index_map.handle() ){
+        const uint8_t* buffer = body_index_map.get_buffer();
+        writer.write( track_format::body_index, timestamp, std::vector<uint8_t>( buffer, buffer + body_index_map.get_size() ) );
+    }
+
+    // Joints of Bodies
+    std::vector<track_format::body> bodies( frame.get_num_bodies() );
+    for( uint32_t i = 0; i < bodies.size(); i++ ){
+        const k4abt_body_t body = frame.get_body( i );
+        bodies[i].id = body.id;
+        for( uint32_t j = 0; j < track_format::joint_count; j++ ){
+            const k4abt_joint_t& joint = body.skeleton.joints[j];
+            track_format::joint& target = bodies[i].joints[j];
+            for( int32_t k = 0; k < 3; k++ ){
+                target.position[k] = joint.position.v[k];
+            }
+            for( int32_t k = 0; k < 4; k++ ){
+                target.orientation[k] = joint.orientation.v[k];
+            }
+            target.confidence = static_cast<int32_t>( joint.confidence_level );
+        }
+    }
+    writer.write( track_format::body_joints, timestamp, track_format::serialize_bodies( bodies ) );
+    #endif
+}
+
+// Encode Depth to Big Endian (b16g)
+std::vector<uint8_t> result_recorder::encode_depth( const cv::Mat& depth )
+{
+    std::vector<uint8_t> data( depth.total() * sizeof( uint16_t ) );
+    uint8_t* destination = data.data();
+    for( int32_t y = 0; y < depth.rows; y++ ){
+        const uint16_t* row = depth.ptr<uint16_t>( y );
+        for( int32_t x = 0; x < depth.cols; x++ ){
+            *destination++ = static_cast<uint8_t>( row[x] >> 8 );
+            *destination++ = static_cast<uint8_t>( row[x] & 0xFF );
+        }
+    }
+    return data;
+}
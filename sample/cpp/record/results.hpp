@@ -0,0 +1,122 @@
+#ifndef __RESULTS__
+#define __RESULTS__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+#include <opencv2/opencv.hpp>
+
+#if defined( HAVE_K4ABT )
+#include <k4abt.hpp>
+#endif
+
+#include "custom_tracks.hpp"
+#include "track_format.hpp"
+
+/*
+ This is recorder of processed results that computes results from captures and writes them into custom tracks.
+
+ result_recorder results;
+ results.add_tracks( record, calibration, fps );    // before write_header()
+ record.write_header();
+ results.start( record, record_mutex, calibration );
+ results.push( capture );                           // capture thread, drops capture if worker is busy (or waits if requested)
+ results.stop();                                    // before close of record
+
+ DEPTH_FILTERED : median filtered depth (always)
+ BODY_INDEX     : body index map of body tracking (if HAVE_K4ABT)
+ BODY_JOINTS    : joints of bodies (if HAVE_K4ABT)
+
+ Worker thread processes captures (capture handles are queued, images are not copied), results are queued to
+ custom_track_writer that writes them in batches. Results can be read with typed readers of playback sample
+ (custom_tracks.hpp) without decoding color, depth and infrared tracks.
+*/
+
+class result_recorder
+{
+public:
+    // Options
+    struct options
+    {
+        uint32_t depth;        // max captures queued to worker
+        int32_t filter_size;   // kernel size of median filter (3 or 5)
+        bool bodies;           // body tracking (if HAVE_K4ABT)
+
+        options( const uint32_t depth = 4, const int32_t filter_size = 5, const bool bodies = true )
+            : depth( depth ),
+              filter_size( filter_size ),
+              bodies( bodies )
+        {
+        }
+    };
+
+private:
+    options config;
+    custom_track_writer writer;
+    bool has_depth;
+    bool has_bodies;
+
+    #if defined( HAVE_K4ABT )
+    k4abt::tracker tracker;
+    #endif
+
+    // Worker
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable capture_available;
+    std::condition_variable capture_taken;
+    std::deque<k4a::capture> captures;
+    bool stopping;
+
+    // Statistics
+    uint64_t processed;
+    uint64_t dropped;
+    uint64_t failed; // captures that failed to process (first error is logged)
+    std::chrono::steady_clock::duration process_time;
+
+public:
+    // Constructor
+    result_recorder( const options& config = options() );
+
+    // Destructor
+    ~result_recorder();
+
+    result_recorder( const result_recorder& ) = delete;
+    result_recorder& operator=( const result_recorder& ) = delete;
+
+    // Add Custom Tracks of Results (before write_header)
+    void add_tracks( k4a::record& record, const k4a::calibration& calibration, const uint32_t fps );
+
+    // Start Worker (after write_header)
+    void start( k4a::record& record, std::mutex& record_mutex, const k4a::calibration& calibration );
+
+    // Stop Worker (writes remaining results, before close of record)
+    void stop();
+
+    // Push Capture (returns false if capture is dropped, waits for free entry of queue if wait is true)
+    bool push( const k4a::capture& capture, const bool wait = false );
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Worker Loop
+    void work();
+
+    // Process Capture
+    void process( const k4a::capture& capture );
+
+    // Encode Depth to Big Endian (b16g)
+    static std::vector<uint8_t> encode_depth( const cv::Mat& depth );
+};
+
+#endif // __RESULTS__
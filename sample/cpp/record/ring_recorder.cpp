@@ -0,0 +1,325 @@
+#include "ring_recorder.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // Generate File Name from Date (YYYY_MM_DD_hhmmss_<prefix>.mkv)
+    std::string generate_file_name( const std::string& prefix )
+    {
+        const std::chrono::system_clock::time_point time_point = std::chrono::system_clock::now();
+        const std::time_t time = std::chrono::system_clock::to_time_t( time_point );
+        const tm tm = *localtime( &time );
+
+        std::ostringstream oss;
+        oss << "./" << tm.tm_year + 1900 << "_"
+            << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_mon + 1 << "_"
+            << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_mday    << "_"
+            << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_hour
+            << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_min
+            << std::setfill( '0' ) << std::setw( 2 ) << tm.tm_sec
+            << "_" << prefix << ".mkv";
+        return oss.str();
+    }
+
+    // Convert Bytes to Mega Bytes
+    double to_mega_bytes( const size_t bytes )
+    {
+        return static_cast<double>( bytes ) / ( 1024.0 * 1024.0 );
+    }
+}
+
+// Constructor
+ring_recorder::ring_recorder()
+    : device( nullptr ),
+      configuration( K4A_DEVICE_CONFIG_INIT_DISABLE_ALL ),
+      ring_bytes( 0 ),
+      trigger_requested( false ),
+      recording( false ),
+      record_until( 0 ),
+      pending_bytes( 0 ),
+      stopping( false ),
+      events( 0 ),
+      written( 0 ),
+      dropped( 0 ),
+      max_ring_bytes( 0 ),
+      max_pending_bytes( 0 ),
+      latencies( 0 ),
+      total_latency( 0.0 ),
+      max_latency( 0.0 )
+{
+}
+
+// Destructor
+ring_recorder::~ring_recorder()
+{
+    // Stop
+    stop();
+}
+
+// Start Recorder
+void ring_recorder::start( k4a::device& device, const k4a_device_configuration_t& configuration, const options& config )
+{
+    // Stop Previous Recorder
+    stop();
+
+    this->device = &device;
+    this->configuration = configuration;
+    this->config = config;
+    stopping = false;
+
+    // Start Writer Thread
+    writer = std::thread( &ring_recorder::write, this );
+}
+
+// Stop Recorder
+void ring_recorder::stop()
+{
+    // Finish Current Event and Stop Writer
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( recording ){
+            recording = false;
+            pending.push_back( entry( entry::kind::end ) );
+        }
+        stopping = true;
+    }
+    entry_available.notify_all();
+
+    if( writer.joinable() ){
+        writer.join();
+    }
+
+    // Release Captures
+    ring.clear();
+    ring_bytes = 0;
+    pending.clear();
+    pending_bytes = 0;
+}
+
+// Push Capture
+void ring_recorder::push( const k4a::capture& capture )
+{
+    if( !capture.handle() ){
+        return;
+    }
+
+    std::chrono::microseconds timestamp;
+    size_t bytes;
+    measure( capture, timestamp, bytes );
+
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        // Begin or Extend Event
+        if( trigger_requested ){
+            trigger_requested = false;
+            record_until = timestamp + config.post_roll;
+
+            if( !recording ){
+                // Hand Ring to Writer (ring frames follow begin entry)
+                recording = true;
+                entry begin( entry::kind::begin );
+                begin.ring_frames = ring.size();
+                begin.trigger_time = trigger_time;
+                begin.reason = trigger_reason;
+                pending.push_back( std::move( begin ) );
+                for( entry& item : ring ){
+                    pending.push_back( std::move( item ) );
+                }
+                pending_bytes += ring_bytes;
+                max_pending_bytes = std::max( max_pending_bytes, pending_bytes );
+                ring.clear();
+                ring_bytes = 0;
+            }
+        }
+
+        if( recording ){
+            // Pass Capture to Writer (drop if writer falls behind instead of stalling capture)
+            if( !enqueue( entry( entry::kind::capture, capture, timestamp, bytes ) ) ){
+                dropped++;
+            }
+
+            // End Event after Post-Roll
+            if( timestamp >= record_until ){
+                recording = false;
+                pending.push_back( entry( entry::kind::end ) );
+            }
+            notify = true;
+        }
+        else{
+            // Keep Capture in Ring (handle only, image buffers are not copied)
+            ring.push_back( entry( entry::kind::capture, capture, timestamp, bytes ) );
+            ring_bytes += bytes;
+
+            // Drop Oldest Captures out of Pre-Roll or Memory Budget
+            while( ring.size() > 1 && ( timestamp - ring.front().timestamp > config.pre_roll || ring_bytes > config.max_bytes ) ){
+                ring_bytes -= ring.front().bytes;
+                ring.pop_front();
+            }
+            max_ring_bytes = std::max( max_ring_bytes, ring_bytes );
+        }
+    }
+
+    if( notify ){
+        entry_available.notify_one();
+    }
+}
+
+// Trigger Event
+void ring_recorder::trigger( const std::string& reason )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    if( !trigger_requested ){
+        trigger_requested = true;
+        trigger_time = std::chrono::steady_clock::now();
+        trigger_reason = reason;
+    }
+}
+
+// Event is Recording
+bool ring_recorder::is_recording()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return recording || trigger_requested;
+}
+
+// Report Statistics
+void ring_recorder::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    const std::chrono::microseconds span = ring.empty() ? std::chrono::microseconds( 0 ) : ring.back().timestamp - ring.front().timestamp;
+    stream << "ring recorder : pre-roll " << std::chrono::duration<double>( config.pre_roll ).count() << " s, post-roll "
+           << std::chrono::duration<double>( config.post_roll ).count() << " s, ring " << ring.size() << " captures ("
+           << std::chrono::duration<double>( span ).count() << " s, " << to_mega_bytes( ring_bytes ) << " MB, max "
+           << to_mega_bytes( max_ring_bytes ) << " MB of " << to_mega_bytes( config.max_bytes ) << " MB), max writer queue "
+           << to_mega_bytes( max_pending_bytes ) << " MB, " << events << " events, " << written << " captures written, "
+           << dropped << " dropped, trigger-to-disk latency " << ( latencies ? total_latency / latencies : 0.0 ) << " ms (max "
+           << max_latency << " ms)" << std::endl;
+}
+
+// Writer Loop
+void ring_recorder::write()
+{
+    k4a::record record;
+    std::string file;
+    std::string reason;
+    uint64_t remaining = 0; // frames of pre-roll not written yet
+    uint64_t frames = 0;
+    std::chrono::steady_clock::time_point trigger_time;
+
+    while( true ){
+        // Wait Entry
+        entry item;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            entry_available.wait( lock, [&](){ return stopping || !pending.empty(); } );
+            if( pending.empty() ){
+                break;
+            }
+            item = std::move( pending.front() );
+            pending.pop_front();
+            pending_bytes -= item.bytes;
+        }
+
+        // NOTE: Exception can not cross thread boundary, failure of event is reported and writer continues.
+        try{
+            switch( item.type )
+            {
+                case entry::kind::begin:
+                    // Create Record of Event
+                    file = generate_file_name( config.prefix + "_" + std::to_string( events + 1 ) );
+                    record = k4a::record::create( file.c_str(), *device, configuration );
+                    record.write_header();
+                    {
+                        std::lock_guard<std::mutex> lock( mutex );
+                        events++;
+                    }
+                    reason = item.reason;
+                    remaining = std::max<uint64_t>( item.ring_frames, 1 ); // empty ring: first capture after trigger
+                    frames = 0;
+                    trigger_time = item.trigger_time;
+                    break;
+
+                case entry::kind::capture:
+                    if( !record.handle() ){
+                        break;
+                    }
+
+                    record.write_capture( item.capture );
+                    frames++;
+                    {
+                        std::lock_guard<std::mutex> lock( mutex );
+                        written++;
+                    }
+
+                    // Flush Pre-Roll and Measure Trigger-to-Disk Latency
+                    if( remaining && --remaining == 0 ){
+                        record.flush();
+                        const double latency = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - trigger_time ).count();
+                        std::lock_guard<std::mutex> lock( mutex );
+                        total_latency += latency;
+                        latencies++;
+                        max_latency = std::max( max_latency, latency );
+                    }
+                    break;
+
+                case entry::kind::end:
+                    if( !record.handle() ){
+                        break;
+                    }
+
+                    // Close Record of Event
+                    record.flush();
+                    record.close();
+                    std::cout << file << " (" << reason << ", " << frames << " captures)" << std::endl;
+                    break;
+            }
+        }
+        catch( const k4a::error& exception ){
+            std::cerr << exception.what() << std::endl;
+            record.close();
+        }
+    }
+
+    // Close Record of Unfinished Event
+    if( record.handle() ){
+        record.flush();
+        record.close();
+    }
+}
+
+// Queue Entry to Writer
+bool ring_recorder::enqueue( entry&& item )
+{
+    if( pending_bytes + item.bytes > config.max_bytes ){
+        return false;
+    }
+
+    pending_bytes += item.bytes;
+    max_pending_bytes = std::max( max_pending_bytes, pending_bytes );
+    pending.push_back( std::move( item ) );
+    return true;
+}
+
+// Get Device Timestamp and Bytes of Capture
+void ring_recorder::measure( const k4a::capture& capture, std::chrono::microseconds& timestamp, size_t& bytes )
+{
+    timestamp = std::chrono::microseconds( 0 );
+    bytes = 0;
+
+    const k4a::image images[] = { capture.get_color_image(), capture.get_depth_image(), capture.get_ir_image() };
+    for( const k4a::image& image : images ){
+        if( !image.handle() ){
+            continue;
+        }
+
+        timestamp = std::max( timestamp, image.get_device_timestamp() );
+        bytes += image.get_size();
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef __RING_RECORDER__
+#define __RING_RECORDER__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+
+/*
+ This is pre-trigger recorder that keeps last seconds of captures in memory and records them on trigger.
+
+ ring_recorder recorder;
+ recorder.start( device, configuration, ring_recorder::options( 5, 10 ) ); // pre-roll 5 s, post-roll 10 s
+ recorder.push( capture );                                                   // every capture (never blocks)
+ recorder.trigger( "key" );                                                  // from any thread
+
+ Ring holds ref-counted k4a::capture handles as they are (MJPG is not decoded), bounded by pre-roll and max bytes.
+ On trigger, ring is handed to writer thread as is (O(1)), and following captures are passed to writer until
+ post-roll after last trigger has elapsed (in device time). Trigger during event extends it.
+ Writer thread creates new MKV per event (<prefix>_<n>.mkv), so capture thread does not wait for disk.
+ If writer falls behind more than max bytes, captures are dropped instead of stalling capture.
+
+ latency : wall time from trigger to pre-roll frames flushed to file
+*/
+
+class ring_recorder
+{
+public:
+    // Options
+    struct options
+    {
+        std::chrono::microseconds pre_roll;  // captures kept before trigger
+        std::chrono::microseconds post_roll; // captures recorded after last trigger
+        size_t max_bytes;                    // max bytes of ring (and of writer queue)
+        std::string prefix;                  // prefix of file name
+
+        options( const uint32_t pre_seconds = 5, const uint32_t post_seconds = 10, const size_t max_bytes = 512 * 1024 * 1024, const std::string& prefix = "event" )
+            : pre_roll( std::chrono::seconds( pre_seconds ) ),
+              post_roll( std::chrono::seconds( post_seconds ) ),
+              max_bytes( max_bytes ),
+              prefix( prefix )
+        {
+        }
+    };
+
+private:
+    // Entry of Queue
+    struct entry
+    {
+        enum class kind
+        {
+            capture,
+            begin, // begin event (frames of pre-roll follow)
+            end    // end event
+        };
+
+        kind type;
+        k4a::capture capture;
+        std::chrono::microseconds timestamp;
+        size_t bytes;
+        uint64_t ring_frames;                                // begin: number of frames of pre-roll
+        std::chrono::steady_clock::time_point trigger_time; // begin: wall time of trigger
+        std::string reason;                                  // begin: reason of trigger
+
+        entry( const kind type = kind::capture, const k4a::capture& capture = k4a::capture(), const std::chrono::microseconds timestamp = std::chrono::microseconds( 0 ), const size_t bytes = 0 )
+            : type( type ),
+              capture( capture ),
+              timestamp( timestamp ),
+              bytes( bytes ),
+              ring_frames( 0 )
+        {
+        }
+    };
+
+    // Device
+    k4a::device* device;
+    k4a_device_configuration_t configuration;
+    options config;
+
+    // Ring (capture thread)
+    std::deque<entry> ring;
+    size_t ring_bytes;
+
+    // Trigger
+    std::mutex mutex;
+    bool trigger_requested;
+    std::chrono::steady_clock::time_point trigger_time;
+    std::string trigger_reason;
+    bool recording;
+    std::chrono::microseconds record_until;
+
+    // Writer
+    std::thread writer;
+    std::condition_variable entry_available;
+    std::deque<entry> pending;
+    size_t pending_bytes;
+    bool stopping;
+
+    // Statistics
+    uint64_t events;
+    uint64_t written;
+    uint64_t dropped;
+    size_t max_ring_bytes;
+    size_t max_pending_bytes;
+    uint64_t latencies;
+    double total_latency;
+    double max_latency;
+
+public:
+    // Constructor
+    ring_recorder();
+
+    // Destructor
+    ~ring_recorder();
+
+    ring_recorder( const ring_recorder& ) = delete;
+    ring_recorder& operator=( const ring_recorder& ) = delete;
+
+    // Start Recorder (device must be started with configuration)
+    void start( k4a::device& device, const k4a_device_configuration_t& configuration, const options& config = options() );
+
+    // Stop Recorder (finishes current event)
+    void stop();
+
+    // Push Capture (capture thread, never waits for disk)
+    void push( const k4a::capture& capture );
+
+    // Trigger Event (any thread)
+    void trigger( const std::string& reason );
+
+    // Event is Recording
+    bool is_recording();
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Writer Loop
+    void write();
+
+    // Queue Entry to Writer (returns false if writer queue is full)
+    bool enqueue( entry&& item );
+
+    // Get Device Timestamp and Bytes of Capture
+    static void measure( const k4a::capture& capture, std::chrono::microseconds& timestamp, size_t& bytes );
+};
+
+#endif // __RING_RECORDER__
@@ -0,0 +1,129 @@
+/*
+ This is scheduler of main loop that decouples capture, processing and UI refresh.
+
+ scheduler loop( scheduler::mode::live );
+ while( true ){
+     if( update() ){ draw(); loop.count_frame(); }  // as soon as frame is ready
+     if( loop.is_ui_due() ){ show(); cv::waitKey( 1 ); } // at fixed UI rate
+ }
+
+ mode::live  : frames are processed as soon as device delivers them
+ mode::fast  : frames are processed as fast as possible (playback)
+ mode::paced : frames are processed at their recorded device timestamps (playback, see replay_clock)
+*/
+
+#ifndef __SCHEDULER__
+#define __SCHEDULER__
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+#include <k4a/k4a.hpp>
+
+class scheduler
+{
+public:
+    // Mode
+    enum class mode
+    {
+        live,
+        fast,
+        paced
+    };
+
+private:
+    // Mode
+    mode loop_mode;
+
+    // UI Refresh
+    std::chrono::steady_clock::duration ui_interval;
+    std::chrono::steady_clock::time_point next_ui_refresh;
+
+    // Statistics
+    uint64_t frames;
+    uint64_t ui_refreshes;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    // Constructor
+    scheduler( const mode loop_mode = mode::live, const double ui_rate = 60.0 )
+        : loop_mode( loop_mode ),
+          ui_interval( std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( 1.0 / ui_rate ) ) ),
+          next_ui_refresh( std::chrono::steady_clock::now() ),
+          frames( 0 ),
+          ui_refreshes( 0 ),
+          start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    // Get Mode
+    mode get_mode() const
+    {
+        return loop_mode;
+    }
+
+    // Get Timeout until Next UI Refresh
+    std::chrono::milliseconds get_time_out() const
+    {
+        const std::chrono::steady_clock::duration remaining = next_ui_refresh - std::chrono::steady_clock::now();
+        return std::max( std::chrono::milliseconds( 0 ), std::chrono::duration_cast<std::chrono::milliseconds>( remaining ) );
+    }
+
+    // Check UI Refresh is Due
+    bool is_ui_due()
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if( now < next_ui_refresh ){
+            return false;
+        }
+
+        // Skip Missed Refreshes instead of Bursting
+        next_ui_refresh = std::max( next_ui_refresh + ui_interval, now );
+        ui_refreshes++;
+        return true;
+    }
+
+    // Get Time of Next UI Refresh (deadline of waiting frame)
+    std::chrono::steady_clock::time_point get_next_ui_refresh() const
+    {
+        return next_ui_refresh;
+    }
+
+    // Count Processed Frame
+    void count_frame()
+    {
+        frames++;
+    }
+
+    // Report Achieved Rates
+    void report( std::ostream& stream ) const
+    {
+        const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        if( elapsed <= 0.0 ){
+            return;
+        }
+
+        const char* name = ( loop_mode == mode::live ) ? "live" : ( loop_mode == mode::fast ) ? "fast" : "paced";
+        stream << "loop (" << name << ") : " << frames << " frames"
+               << ", " << frames / elapsed << " fps"
+               << ", ui " << ui_refreshes / elapsed << " Hz" << std::endl;
+    }
+
+    // Get Device Timestamp of Capture
+    static std::chrono::microseconds get_device_timestamp( const k4a::capture& capture )
+    {
+        k4a::image image = capture.get_depth_image();
+        if( !image.handle() ){
+            image = capture.get_color_image();
+        }
+
+        if( !image.handle() ){
+            image = capture.get_ir_image();
+        }
+
+        return image.handle() ? image.get_device_timestamp() : std::chrono::microseconds( 0 );
+    }
+};
+
+#endif // __SCHEDULER__
@@ -0,0 +1,267 @@
+#include "segment_recorder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Constructor
+segment_recorder::segment_recorder()
+    : device( nullptr ),
+      configuration( K4A_DEVICE_CONFIG_INIT_DISABLE_ALL ),
+      active( false ),
+      open_requested( false ),
+      next_ready( false ),
+      stopping( false ),
+      opened( 0 ),
+      rollovers( 0 ),
+      late_captures( 0 ),
+      max_switch( 0 )
+{
+}
+
+// Destructor
+segment_recorder::~segment_recorder()
+{
+    // Stop
+    stop();
+}
+
+// Start Recorder
+void segment_recorder::start( k4a::device& device, const k4a_device_configuration_t& configuration, const std::string& base, const options& config )
+{
+    // Stop Previous Recorder
+    stop();
+
+    this->device = &device;
+    this->configuration = configuration;
+    this->base = base;
+    this->config = config;
+    stopping = false;
+    error.clear();
+    opened = 0;
+    rollovers = 0;
+    late_captures = 0;
+    max_switch = std::chrono::steady_clock::duration( 0 );
+
+    // Open Manifest
+    manifest.open( base + ".csv" );
+    if( !manifest.is_open() ){
+        throw k4a::error( "Failed to open manifest " + base + ".csv!" );
+    }
+    manifest << "segment,file,first_device_timestamp_usec,last_device_timestamp_usec,captures,bytes" << std::endl;
+
+    // Open First Segment
+    current = open( opened++ );
+    active = true;
+
+    // Start Worker Thread (opens next segment ahead)
+    open_requested = true;
+    next_ready = false;
+    worker = std::thread( &segment_recorder::work, this );
+}
+
+// Stop Recorder
+void segment_recorder::stop()
+{
+    // Stop Worker (finalizes closing segments)
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    job_available.notify_all();
+
+    if( worker.joinable() ){
+        worker.join();
+    }
+
+    // NOTE: Exception can not cross thread boundary, error of worker that was not thrown yet is reported here.
+    if( !error.empty() ){
+        std::cerr << error << std::endl;
+        error.clear();
+    }
+
+    try{
+        // Finalize Current Segment
+        if( active ){
+            finalize( current );
+            active = false;
+        }
+
+        // Remove Next Segment that was Opened Ahead but Not Used
+        if( next_ready ){
+            next.record.close();
+            std::remove( next.file.c_str() );
+            next_ready = false;
+        }
+    }
+    catch( const k4a::error& exception ){
+        std::cerr << exception.what() << std::endl;
+    }
+
+    if( manifest.is_open() ){
+        manifest.close();
+    }
+}
+
+// Write Capture
+void segment_recorder::write( const k4a::capture& capture )
+{
+    if( !active || !capture.handle() ){
+        return;
+    }
+
+    std::chrono::microseconds timestamp;
+    uint64_t bytes;
+    measure( capture, timestamp, bytes );
+
+    // Roll Over to Next Segment if Current Segment is Full
+    const bool is_full = current.captures && ( ( config.duration.count() && timestamp - current.first_timestamp >= config.duration ) ||
+                                               ( config.max_bytes && current.bytes + bytes > config.max_bytes ) );
+    if( is_full ){
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool switched = false;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            // NOTE: Exception can not cross thread boundary, error of worker is thrown here.
+            if( !error.empty() ){
+                const std::string message = error;
+                error.clear();
+                throw k4a::error( message );
+            }
+
+            // Swap to Segment that was Opened Ahead (previous segment is finalized by worker)
+            if( next_ready ){
+                closing.push_back( std::move( current ) );
+                current = std::move( next );
+                next_ready = false;
+                open_requested = true;
+                rollovers++;
+                switched = true;
+            }
+            else{
+                late_captures++;
+            }
+        }
+
+        if( switched ){
+            job_available.notify_one();
+            max_switch = std::max( max_switch, std::chrono::steady_clock::now() - start );
+        }
+    }
+
+    // Write Capture to Current Segment
+    current.record.write_capture( capture );
+    if( !current.captures ){
+        current.first_timestamp = timestamp;
+    }
+    current.last_timestamp = timestamp;
+    current.captures++;
+    current.bytes += bytes;
+}
+
+// Report Statistics
+void segment_recorder::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    stream << "segment recorder : " << base << " (" << std::chrono::duration<double>( config.duration ).count() << " s, "
+           << config.max_bytes / ( 1024 * 1024 ) << " MB per segment, 0 is unlimited), " << rollovers + ( active ? 1 : 0 ) << " segments, "
+           << late_captures << " captures over limit (next segment not ready), max switch "
+           << std::chrono::duration<double, std::micro>( max_switch ).count() << " us" << std::endl;
+}
+
+// Worker Loop
+void segment_recorder::work()
+{
+    while( true ){
+        segment target;
+        bool finalizing = false;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            job_available.wait( lock, [&](){ return stopping || open_requested || !closing.empty(); } );
+
+            // Finalize Previous Segment First
+            if( !closing.empty() ){
+                target = std::move( closing.front() );
+                closing.pop_front();
+                finalizing = true;
+            }
+            else if( stopping ){
+                return;
+            }
+            else{
+                open_requested = false;
+            }
+        }
+
+        // NOTE: Exception can not cross thread boundary, error is passed to capture thread.
+        try{
+            if( finalizing ){
+                // Flush and Close Previous Segment
+                finalize( target );
+            }
+            else{
+                // Open Next Segment Ahead
+                segment prepared = open( opened++ );
+                std::lock_guard<std::mutex> lock( mutex );
+                next = std::move( prepared );
+                next_ready = true;
+            }
+        }
+        catch( const k4a::error& exception ){
+            std::lock_guard<std::mutex> lock( mutex );
+            error = exception.what();
+        }
+    }
+}
+
+// Open Segment
+segment_recorder::segment segment_recorder::open( const uint32_t index )
+{
+    std::ostringstream oss;
+    oss << base << "_" << std::setfill( '0' ) << std::setw( 3 ) << index << ".mkv";
+
+    // Create Record and Write Header
+    segment target;
+    target.index = index;
+    target.file = oss.str();
+    target.record = k4a::record::create( target.file.c_str(), *device, configuration );
+    target.record.write_header();
+    target.first_timestamp = std::chrono::microseconds( 0 );
+    target.last_timestamp = std::chrono::microseconds( 0 );
+    target.captures = 0;
+    target.bytes = 0;
+    return target;
+}
+
+// Finalize Segment
+void segment_recorder::finalize( segment& target )
+{
+    // Flush and Close Record
+    target.record.flush();
+    target.record.close();
+
+    // Append Boundary of Segment to Manifest
+    manifest << target.index << "," << target.file << "," << target.first_timestamp.count() << "," << target.last_timestamp.count() << ","
+             << target.captures << "," << target.bytes << std::endl;
+    std::cout << target.file << " (" << target.captures << " captures)" << std::endl;
+}
+
+// Get Device Timestamp and Bytes of Capture
+void segment_recorder::measure( const k4a::capture& capture, std::chrono::microseconds& timestamp, uint64_t& bytes )
+{
+    timestamp = std::chrono::microseconds( 0 );
+    bytes = 0;
+
+    const k4a::image images[] = { capture.get_color_image(), capture.get_depth_image(), capture.get_ir_image() };
+    for( const k4a::image& image : images ){
+        if( !image.handle() ){
+            continue;
+        }
+
+        timestamp = std::max( timestamp, image.get_device_timestamp() );
+        bytes += image.get_size();
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef __SEGMENT_RECORDER__
+#define __SEGMENT_RECORDER__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/record.hpp>
+
+/*
+ This is segmented recorder that rolls recording over into new files by duration or size.
+
+ segment_recorder recorder;
+ recorder.start( device, configuration, "./2024_01_01_000000", segment_recorder::options( 600, 4096 ) ); // 10 min or 4 GB
+ recorder.write( capture ); // every capture (capture thread)
+ recorder.stop();
+
+ Files are <base>_000.mkv, <base>_001.mkv, ... and manifest <base>.csv lists boundaries of segments.
+ Worker thread opens next segment (create and write header) before it is needed, so that capture thread only swaps
+ handles at rollover. Previous segment is flushed and closed on worker thread too.
+ If next segment is not open yet at rollover, capture is written to current segment (segment becomes longer,
+ but capture is never dropped), and rollover is tried again at next capture.
+
+ manifest : segment,file,first_device_timestamp_usec,last_device_timestamp_usec,captures,bytes
+*/
+
+class segment_recorder
+{
+public:
+    // Options
+    struct options
+    {
+        std::chrono::microseconds duration; // max duration of segment (0 is unlimited)
+        uint64_t max_bytes;                 // max bytes of captures in segment (0 is unlimited)
+
+        options( const uint32_t seconds = 600, const uint64_t mega_bytes = 0 )
+            : duration( std::chrono::seconds( seconds ) ),
+              max_bytes( mega_bytes * 1024 * 1024 )
+        {
+        }
+    };
+
+private:
+    // Segment
+    struct segment
+    {
+        uint32_t index;
+        std::string file;
+        k4a::record record;
+        std::chrono::microseconds first_timestamp;
+        std::chrono::microseconds last_timestamp;
+        uint64_t captures;
+        uint64_t bytes;
+    };
+
+    // Device
+    k4a::device* device;
+    k4a_device_configuration_t configuration;
+    std::string base;
+    options config;
+
+    // Current Segment (capture thread)
+    segment current;
+    bool active;
+
+    // Worker
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable job_available;
+    bool open_requested;
+    bool next_ready;
+    segment next;
+    std::deque<segment> closing;
+    bool stopping;
+    std::string error;
+    std::ofstream manifest;
+
+    // Statistics
+    uint32_t opened;         // segments opened by worker
+    uint32_t rollovers;
+    uint64_t late_captures;  // captures written over limit because next segment was not ready
+    std::chrono::steady_clock::duration max_switch;
+
+public:
+    // Constructor
+    segment_recorder();
+
+    // Destructor
+    ~segment_recorder();
+
+    segment_recorder( const segment_recorder& ) = delete;
+    segment_recorder& operator=( const segment_recorder& ) = delete;
+
+    // Start Recorder (device must be started with configuration)
+    void start( k4a::device& device, const k4a_device_configuration_t& configuration, const std::string& base, const options& config = options() );
+
+    // Stop Recorder (finalizes all segments)
+    void stop();
+
+    // Write Capture (rolls over to next segment if current one is full)
+    void write( const k4a::capture& capture );
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Worker Loop
+    void work();
+
+    // Open Segment
+    segment open( const uint32_t index );
+
+    // Finalize Segment
+    void finalize( segment& target );
+
+    // Get Device Timestamp and Bytes of Capture
+    static void measure( const k4a::capture& capture, std::chrono::microseconds& timestamp, uint64_t& bytes );
+};
+
+#endif // __SEGMENT_RECORDER__
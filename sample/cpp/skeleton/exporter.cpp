@@ -0,0 +1,189 @@
+#include "exporter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Constructor
+video_exporter::video_exporter( const std::string& output, const double fps, const cv::Size& size, const size_t capacity )
+    : sink( output, fps, size ),
+      fps( fps ),
+      capacity( std::max<size_t>( 1, capacity ) ),
+      closing( false ),
+      start_timestamp( 0 ),
+      next_slot( 0 ),
+      pushed_frames( 0 ),
+      rejected_frames( 0 ),
+      skipped_frames( 0 ),
+      repeated_frames( 0 ),
+      wait_time( 0.0 ),
+      encode_time( 0.0 )
+{
+    // Start Encode Thread
+    thread = std::thread( &video_exporter::encode, this );
+}
+
+// Destructor
+video_exporter::~video_exporter()
+{
+    close();
+}
+
+// Push Frame
+void video_exporter::push( const cv::Mat& frame, const std::chrono::microseconds timestamp )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+
+    // Wait Free Slot (backpressure to renderer)
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    not_full.wait( lock, [&](){ return queue.size() < capacity || closing; } );
+    wait_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    if( closing ){
+        return;
+    }
+
+    enqueue( lock, frame, timestamp );
+}
+
+// Try Push Frame
+bool video_exporter::try_push( const cv::Mat& frame, const std::chrono::microseconds timestamp )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    if( closing || queue.size() >= capacity ){
+        rejected_frames++;
+        return false;
+    }
+
+    enqueue( lock, frame, timestamp );
+    return true;
+}
+
+// Enqueue Frame
+void video_exporter::enqueue( std::unique_lock<std::mutex>& lock, const cv::Mat& frame, const std::chrono::microseconds timestamp )
+{
+    CV_Assert( frame.type() == CV_8UC3 || frame.type() == CV_8UC4 );
+
+    // Reuse Buffer from Pool
+    item target;
+    if( !pool.empty() ){
+        target.frame = pool.back();
+        pool.pop_back();
+    }
+    target.timestamp = timestamp;
+
+    // Copy Frame outside Lock (renderer reuses its buffer)
+    lock.unlock();
+    if( frame.channels() == 4 ){
+        cv::cvtColor( frame, target.frame, cv::COLOR_BGRA2BGR );
+    }
+    else{
+        frame.copyTo( target.frame );
+    }
+    lock.lock();
+
+    queue.push_back( target );
+    pushed_frames++;
+    not_empty.notify_one();
+}
+
+// Close
+void video_exporter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        closing = true;
+    }
+    not_empty.notify_all();
+    not_full.notify_all();
+
+    if( thread.joinable() ){
+        thread.join();
+    }
+}
+
+// Encode Frames
+void video_exporter::encode()
+{
+    while( true ){
+        // Wait Frame (queue is drained before closing)
+        item target;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            not_empty.wait( lock, [&](){ return !queue.empty() || closing; } );
+            if( queue.empty() ){
+                break;
+            }
+            target = queue.front();
+            queue.pop_front();
+        }
+        not_full.notify_one();
+
+        // Encode
+        // NOTE: Exception can not cross thread boundary, failure of sink ends export.
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        try{
+            write( target );
+        }
+        catch( const std::exception& error ){
+            std::cout << error.what() << std::endl;
+            std::lock_guard<std::mutex> lock( mutex );
+            closing = true;
+            queue.clear();
+            not_full.notify_all();
+            break;
+        }
+        const double elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Return Buffer to Pool
+        std::lock_guard<std::mutex> lock( mutex );
+        encode_time += elapsed;
+        pool.push_back( target.frame );
+    }
+}
+
+// Write Frame on Grid of Device Timestamps
+void video_exporter::write( const item& target )
+{
+    // Image Sequence has no Timing
+    if( !sink.is_video() ){
+        sink.write( target.frame );
+        return;
+    }
+
+    // Slot of Frame (rebase on first frame, backward timestamp, or gap longer than 2 seconds)
+    const int64_t max_gap = static_cast<int64_t>( fps * 2.0 );
+    int64_t slot = std::llround( ( target.timestamp - start_timestamp ).count() * fps / 1000000.0 );
+    if( last_frame.empty() || slot < next_slot - 1 || slot > next_slot + max_gap ){
+        start_timestamp = target.timestamp;
+        next_slot = 0;
+        slot = 0;
+    }
+
+    // Skip Frame before its Slot
+    if( slot < next_slot ){
+        skipped_frames++;
+        return;
+    }
+
+    // Repeat Previous Frame to Fill Gap
+    for( ; next_slot < slot; next_slot++ ){
+        sink.write( last_frame );
+        repeated_frames++;
+    }
+
+    sink.write( target.frame );
+    target.frame.copyTo( last_frame );
+    next_slot++;
+}
+
+// Report Statistics
+void video_exporter::report( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    const uint64_t frames = sink.get_frames();
+    stream << "export : " << frames << " frames written (" << pushed_frames << " pushed, " << rejected_frames << " rejected, "
+           << skipped_frames << " skipped, " << repeated_frames << " repeated)" << std::endl;
+    if( frames ){
+        stream << "encode : " << encode_time / frames << " ms/frame, renderer waited " << wait_time << " ms on full queue" << std::endl;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef __EXPORTER__
+#define __EXPORTER__
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sink.hpp"
+
+/*
+ This is video export that encodes rendered frames on dedicated thread.
+
+ video_exporter exporter( "skeleton.mp4", 30.0, cv::Size( 1280, 720 ) );
+ exporter.push( frame, timestamp );     // offline: blocks while queue is full (no frame is lost)
+ exporter.try_push( frame, timestamp ); // live: returns false and drops frame while queue is full
+ exporter.close();                      // drain queue and finalize file
+
+ render thread : push -> bounded queue (frames are copied into pooled buffers) -> encode thread : frame_sink
+ Rendering of next frame overlaps encoding of previous frames.
+ Video keeps timing of device timestamps on constant frame rate grid,
+ frame is dropped if it comes before its slot and previous frame is repeated to fill gaps (dropped frames of device).
+*/
+
+class video_exporter
+{
+private:
+    // Queued Frame
+    struct item
+    {
+        cv::Mat frame;
+        std::chrono::microseconds timestamp;
+    };
+
+    // Sink
+    frame_sink sink;
+    double fps;
+
+    // Bounded Queue and Buffer Pool
+    std::deque<item> queue;
+    std::vector<cv::Mat> pool;
+    size_t capacity;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    bool closing;
+    std::thread thread;
+
+    // Timing (encode thread)
+    std::chrono::microseconds start_timestamp;
+    int64_t next_slot;
+    cv::Mat last_frame;
+
+    // Statistics
+    uint64_t pushed_frames;
+    uint64_t rejected_frames;  // try_push on full queue
+    uint64_t skipped_frames;   // before slot
+    uint64_t repeated_frames;  // gap filling
+    double wait_time;          // render thread blocked on full queue [ms]
+    double encode_time;        // [ms]
+
+public:
+    // Constructor
+    video_exporter( const std::string& output, const double fps, const cv::Size& size, const size_t capacity = 8 );
+
+    // Destructor
+    ~video_exporter();
+
+    // Push Frame (CV_8UC3 or CV_8UC4, blocks while queue is full)
+    void push( const cv::Mat& frame, const std::chrono::microseconds timestamp );
+
+    // Try Push Frame (never blocks, returns false if queue is full)
+    bool try_push( const cv::Mat& frame, const std::chrono::microseconds timestamp );
+
+    // Close (drain queue and join encode thread)
+    void close();
+
+    // Report Statistics
+    void report( std::ostream& stream );
+
+private:
+    // Enqueue Frame (lock is held)
+    void enqueue( std::unique_lock<std::mutex>& lock, const cv::Mat& frame, const std::chrono::microseconds timestamp );
+
+    // Encode Frames
+    void encode();
+
+    // Write Frame on Grid of Device Timestamps
+    void write( const item& target );
+};
+
+#endif // __EXPORTER__
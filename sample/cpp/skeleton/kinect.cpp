@@ -1,11 +1,15 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
 kinect::kinect( const uint32_t index )
-    : device_index( index )
+    : device_index( index ),
+      timestamp( 0 ),
+      export_count( 0 )
 {
     // Initialize
     initialize();
@@ -48,6 +52,9 @@ inline void kinect::initialize_sensor()
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
 
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
     // Get Calibration
     calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
 }
@@ -69,25 +76,20 @@ inline void kinect::initialize_body_tracking()
     // Set Temporal Smoothing Filter [0.0-1.0]
     constexpr float smoothing_factor = K4ABT_DEFAULT_TRACKER_SMOOTHING_FACTOR;
     tracker.set_temporal_smoothing( smoothing_factor );
-
-    // Create Color Table
-    colors.push_back( cv::Vec3b( 255,   0,   0 ) );
-    colors.push_back( cv::Vec3b(   0, 255,   0 ) );
-    colors.push_back( cv::Vec3b(   0,   0, 255 ) );
-    colors.push_back( cv::Vec3b( 255, 255,   0 ) );
-    colors.push_back( cv::Vec3b(   0, 255, 255 ) );
-    colors.push_back( cv::Vec3b( 255,   0, 255 ) );
-    colors.push_back( cv::Vec3b( 128,   0,   0 ) );
-    colors.push_back( cv::Vec3b(   0, 128,   0 ) );
-    colors.push_back( cv::Vec3b(   0,   0, 128 ) );
-    colors.push_back( cv::Vec3b( 128, 128,   0 ) );
-    colors.push_back( cv::Vec3b(   0, 128, 128 ) );
-    colors.push_back( cv::Vec3b( 128,   0, 128 ) );
 }
 
 // Finalize
 void kinect::finalize()
 {
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Finish Export
+    if( exporter ){
+        toggle_export();
+    }
+
     // Destroy Tracker
     tracker.destroy();
 
@@ -105,15 +107,27 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
 
-        // Draw
-        draw();
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
         constexpr int32_t delay = 1;
@@ -121,14 +135,21 @@ void kinect::run()
         if( key == 'q' ){
             break;
         }
+
+        // Start and Stop Export
+        if( key == 'v' ){
+            toggle_export();
+        }
     }
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Update Body Tracking
     update_body_tracking();
@@ -144,17 +165,16 @@ void kinect::update()
 
     // Release Body Frame Handle
     frame.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
-    }
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
 }
 
 // Update Body Tracking
@@ -173,6 +193,9 @@ void kinect::update_inference()
     // Get Image that used for Inference
     k4a::capture capture = frame.get_capture();
     color_image = capture.get_color_image();
+    if( color_image.handle() ){
+        timestamp = color_image.get_device_timestamp();
+    }
 
     // Release Capture Handle
     capture.reset();
@@ -197,6 +220,12 @@ void kinect::draw()
 {
     // Draw Color
     draw_color();
+
+    // Draw Skeleton
+    draw_skeleton();
+
+    // Export Video
+    export_video();
 }
 
 // Draw Color
@@ -213,6 +242,46 @@ inline void kinect::draw_color()
     color_image.reset();
 }
 
+// Draw Skeleton
+inline void kinect::draw_skeleton()
+{
+    if( color.empty() ){
+        return;
+    }
+
+    // Visualize Skeleton
+    render.draw_skeleton( color, bodies, calibration, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR );
+}
+
+// Export Video
+inline void kinect::export_video()
+{
+    if( !exporter || color.empty() ){
+        return;
+    }
+
+    // Push Frame (never blocks capture loop, frame is dropped if encoder falls behind)
+    exporter->try_push( color, timestamp );
+}
+
+// Toggle Export
+void kinect::toggle_export()
+{
+    // Stop (drain queue and report)
+    if( exporter ){
+        exporter->close();
+        exporter->report( std::cout );
+        exporter.reset();
+        return;
+    }
+
+    // Start with Frame Rate of Device
+    const double fps = ( device_configuration.camera_fps == K4A_FRAMES_PER_SECOND_5 ) ? 5.0 : ( device_configuration.camera_fps == K4A_FRAMES_PER_SECOND_15 ) ? 15.0 : 30.0;
+    const std::string output = cv::format( "skeleton_%d.mp4", export_count++ );
+    exporter.reset( new video_exporter( output, fps, color.empty() ? cv::Size( 1280, 720 ) : color.size() ) );
+    std::cout << "export : " << output << std::endl;
+}
+
 // Show
 void kinect::show()
 {
@@ -223,19 +292,8 @@ void kinect::show()
 // Show Skeleton
 inline void kinect::show_skeleton()
 {
-    // Visualize Skeleton
-    for( const k4abt_body_t& body : bodies ){
-        for( const k4abt_joint_t& joint : body.skeleton.joints ){
-            k4a_float2_t position;
-            const bool result = calibration.convert_3d_to_2d( joint.position, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_DEPTH, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR, &position );
-            if( !result ){
-                continue;
-            }
-
-            const int32_t thickness = ( joint.confidence_level >= k4abt_joint_confidence_level_t::K4ABT_JOINT_CONFIDENCE_MEDIUM ) ? -1 : 1;
-            const cv::Point point( static_cast<int32_t>( position.xy.x ), static_cast<int32_t>( position.xy.y ) );
-            cv::circle( color, point, 5, colors[( body.id - 1 ) % colors.size()], thickness );
-        }
+    if( color.empty() ){
+        return;
     }
 
     // Show Image
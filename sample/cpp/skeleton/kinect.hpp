@@ -5,8 +5,15 @@
 #include <k4abt.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <chrono>
+#include <memory>
 #include <vector>
 
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "renderer.hpp"
+#include "exporter.hpp"
+
 class kinect
 {
 private:
@@ -16,10 +23,13 @@ private:
     k4a::calibration calibration;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
 
     // Color
     k4a::image color_image;
     cv::Mat color;
+    std::chrono::microseconds timestamp;
 
     // Body Tracking
     k4abt::tracker tracker;
@@ -29,7 +39,11 @@ private:
     std::vector<k4abt_body_t> bodies;
 
     // Visualize
-    std::vector<cv::Vec3b> colors;
+    renderer render;
+
+    // Export ('v' starts and stops)
+    std::unique_ptr<video_exporter> exporter;
+    uint32_t export_count;
 
 public:
     // Constructor
@@ -42,7 +56,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -64,7 +78,7 @@ private:
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Body Tracking
     void update_body_tracking();
@@ -78,6 +92,15 @@ private:
     // Draw Color
     void draw_color();
 
+    // Draw Skeleton
+    void draw_skeleton();
+
+    // Export Video
+    void export_video();
+
+    // Toggle Export
+    void toggle_export();
+
     // Show Skeleton
     void show_skeleton();
 };
@@ -1,13 +1,25 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "offscreen.hpp"
 
 int main( int argc, char* argv[] )
 {
     try{
-        kinect kinect;
-        kinect.run();
+        const std::string mode = ( argc > 1 ) ? argv[1] : "live";
+        if( mode == "offscreen" ){
+            // Recording without Device and Display (output is video or image sequence such as frames/%06d.png)
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            const std::string output = ( argc > 3 ) ? argv[3] : "skeleton.mp4";
+            render_offscreen( file, output );
+        }
+        else{
+            // Device ('v' starts and stops export of annotated video)
+            kinect kinect;
+            kinect.run();
+        }
     }
     catch( const k4a::error& error ){
         std::cout << error.what() << std::endl;
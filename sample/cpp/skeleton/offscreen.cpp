@@ -0,0 +1,175 @@
+#include "offscreen.hpp"
+#include "renderer.hpp"
+#include "exporter.hpp"
+
+#include <k4a/k4a.hpp>
+#include <k4abt.hpp>
+#include <k4arecord/playback.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Layout of Output Frame (2x2 tiles)
+    constexpr int32_t tile_width = 640;
+    constexpr int32_t tile_height = 360;
+
+    // Get Frame Rate of Recording
+    double get_fps( const k4a_fps_t fps )
+    {
+        switch( fps ){
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_5:
+                return 5.0;
+            case k4a_fps_t::K4A_FRAMES_PER_SECOND_15:
+                return 15.0;
+            default:
+                return 30.0;
+        }
+    }
+
+    // Decode Color Image to BGR (empty if no color image)
+    cv::Mat decode_color( const k4a::image& image )
+    {
+        cv::Mat bgr;
+        if( !image.handle() ){
+            return bgr;
+        }
+
+        const int32_t width = image.get_width_pixels();
+        const int32_t height = image.get_height_pixels();
+        uint8_t* buffer = const_cast<uint8_t*>( image.get_buffer() );
+        switch( image.get_format() ){
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+                bgr = cv::imdecode( cv::Mat( 1, static_cast<int32_t>( image.get_size() ), CV_8UC1, buffer ), cv::IMREAD_COLOR );
+                break;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                cv::cvtColor( cv::Mat( height, width, CV_8UC4, buffer, image.get_stride_bytes() ), bgr, cv::COLOR_BGRA2BGR );
+                break;
+            default:
+                break;
+        }
+        return bgr;
+    }
+}
+
+// Render Offscreen
+void render_offscreen( const std::string& file, const std::string& output )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    const k4a_record_configuration_t record_configuration = playback.get_record_configuration();
+    if( !record_configuration.depth_track_enabled ){
+        throw k4a::error( "Failed to render (recording has no depth track)!" );
+    }
+
+    // Create Tracker with Calibration of Recording
+    const k4a::calibration calibration = playback.get_calibration();
+    k4abt_tracker_configuration_t tracker_configuration = K4ABT_TRACKER_CONFIG_DEFAULT;
+    tracker_configuration.sensor_orientation = K4ABT_SENSOR_ORIENTATION_DEFAULT;
+    tracker_configuration.processing_mode    = k4abt_tracker_processing_mode_t::K4ABT_TRACKER_PROCESSING_MODE_GPU;
+    k4abt::tracker tracker = k4abt::tracker::create( calibration, tracker_configuration );
+    if( !tracker ){
+        throw k4a::error( "Failed to create tracker!" );
+    }
+
+    // Create Transformation for Point Cloud
+    k4a::transformation transformation( calibration );
+
+    // Create Renderer and Sink
+    renderer render;
+    render.set_view( -30.0f, 15.0f );
+    video_exporter exporter( output, get_fps( record_configuration.camera_fps ), cv::Size( tile_width * 2, tile_height * 2 ) );
+    uint64_t frames = 0;
+    cv::Mat canvas( tile_height * 2, tile_width * 2, CV_8UC3 );
+    cv::Mat cloud_view( tile_height, tile_width, CV_8UC3 );
+
+    std::vector<k4abt_body_t> bodies;
+    cv::Mat depth_view;
+    double inference_time = 0.0;
+    double render_time = 0.0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    k4a::capture capture;
+    while( playback.get_next_capture( &capture ) ){
+        if( !capture.get_depth_image().handle() ){
+            continue;
+        }
+
+        // Body Tracking (synchronous, one capture in flight)
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if( !tracker.enqueue_capture( capture ) ){
+            continue;
+        }
+        k4abt::frame frame = tracker.pop_result();
+        inference_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        if( !frame ){
+            continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        bodies.resize( frame.get_num_bodies() );
+        for( uint32_t i = 0; i < bodies.size(); i++ ){
+            bodies[i] = frame.get_body( i );
+        }
+
+        // Images that used for Inference
+        k4a::capture inference = frame.get_capture();
+        const k4a::image depth_image = inference.get_depth_image();
+        const k4a::image body_index_image = frame.get_body_index_map();
+        const cv::Mat depth( depth_image.get_height_pixels(), depth_image.get_width_pixels(), CV_16UC1, const_cast<uint8_t*>( depth_image.get_buffer() ), depth_image.get_stride_bytes() );
+        const cv::Mat body_index( body_index_image.get_height_pixels(), body_index_image.get_width_pixels(), CV_8UC1, const_cast<uint8_t*>( body_index_image.get_buffer() ), body_index_image.get_stride_bytes() );
+
+        // Color + Skeleton
+        cv::Mat color = decode_color( inference.get_color_image() );
+        if( !color.empty() ){
+            render.draw_skeleton( color, bodies, calibration, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_COLOR );
+        }
+        fit_into( color, canvas, cv::Rect( 0, 0, tile_width, tile_height ) );
+
+        // Depth + Body Index + Skeleton
+        render.colorize_depth( depth, depth_view );
+        render.blend_body_index( depth_view, body_index, bodies );
+        render.draw_skeleton( depth_view, bodies, calibration, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_DEPTH );
+        fit_into( depth_view, canvas, cv::Rect( tile_width, 0, tile_width, tile_height ) );
+
+        // Point Cloud from Virtual Camera (colored by depth)
+        const k4a::image xyz_image = transformation.depth_image_to_point_cloud( depth_image, K4A_CALIBRATION_TYPE_DEPTH );
+        const cv::Mat xyz( xyz_image.get_height_pixels(), xyz_image.get_width_pixels(), CV_16SC3, const_cast<uint8_t*>( xyz_image.get_buffer() ), xyz_image.get_stride_bytes() );
+        render.render_point_cloud( xyz, cv::Mat(), cloud_view );
+        cloud_view.copyTo( canvas( cv::Rect( 0, tile_height, tile_width, tile_height ) ) );
+
+        // Information
+        const cv::Rect info( tile_width, tile_height, tile_width, tile_height );
+        canvas( info ).setTo( cv::Scalar::all( 0 ) );
+        cv::putText( canvas, cv::format( "frame %d", static_cast<int32_t>( frames ) ), cv::Point( info.x + 20, info.y + 40 ), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar( 255, 255, 255 ), 2 );
+        cv::putText( canvas, cv::format( "time %.3f s", frame.get_device_timestamp().count() / 1000000.0 ), cv::Point( info.x + 20, info.y + 80 ), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar( 255, 255, 255 ), 2 );
+        cv::putText( canvas, cv::format( "bodies %d", static_cast<int32_t>( bodies.size() ) ), cv::Point( info.x + 20, info.y + 120 ), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar( 255, 255, 255 ), 2 );
+
+        render_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Export Frame (encoded on export thread while next frame is rendered)
+        exporter.push( canvas, frame.get_device_timestamp() );
+        frames++;
+    }
+
+    // Close Playback
+    tracker.destroy();
+    playback.close();
+
+    // Finish Encoding
+    exporter.close();
+
+    // Report
+    if( !frames ){
+        std::cout << "no frames rendered from " << file << std::endl;
+        return;
+    }
+
+    const double total = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+    std::cout << "offscreen : " << frames << " frames in " << total << " s (" << frames / total << " fps) -> " << output << std::endl;
+    std::cout << "inference : " << inference_time / frames << " ms/frame" << std::endl;
+    std::cout << "render    : " << render_time / frames << " ms/frame" << std::endl;
+    exporter.report( std::cout );
+}
@@ -0,0 +1,10 @@
+#ifndef __OFFSCREEN__
+#define __OFFSCREEN__
+
+#include <string>
+
+// Render Annotated Review Frames of Recording without Display (color + skeleton, depth + body index + skeleton, point cloud)
+// Frames are rendered by software renderer and encoded on export thread into video or image sequence (see video_exporter).
+void render_offscreen( const std::string& file, const std::string& output = "skeleton.mp4" );
+
+#endif // __OFFSCREEN__
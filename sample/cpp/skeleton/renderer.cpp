@@ -0,0 +1,229 @@
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Parent of each Joint (K4ABT_JOINT_PELVIS is root, order of k4abt_joint_id_t)
+    constexpr int32_t parents[K4ABT_JOINT_COUNT] = {
+        -1,  0,  1,  2,  2,  4,  5,  6,  7,  8,  7,  2, 11, 12, 13, 14,
+        15, 14,  0, 18, 19, 20,  0, 22, 23, 24,  3, 26, 26, 26, 26, 26
+    };
+
+    // Get Image as BGR (view if already BGR)
+    cv::Mat get_bgr( const cv::Mat& image )
+    {
+        if( image.channels() == 3 ){
+            return image;
+        }
+        cv::Mat bgr;
+        cv::cvtColor( image, bgr, ( image.channels() == 4 ) ? cv::COLOR_BGRA2BGR : cv::COLOR_GRAY2BGR );
+        return bgr;
+    }
+}
+
+// Constructor
+renderer::renderer( const double max_depth )
+    : max_depth( max_depth )
+{
+    // Create Color Table
+    colors.push_back( cv::Vec3b( 255,   0,   0 ) );
+    colors.push_back( cv::Vec3b(   0, 255,   0 ) );
+    colors.push_back( cv::Vec3b(   0,   0, 255 ) );
+    colors.push_back( cv::Vec3b( 255, 255,   0 ) );
+    colors.push_back( cv::Vec3b(   0, 255, 255 ) );
+    colors.push_back( cv::Vec3b( 255,   0, 255 ) );
+    colors.push_back( cv::Vec3b( 128,   0,   0 ) );
+    colors.push_back( cv::Vec3b(   0, 128,   0 ) );
+    colors.push_back( cv::Vec3b(   0,   0, 128 ) );
+    colors.push_back( cv::Vec3b( 128, 128,   0 ) );
+    colors.push_back( cv::Vec3b(   0, 128, 128 ) );
+    colors.push_back( cv::Vec3b( 128,   0, 128 ) );
+
+    // Depth Colormap (near is red, far is blue)
+    cv::Mat gray( 1, 256, CV_8UC1 );
+    for( int32_t i = 0; i < 256; i++ ){
+        gray.at<uint8_t>( 0, i ) = static_cast<uint8_t>( 255 - i );
+    }
+    cv::applyColorMap( gray, depth_lut, cv::COLORMAP_JET );
+
+    // Default View (sensor)
+    set_view( 0.0f, 0.0f );
+}
+
+// Colorize Depth
+void renderer::colorize_depth( const cv::Mat& depth, cv::Mat& image ) const
+{
+    CV_Assert( depth.type() == CV_16UC1 );
+
+    // Depth -> Index of Colormap (invalid depth is black)
+    const cv::Vec3b* lut = depth_lut.ptr<cv::Vec3b>();
+    const double scale = 255.0 / max_depth;
+    image.create( depth.size(), CV_8UC3 );
+    cv::parallel_for_( cv::Range( 0, depth.rows ), [&]( const cv::Range& range ){
+        for( int32_t y = range.start; y < range.end; y++ ){
+            const uint16_t* src = depth.ptr<uint16_t>( y );
+            cv::Vec3b* dst = image.ptr<cv::Vec3b>( y );
+            for( int32_t x = 0; x < depth.cols; x++ ){
+                dst[x] = src[x] ? lut[std::min( 255, static_cast<int32_t>( src[x] * scale ) )] : cv::Vec3b( 0, 0, 0 );
+            }
+        }
+    } );
+}
+
+// Blend Body Index Map into Image
+void renderer::blend_body_index( cv::Mat& image, const cv::Mat& body_index, const std::vector<k4abt_body_t>& bodies, const double alpha ) const
+{
+    CV_Assert( body_index.type() == CV_8UC1 && body_index.size() == image.size() && image.type() == CV_8UC3 );
+
+    // Color of each Body Index
+    cv::Vec3b table[256];
+    bool foreground[256] = {};
+    for( size_t i = 0; i < bodies.size() && i < K4ABT_BODY_INDEX_MAP_BACKGROUND; i++ ){
+        table[i] = get_color( bodies[i].id );
+        foreground[i] = true;
+    }
+
+    // Blend Foreground Pixels
+    const int32_t a = static_cast<int32_t>( alpha * 256.0 );
+    cv::parallel_for_( cv::Range( 0, image.rows ), [&]( const cv::Range& range ){
+        for( int32_t y = range.start; y < range.end; y++ ){
+            const uint8_t* index = body_index.ptr<uint8_t>( y );
+            cv::Vec3b* pixel = image.ptr<cv::Vec3b>( y );
+            for( int32_t x = 0; x < image.cols; x++ ){
+                if( !foreground[index[x]] ){
+                    continue;
+                }
+                const cv::Vec3b& color = table[index[x]];
+                for( int32_t c = 0; c < 3; c++ ){
+                    pixel[x][c] = static_cast<uint8_t>( ( pixel[x][c] * ( 256 - a ) + color[c] * a ) >> 8 );
+                }
+            }
+        }
+    } );
+}
+
+// Draw Skeleton
+void renderer::draw_skeleton( cv::Mat& image, const std::vector<k4abt_body_t>& bodies, const k4a::calibration& calibration, const k4a_calibration_type_t target ) const
+{
+    for( const k4abt_body_t& body : bodies ){
+        const cv::Scalar color( get_color( body.id ) );
+
+        // Project Joints into Target Camera
+        cv::Point points[K4ABT_JOINT_COUNT];
+        bool valid[K4ABT_JOINT_COUNT];
+        for( int32_t i = 0; i < K4ABT_JOINT_COUNT; i++ ){
+            const k4abt_joint_t& joint = body.skeleton.joints[i];
+            k4a_float2_t position;
+            valid[i] = joint.confidence_level > k4abt_joint_confidence_level_t::K4ABT_JOINT_CONFIDENCE_NONE
+                    && calibration.convert_3d_to_2d( joint.position, k4a_calibration_type_t::K4A_CALIBRATION_TYPE_DEPTH, target, &position );
+            if( valid[i] ){
+                points[i] = cv::Point( static_cast<int32_t>( position.xy.x ), static_cast<int32_t>( position.xy.y ) );
+            }
+        }
+
+        // Draw Bones
+        for( int32_t i = 1; i < K4ABT_JOINT_COUNT; i++ ){
+            if( valid[i] && valid[parents[i]] ){
+                cv::line( image, points[i], points[parents[i]], color, 2, cv::LINE_AA );
+            }
+        }
+
+        // Draw Joints (filled if confidence is medium or higher)
+        for( int32_t i = 0; i < K4ABT_JOINT_COUNT; i++ ){
+            if( !valid[i] ){
+                continue;
+            }
+            const int32_t thickness = ( body.skeleton.joints[i].confidence_level >= k4abt_joint_confidence_level_t::K4ABT_JOINT_CONFIDENCE_MEDIUM ) ? -1 : 1;
+            cv::circle( image, points[i], 5, color, thickness );
+        }
+    }
+}
+
+// Set View of Virtual Camera
+void renderer::set_view( const float yaw, const float pitch, const cv::Vec3f& target )
+{
+    // Rotate around Target, Keep Distance from Sensor to Target
+    const float y = yaw * static_cast<float>( CV_PI ) / 180.0f;
+    const float p = pitch * static_cast<float>( CV_PI ) / 180.0f;
+    const cv::Matx33f yaw_rotation( std::cos( y ), 0.0f, std::sin( y ),
+                                    0.0f,          1.0f, 0.0f,
+                                   -std::sin( y ), 0.0f, std::cos( y ) );
+    const cv::Matx33f pitch_rotation( 1.0f, 0.0f,           0.0f,
+                                      0.0f, std::cos( p ), -std::sin( p ),
+                                      0.0f, std::sin( p ),  std::cos( p ) );
+    rotation = pitch_rotation * yaw_rotation;
+    translation = cv::Vec3f( 0.0f, 0.0f, static_cast<float>( cv::norm( target ) ) ) - rotation * target;
+}
+
+// Render Point Cloud
+void renderer::render_point_cloud( const cv::Mat& xyz, const cv::Mat& point_colors, cv::Mat& image )
+{
+    CV_Assert( xyz.type() == CV_16SC3 && !image.empty() && image.type() == CV_8UC3 );
+    CV_Assert( point_colors.empty() || ( point_colors.size() == xyz.size() && point_colors.type() == CV_8UC3 ) );
+
+    // Pinhole of Virtual Camera (75 deg horizontal field of view)
+    const float f = 0.5f * image.cols / std::tan( 37.5f * static_cast<float>( CV_PI ) / 180.0f );
+    const float cx = 0.5f * image.cols;
+    const float cy = 0.5f * image.rows;
+
+    image.setTo( cv::Scalar::all( 0 ) );
+    z_buffer.create( image.size(), CV_32FC1 );
+    z_buffer.setTo( cv::Scalar::all( std::numeric_limits<float>::max() ) );
+
+    // Splat Points with Z-Buffer (2x2 pixels)
+    const cv::Vec3b* lut = depth_lut.ptr<cv::Vec3b>();
+    const float scale = static_cast<float>( 255.0 / max_depth );
+    const int32_t width = image.cols - 1;
+    const int32_t height = image.rows - 1;
+    for( int32_t v = 0; v < xyz.rows; v++ ){
+        const cv::Vec3s* points = xyz.ptr<cv::Vec3s>( v );
+        const cv::Vec3b* point_color = point_colors.empty() ? nullptr : point_colors.ptr<cv::Vec3b>( v );
+        for( int32_t u = 0; u < xyz.cols; u++ ){
+            if( points[u][2] <= 0 ){
+                continue;
+            }
+
+            const cv::Vec3f point = rotation * cv::Vec3f( points[u][0], points[u][1], points[u][2] ) + translation;
+            if( point[2] <= 1.0f ){
+                continue;
+            }
+
+            const int32_t x = static_cast<int32_t>( f * point[0] / point[2] + cx );
+            const int32_t y = static_cast<int32_t>( f * point[1] / point[2] + cy );
+            if( x < 0 || y < 0 || x >= width || y >= height ){
+                continue;
+            }
+
+            const cv::Vec3b color = point_color ? point_color[u] : lut[std::min( 255, static_cast<int32_t>( points[u][2] * scale ) )];
+            for( int32_t dy = 0; dy < 2; dy++ ){
+                float* depth = z_buffer.ptr<float>( y + dy );
+                cv::Vec3b* pixel = image.ptr<cv::Vec3b>( y + dy );
+                for( int32_t dx = 0; dx < 2; dx++ ){
+                    if( point[2] < depth[x + dx] ){
+                        depth[x + dx] = point[2];
+                        pixel[x + dx] = color;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Fit Image into Tile of Canvas
+void fit_into( const cv::Mat& image, cv::Mat& canvas, const cv::Rect& tile )
+{
+    canvas( tile ).setTo( cv::Scalar::all( 0 ) );
+    if( image.empty() ){
+        return;
+    }
+
+    // Scale to Fit with Same Aspect Ratio and Center
+    const double scale = std::min( static_cast<double>( tile.width ) / image.cols, static_cast<double>( tile.height ) / image.rows );
+    const cv::Size size( static_cast<int32_t>( image.cols * scale ), static_cast<int32_t>( image.rows * scale ) );
+    const cv::Rect roi( tile.x + ( tile.width - size.width ) / 2, tile.y + ( tile.height - size.height ) / 2, size.width, size.height );
+    cv::Mat target = canvas( roi );
+    cv::resize( get_bgr( image ), target, size, 0.0, 0.0, cv::INTER_AREA );
+}
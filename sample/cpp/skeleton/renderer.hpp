@@ -0,0 +1,64 @@
+#ifndef __RENDERER__
+#define __RENDERER__
+
+#include <k4a/k4a.hpp>
+#include <k4abt.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <vector>
+
+/*
+ This is software renderer that draws visualizations into cv::Mat framebuffer without window system.
+
+ renderer render;
+ render.colorize_depth( depth, image );                                    // CV_16UC1 -> CV_8UC3
+ render.blend_body_index( image, body_index, bodies );                      // CV_8UC1 (K4ABT_BODY_INDEX_MAP_BACKGROUND is background)
+ render.draw_skeleton( image, bodies, calibration, K4A_CALIBRATION_TYPE_COLOR );
+ render.render_point_cloud( xyz, colors, image );                           // CV_16SC3, CV_8UC3 (optional)
+
+ Everything is rasterized on CPU with OpenCV drawing functions and z-buffered point splatting,
+ so that same code draws live windows (cv::imshow) and offscreen frames on headless servers (no display, no OpenGL context).
+*/
+
+class renderer
+{
+private:
+    // Color Table of Bodies (BGR)
+    std::vector<cv::Vec3b> colors;
+
+    // Depth Colormap (lookup table of 256 entries)
+    cv::Mat depth_lut;
+    double max_depth;
+
+    // Virtual Camera of Point Cloud
+    cv::Matx33f rotation;
+    cv::Vec3f translation;
+    cv::Mat z_buffer;
+
+public:
+    // Constructor (max depth for colormap [mm])
+    renderer( const double max_depth = 5000.0 );
+
+    // Colorize Depth
+    void colorize_depth( const cv::Mat& depth, cv::Mat& image ) const;
+
+    // Blend Body Index Map into Image (same size, body index i is colored by id of bodies[i])
+    void blend_body_index( cv::Mat& image, const cv::Mat& body_index, const std::vector<k4abt_body_t>& bodies, const double alpha = 0.5 ) const;
+
+    // Draw Skeleton (joints are projected from depth camera into target camera)
+    void draw_skeleton( cv::Mat& image, const std::vector<k4abt_body_t>& bodies, const k4a::calibration& calibration, const k4a_calibration_type_t target ) const;
+
+    // Set View of Virtual Camera (orbit around target point [mm] by yaw and pitch [deg])
+    void set_view( const float yaw, const float pitch, const cv::Vec3f& target = cv::Vec3f( 0.0f, 0.0f, 2000.0f ) );
+
+    // Render Point Cloud from Virtual Camera into Image (CV_8UC3, size of image is kept)
+    void render_point_cloud( const cv::Mat& xyz, const cv::Mat& point_colors, cv::Mat& image );
+
+    // Get Body Color (body id starts from 1)
+    const cv::Vec3b& get_color( const uint32_t id ) const { return colors[( id - 1 ) % colors.size()]; }
+};
+
+// Fit Image into Tile of Canvas with Same Aspect Ratio (letterbox)
+void fit_into( const cv::Mat& image, cv::Mat& canvas, const cv::Rect& tile );
+
+#endif // __RENDERER__
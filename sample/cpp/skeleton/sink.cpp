@@ -0,0 +1,52 @@
+#include "sink.hpp"
+
+#include <k4a/k4a.hpp>
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    // Check String Ends with Suffix
+    bool ends_with( const std::string& value, const std::string& suffix )
+    {
+        return value.size() >= suffix.size() && value.compare( value.size() - suffix.size(), suffix.size(), suffix ) == 0;
+    }
+}
+
+// Constructor
+frame_sink::frame_sink( const std::string& output, const double fps, const cv::Size& size )
+    : size( size ),
+      frames( 0 )
+{
+    // Image Sequence
+    if( output.find( '%' ) != std::string::npos ){
+        pattern = output;
+        return;
+    }
+
+    // Video (codec by extension, FFmpeg backend first)
+    const int32_t fourcc = ends_with( output, ".mp4" ) ? cv::VideoWriter::fourcc( 'm', 'p', '4', 'v' )
+                                                       : cv::VideoWriter::fourcc( 'M', 'J', 'P', 'G' );
+    if( !writer.open( output, cv::CAP_FFMPEG, fourcc, fps, size, true ) && !writer.open( output, fourcc, fps, size, true ) ){
+        throw k4a::error( "Failed to open video writer!" );
+    }
+}
+
+// Write Frame
+void frame_sink::write( const cv::Mat& frame )
+{
+    CV_Assert( frame.type() == CV_8UC3 && frame.size() == size );
+
+    if( pattern.empty() ){
+        writer.write( frame );
+    }
+    else{
+        std::vector<char> file( pattern.size() + 32 );
+        std::snprintf( file.data(), file.size(), pattern.c_str(), static_cast<int32_t>( frames ) );
+        if( !cv::imwrite( file.data(), frame ) ){
+            throw k4a::error( "Failed to write image!" );
+        }
+    }
+    frames++;
+}
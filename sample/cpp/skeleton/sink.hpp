@@ -0,0 +1,39 @@
+#ifndef __SINK__
+#define __SINK__
+
+#include <opencv2/opencv.hpp>
+
+#include <string>
+
+/*
+ This is frame sink that writes rendered frames into video file or image sequence.
+ Video is encoded with FFmpeg backend of cv::VideoWriter if available, otherwise with default backend.
+
+ frame_sink sink( "skeleton.mp4", 30.0, cv::Size( 1280, 720 ) ); // video (.mp4, .avi, .mkv)
+ frame_sink sink( "frames/%06d.png", 30.0, cv::Size( 1280, 720 ) ); // image sequence (printf pattern of frame index)
+ sink.write( frame );                                             // CV_8UC3
+*/
+
+class frame_sink
+{
+private:
+    cv::VideoWriter writer;
+    std::string pattern;
+    cv::Size size;
+    uint64_t frames;
+
+public:
+    // Constructor
+    frame_sink( const std::string& output, const double fps, const cv::Size& size );
+
+    // Write Frame
+    void write( const cv::Mat& frame );
+
+    // Check Sink is Video (false: image sequence)
+    bool is_video() const { return pattern.empty(); }
+
+    // Get Number of Written Frames
+    uint64_t get_frames() const { return frames; }
+};
+
+#endif // __SINK__
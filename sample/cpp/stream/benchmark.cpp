@@ -0,0 +1,126 @@
+#include "benchmark.hpp"
+#include "client.hpp"
+#include "server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Client Result
+    struct client_result
+    {
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        double decode_time = 0.0;
+        double elapsed = 0.0;
+        std::vector<double> latencies;
+    };
+
+    // Get Percentile
+    double percentile( std::vector<double> values, const double p )
+    {
+        if( values.empty() ){
+            return 0.0;
+        }
+
+        const size_t index = std::min( values.size() - 1, static_cast<size_t>( p * values.size() ) );
+        std::nth_element( values.begin(), values.begin() + index, values.end() );
+        return values[index];
+    }
+
+    // Create Synthetic Capture
+    k4a::capture create_capture( std::vector<uint8_t>& jpeg )
+    {
+        // Color (Motion JPEG of gradient)
+        cv::Mat bgr( 720, 1280, CV_8UC3 );
+        bgr.forEach<cv::Vec3b>( []( cv::Vec3b& pixel, const int32_t* position ){
+            pixel = cv::Vec3b( static_cast<uint8_t>( position[1] ), static_cast<uint8_t>( position[0] ), static_cast<uint8_t>( position[0] + position[1] ) );
+        } );
+        cv::imencode( ".jpg", bgr, jpeg );
+        k4a::image color = k4a::image::create_from_buffer( k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG, 1280, 720, 0, jpeg.data(), jpeg.size(), nullptr, nullptr );
+
+        // Depth (slanted plane with invalid border)
+        k4a::image depth = k4a::image::create( k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16, 640, 576, 640 * 2 );
+        k4a::image infrared = k4a::image::create( k4a_image_format_t::K4A_IMAGE_FORMAT_IR16, 640, 576, 640 * 2 );
+        uint16_t* depth_buffer = reinterpret_cast<uint16_t*>( depth.get_buffer() );
+        uint16_t* infrared_buffer = reinterpret_cast<uint16_t*>( infrared.get_buffer() );
+        for( int32_t y = 0; y < 576; y++ ){
+            for( int32_t x = 0; x < 640; x++ ){
+                const bool valid = ( x - 320 ) * ( x - 320 ) + ( y - 288 ) * ( y - 288 ) < 300 * 300;
+                depth_buffer[y * 640 + x] = valid ? static_cast<uint16_t>( 1000 + x + y * 2 + ( ( x * 7 + y * 13 ) % 5 ) ) : 0;
+                infrared_buffer[y * 640 + x] = valid ? static_cast<uint16_t>( 200 + ( ( x * 31 + y * 17 ) % 50 ) ) : 0;
+            }
+        }
+
+        k4a::capture capture = k4a::capture::create();
+        capture.set_color_image( color );
+        capture.set_depth_image( depth );
+        capture.set_ir_image( infrared );
+        return capture;
+    }
+}
+
+// Benchmark
+void benchmark( const uint32_t clients, const uint32_t frames, const uint32_t fps, const uint16_t port )
+{
+    std::vector<uint8_t> jpeg;
+    const k4a::capture capture = create_capture( jpeg );
+
+    // Start Server
+    std::unique_ptr<server> stream_server( new server( port ) );
+
+    // Start Clients
+    std::vector<client_result> results( clients );
+    std::vector<std::thread> threads;
+    for( uint32_t i = 0; i < clients; i++ ){
+        threads.emplace_back( [&, i](){
+            client stream_client( "127.0.0.1", port );
+            client::frame frame;
+            client_result& result = results[i];
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            while( stream_client.receive( frame ) ){
+                result.latencies.push_back( frame.latency );
+            }
+            result.elapsed     = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            result.frames      = stream_client.get_received_frames();
+            result.bytes       = stream_client.get_received_bytes();
+            result.decode_time = stream_client.get_decode_time();
+        } );
+    }
+
+    while( stream_server->get_num_clients() < clients ){
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    // Publish Frames
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( uint32_t i = 0; i < frames; i++ ){
+        stream_server->publish( capture );
+        if( fps ){
+            std::this_thread::sleep_until( start + std::chrono::microseconds( 1000000 / fps ) * ( i + 1 ) );
+        }
+    }
+
+    // Drain and Stop Server (disconnects clients)
+    std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+    stream_server.reset();
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    // Report
+    for( uint32_t i = 0; i < clients; i++ ){
+        const client_result& result = results[i];
+        std::cout << "client " << i << " : " << result.frames << " frames, "
+                  << result.bytes * 8.0 / std::max( result.elapsed, 1e-9 ) / 1000000.0 << " Mbps, "
+                  << result.bytes / std::max<uint64_t>( result.frames, 1 ) / 1024.0 << " KB/frame, decode "
+                  << result.decode_time << " ms, latency p50 "
+                  << percentile( result.latencies, 0.50 ) << " ms, p99 "
+                  << percentile( result.latencies, 0.99 ) << " ms" << std::endl;
+    }
+}
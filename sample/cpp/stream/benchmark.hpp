@@ -0,0 +1,9 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+
+// Benchmark Server and N Clients over Loopback with Synthetic MJPG 720p + NFOV Depth + IR Frames
+void benchmark( const uint32_t clients, const uint32_t frames = 300, const uint32_t fps = 30, const uint16_t port = 7778 );
+
+#endif // __BENCHMARK__
@@ -0,0 +1,115 @@
+#include "client.hpp"
+#include "codec.hpp"
+
+#include <k4a/k4a.hpp>
+
+// Constructor
+client::client( const std::string& host, const uint16_t port, const uint32_t streams, const uint32_t max_fps )
+    : socket( network::socket::connect( host, port ) ),
+      received_frames( 0 ),
+      received_bytes( 0 ),
+      decode_time( 0.0 )
+{
+    // Send Request
+    protocol::request request = {};
+    request.magic   = protocol::magic;
+    request.streams = streams;
+    request.max_fps = max_fps;
+    if( !socket.send( &request, sizeof( request ) ) ){
+        throw k4a::error( "Failed to send request!" );
+    }
+}
+
+// Receive
+bool client::receive( frame& output )
+{
+    // Receive Frame Header
+    protocol::frame_header header;
+    if( !socket.receive( &header, sizeof( header ) ) ){
+        return false;
+    }
+
+    if( header.magic != protocol::magic ){
+        throw k4a::error( "Failed to receive frame (broken stream)!" );
+    }
+
+    output.frame_number = header.frame_number;
+    output.bytes = sizeof( header );
+
+    // Receive and Decode Images
+    double decode = 0.0;
+    for( uint32_t i = 0; i < protocol::stream::count; i++ ){
+        output.images[i].release();
+        output.device_timestamp_usec[i] = 0;
+        if( !( header.streams & ( 1 << i ) ) ){
+            continue;
+        }
+
+        protocol::image_header image_header;
+        if( !socket.receive( &image_header, sizeof( image_header ) ) ){
+            return false;
+        }
+
+        constexpr uint64_t max_size = 256 * 1024 * 1024;
+        constexpr int32_t max_resolution = 8192;
+        if( image_header.size > max_size || image_header.width <= 0 || image_header.height <= 0 || image_header.width > max_resolution || image_header.height > max_resolution ){
+            throw k4a::error( "Failed to receive frame (broken stream)!" );
+        }
+
+        payload.resize( image_header.size );
+        if( !socket.receive( payload.data(), payload.size() ) ){
+            return false;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if( !decode_image( image_header, output.images[i] ) ){
+            throw k4a::error( "Failed to decode image!" );
+        }
+        decode += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        output.device_timestamp_usec[i] = image_header.device_timestamp_usec;
+        output.bytes += sizeof( image_header ) + image_header.size;
+    }
+
+    output.latency = ( protocol::now_nsec() - header.capture_timestamp_nsec ) / 1000000.0;
+
+    received_frames++;
+    received_bytes += output.bytes;
+    decode_time += decode;
+
+    return true;
+}
+
+// Decode Image
+bool client::decode_image( const protocol::image_header& header, cv::Mat& image )
+{
+    switch( header.codec ){
+        case protocol::codec::rvl:
+        {
+            image.create( header.height, header.width, CV_16UC1 );
+            return codec::decode_rvl( payload.data(), payload.size(), image.ptr<uint16_t>(), image.total() );
+        }
+        case protocol::codec::jpeg:
+        {
+            image = cv::imdecode( payload, cv::IMREAD_COLOR );
+            if( image.empty() ){
+                return false;
+            }
+            cv::cvtColor( image, image, cv::COLOR_BGR2BGRA );
+            return true;
+        }
+        case protocol::codec::raw:
+        {
+            if( header.format == k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32 && payload.size() >= static_cast<size_t>( header.width ) * header.height * 4 ){
+                image = cv::Mat( header.height, header.width, CV_8UC4, payload.data() ).clone();
+            }
+            else{
+                // NOTE: Other formats are exposed as raw bytes.
+                image = cv::Mat( 1, static_cast<int32_t>( payload.size() ), CV_8UC1, payload.data() ).clone();
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
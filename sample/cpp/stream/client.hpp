@@ -0,0 +1,56 @@
+#ifndef __CLIENT__
+#define __CLIENT__
+
+#include <opencv2/opencv.hpp>
+
+#include <string>
+#include <vector>
+
+#include "protocol.hpp"
+#include "socket.hpp"
+
+class client
+{
+public:
+    // Received Frame
+    struct frame
+    {
+        uint64_t frame_number = 0;
+        cv::Mat images[protocol::stream::count];          // color (BGRA), depth (16U), infrared (16U)
+        int64_t device_timestamp_usec[protocol::stream::count] = {};
+        double latency = 0.0;                             // capture to decoded [ms] (same host only)
+        uint64_t bytes = 0;                               // bytes on wire
+    };
+
+private:
+    // Network
+    network::socket socket;
+    std::vector<uint8_t> payload;
+
+    // Statistics
+    uint64_t received_frames;
+    uint64_t received_bytes;
+    double decode_time;
+
+public:
+    // Constructor
+    client( const std::string& host, const uint16_t port = protocol::default_port, const uint32_t streams = protocol::stream_mask::all_mask, const uint32_t max_fps = 0 );
+
+    // Receive Frame (blocking, returns false when server disconnected)
+    bool receive( frame& output );
+
+    // Get Number of Received Frames
+    uint64_t get_received_frames() const { return received_frames; }
+
+    // Get Number of Received Bytes
+    uint64_t get_received_bytes() const { return received_bytes; }
+
+    // Get Average Decode Time [ms]
+    double get_decode_time() const { return received_frames ? decode_time / received_frames : 0.0; }
+
+private:
+    // Decode Image
+    bool decode_image( const protocol::image_header& header, cv::Mat& image );
+};
+
+#endif // __CLIENT__
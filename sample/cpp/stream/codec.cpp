@@ -0,0 +1,185 @@
+#include "codec.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+namespace codec
+{
+    namespace
+    {
+        // Nibble Writer
+        class nibble_writer
+        {
+        private:
+            uint8_t* buffer;
+            uint32_t word;
+            int32_t nibbles;
+
+        public:
+            // Constructor
+            nibble_writer( uint8_t* buffer )
+                : buffer( buffer ), word( 0 ), nibbles( 0 )
+            {
+            }
+
+            // Write Variable-Length Value
+            inline void write( uint32_t value )
+            {
+                do{
+                    uint32_t nibble = value & 0x7;
+                    if( value >>= 3 ){
+                        nibble |= 0x8;
+                    }
+
+                    word = ( word << 4 ) | nibble;
+                    if( ++nibbles == 8 ){
+                        flush_word();
+                    }
+                } while( value );
+            }
+
+            // Flush Remaining Nibbles
+            inline uint8_t* finish()
+            {
+                if( nibbles ){
+                    word <<= 4 * ( 8 - nibbles );
+                    flush_word();
+                }
+
+                return buffer;
+            }
+
+        private:
+            // Flush Word
+            inline void flush_word()
+            {
+                std::memcpy( buffer, &word, sizeof( word ) );
+                buffer += sizeof( word );
+                word = 0;
+                nibbles = 0;
+            }
+        };
+
+        // Nibble Reader
+        class nibble_reader
+        {
+        private:
+            const uint8_t* buffer;
+            const uint8_t* end;
+            uint32_t word;
+            int32_t nibbles;
+
+        public:
+            // Constructor
+            nibble_reader( const uint8_t* buffer, const size_t size )
+                : buffer( buffer ), end( buffer + size ), word( 0 ), nibbles( 0 )
+            {
+            }
+
+            // Read Variable-Length Value
+            inline bool read( uint32_t& value )
+            {
+                value = 0;
+                for( int32_t shift = 0; shift < 32; shift += 3 ){
+                    if( !nibbles ){
+                        if( end - buffer < static_cast<ptrdiff_t>( sizeof( word ) ) ){
+                            return false;
+                        }
+
+                        std::memcpy( &word, buffer, sizeof( word ) );
+                        buffer += sizeof( word );
+                        nibbles = 8;
+                    }
+
+                    const uint32_t nibble = word >> 28;
+                    word <<= 4;
+                    nibbles--;
+
+                    value |= ( nibble & 0x7 ) << shift;
+                    if( !( nibble & 0x8 ) ){
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+        };
+    }
+
+    // Encode RVL
+    size_t encode_rvl( const uint16_t* input, const size_t num_pixels, std::vector<uint8_t>& output )
+    {
+        output.resize( get_max_rvl_size( num_pixels ) );
+        nibble_writer writer( output.data() );
+
+        const uint16_t* end = input + num_pixels;
+        int32_t previous = 0;
+        while( input != end ){
+            // Zero Run
+            uint32_t zeros = 0;
+            for( ; input != end && !*input; input++ ){
+                zeros++;
+            }
+            writer.write( zeros );
+
+            // Non-Zero Run
+            uint32_t nonzeros = 0;
+            for( const uint16_t* pixel = input; pixel != end && *pixel; pixel++ ){
+                nonzeros++;
+            }
+            writer.write( nonzeros );
+
+            // Zigzag Deltas
+            for( uint32_t i = 0; i < nonzeros; i++ ){
+                const int32_t current = *input++;
+                const int32_t delta = current - previous;
+                writer.write( ( static_cast<uint32_t>( delta ) << 1 ) ^ static_cast<uint32_t>( delta >> 31 ) );
+                previous = current;
+            }
+        }
+
+        const size_t size = writer.finish() - output.data();
+        output.resize( size );
+        return size;
+    }
+
+    // Decode RVL
+    bool decode_rvl( const uint8_t* input, const size_t size, uint16_t* output, const size_t num_pixels )
+    {
+        nibble_reader reader( input, size );
+
+        size_t remaining = num_pixels;
+        int32_t previous = 0;
+        while( remaining ){
+            // Zero Run
+            uint32_t zeros = 0;
+            if( !reader.read( zeros ) || zeros > remaining ){
+                return false;
+            }
+            std::memset( output, 0, zeros * sizeof( uint16_t ) );
+            output += zeros;
+            remaining -= zeros;
+
+            // Non-Zero Run
+            uint32_t nonzeros = 0;
+            if( !reader.read( nonzeros ) || nonzeros > remaining ){
+                return false;
+            }
+            remaining -= nonzeros;
+
+            // Zigzag Deltas
+            for( uint32_t i = 0; i < nonzeros; i++ ){
+                uint32_t positive = 0;
+                if( !reader.read( positive ) ){
+                    return false;
+                }
+
+                const int32_t delta = static_cast<int32_t>( positive >> 1 ) ^ -static_cast<int32_t>( positive & 1 );
+                previous += delta;
+                *output++ = static_cast<uint16_t>( previous );
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef __CODEC__
+#define __CODEC__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ This is lossless codec for 16-bit depth (and infrared) images.
+
+ It implements RVL (Run-length Variable-Length) encoding.
+ Zero and non-zero pixels are coded as runs, non-zero pixels are coded as zigzag deltas from previous pixel.
+ All values are written as variable-length nibbles (3 bits value + 1 bit continuation).
+
+ A. D. Wilson, "Fast Lossless Depth Image Compression", ACM ISS 2017.
+*/
+
+namespace codec
+{
+    // Get Worst Case Encoded Size
+    inline size_t get_max_rvl_size( const size_t num_pixels )
+    {
+        // 6 nibbles per pixel (17-bit zigzag delta) + 2 run lengths per pixel (at most 11 nibbles each)
+        return ( num_pixels * 28 / 8 + 16 ) & ~static_cast<size_t>( 3 );
+    }
+
+    // Encode RVL (returns encoded size in bytes)
+    size_t encode_rvl( const uint16_t* input, const size_t num_pixels, std::vector<uint8_t>& output );
+
+    // Decode RVL (returns false if input is malformed)
+    bool decode_rvl( const uint8_t* input, const size_t size, uint16_t* output, const size_t num_pixels );
+}
+
+#endif // __CODEC__
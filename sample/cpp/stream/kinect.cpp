@@ -0,0 +1,205 @@
+#include "kinect.hpp"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Constructor
+kinect::kinect( const uint32_t index, const uint16_t port )
+    : device_index( index ),
+      port( port )
+{
+    // Initialize
+    initialize();
+}
+
+kinect::~kinect()
+{
+    // Finalize
+    finalize();
+}
+
+// Initialize
+void kinect::initialize()
+{
+    // Initialize Sensor
+    initialize_sensor();
+
+    // Initialize Server
+    initialize_server();
+}
+
+// Initialize Sensor
+inline void kinect::initialize_sensor()
+{
+    // Get Connected Devices
+    const int32_t device_count = k4a::device::get_installed_count();
+    if( device_count == 0 ){
+        throw k4a::error( "Failed to found device!" );
+    }
+
+    // Open Default Device
+    device = k4a::device::open( device_index );
+
+    // Start Cameras with Configuration
+    // NOTE: Motion JPEG is passed through to clients without re-encoding.
+    device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
+    device_configuration.color_format             = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG;
+    device_configuration.color_resolution         = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    device_configuration.depth_mode               = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
+    device_configuration.synchronized_images_only = true;
+    device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
+    device.start_cameras( &device_configuration );
+
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+}
+
+// Initialize Server
+inline void kinect::initialize_server()
+{
+    // Start Stream Server
+    stream_server.reset( new server( port ) );
+    std::cout << "listen port " << port << std::endl;
+}
+
+// Finalize
+void kinect::finalize()
+{
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Stop Stream Server
+    stream_server.reset();
+
+    // Stop Cameras
+    device.stop_cameras();
+
+    // Close Device
+    device.close();
+
+    // Close Window
+    cv::destroyAllWindows();
+}
+
+// Run
+void kinect::run()
+{
+    // Main Loop
+    bool updated = false;
+    while( true ){
+        // Update (as soon as next frame is ready)
+        if( update() ){
+            // Draw
+            draw();
+
+            loop.count_frame();
+            updated = true;
+        }
+
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
+
+        // Show
+        if( updated ){
+            show();
+            updated = false;
+        }
+
+        // Wait Key
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            break;
+        }
+    }
+}
+
+// Update
+bool kinect::update()
+{
+    // Update Frame
+    if( !update_frame() ){
+        return false;
+    }
+
+    // Publish Frame
+    publish_frame();
+
+    // Update Depth
+    update_depth();
+
+    // Release Capture Handle
+    capture.reset();
+
+    return true;
+}
+
+// Update Frame
+inline bool kinect::update_frame()
+{
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
+}
+
+// Publish Frame
+inline void kinect::publish_frame()
+{
+    // Publish Capture to Clients (encoding and sending run on other threads)
+    stream_server->publish( capture );
+}
+
+// Update Depth
+inline void kinect::update_depth()
+{
+    // Get Depth Image
+    depth_image = capture.get_depth_image();
+}
+
+// Draw
+void kinect::draw()
+{
+    // Draw Depth
+    draw_depth();
+}
+
+// Draw Depth
+inline void kinect::draw_depth()
+{
+    if( !depth_image.handle() ){
+        return;
+    }
+
+    // Get cv::Mat from k4a::image
+    depth = k4a::get_mat( depth_image );
+
+    // Release Depth Image Handle
+    depth_image.reset();
+}
+
+// Show
+void kinect::show()
+{
+    // Show Depth
+    show_depth();
+}
+
+// Show Depth
+inline void kinect::show_depth()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Scaling Depth
+    depth.convertTo( depth, CV_8U, -255.0 / 5000.0, 255.0 );
+
+    // Show Image
+    const cv::String window_name = cv::format( "depth (kinect %d)", device_index );
+    cv::imshow( window_name, depth );
+}
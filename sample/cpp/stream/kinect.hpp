@@ -0,0 +1,80 @@
+#ifndef __KINECT__
+#define __KINECT__
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <memory>
+
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "server.hpp"
+
+class kinect
+{
+private:
+    // Kinect
+    k4a::device device;
+    k4a::capture capture;
+    k4a_device_configuration_t device_configuration;
+    uint32_t device_index;
+    capture_poller poller;
+    scheduler loop;
+
+    // Server
+    std::unique_ptr<server> stream_server;
+    uint16_t port;
+
+    // Depth
+    k4a::image depth_image;
+    cv::Mat depth;
+
+public:
+    // Constructor
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT, const uint16_t port = protocol::default_port );
+
+    // Destructor
+    ~kinect();
+
+    // Run
+    void run();
+
+    // Update
+    bool update();
+
+    // Draw
+    void draw();
+
+    // Show
+    void show();
+
+private:
+    // Initialize
+    void initialize();
+
+    // Initialize Sensor
+    void initialize_sensor();
+
+    // Initialize Server
+    void initialize_server();
+
+    // Finalize
+    void finalize();
+
+    // Update Frame
+    bool update_frame();
+
+    // Publish Frame
+    void publish_frame();
+
+    // Update Depth
+    void update_depth();
+
+    // Draw Depth
+    void draw_depth();
+
+    // Show Depth
+    void show_depth();
+};
+
+#endif // __KINECT__
@@ -0,0 +1,41 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "kinect.hpp"
+#include "receiver.hpp"
+#include "benchmark.hpp"
+
+int main( int argc, char* argv[] )
+{
+    try{
+        const std::string mode = ( argc > 1 ) ? argv[1] : "server";
+        if( mode == "client" ){
+            // Client
+            const std::string host = ( argc > 2 ) ? argv[2] : "127.0.0.1";
+            const uint16_t port    = ( argc > 3 ) ? static_cast<uint16_t>( std::atoi( argv[3] ) ) : protocol::default_port;
+            const uint32_t max_fps = ( argc > 4 ) ? std::atoi( argv[4] ) : 0;
+            receiver receiver( host, port, max_fps );
+            receiver.run();
+        }
+        else if( mode == "benchmark" ){
+            // Loopback without Device
+            const uint32_t clients = ( argc > 2 ) ? std::atoi( argv[2] ) : 1;
+            const uint32_t frames  = ( argc > 3 ) ? std::atoi( argv[3] ) : 300;
+            const uint32_t fps     = ( argc > 4 ) ? std::atoi( argv[4] ) : 30;
+            benchmark( clients, frames, fps );
+        }
+        else{
+            // Server
+            const uint16_t port = ( argc > 2 ) ? static_cast<uint16_t>( std::atoi( argv[2] ) ) : protocol::default_port;
+            kinect kinect( K4A_DEVICE_DEFAULT, port );
+            kinect.run();
+        }
+    }
+    catch( const k4a::error& error ){
+        std::cout << error.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#ifndef __PROTOCOL__
+#define __PROTOCOL__
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/*
+ This is wire protocol of stream server and client.
+
+ Client -> Server : request
+ Server -> Client : frame_header, image_header x N, payload x N (repeated)
+
+ All fields are little-endian (same as host byte order on supported platforms).
+*/
+
+namespace protocol
+{
+    constexpr uint32_t magic = 0x4b345354; // "K4ST"
+    constexpr uint16_t default_port = 7777;
+
+    // Stream
+    enum stream : uint32_t
+    {
+        color = 0,
+        depth,
+        infrared,
+        count
+    };
+
+    // Stream Mask
+    enum stream_mask : uint32_t
+    {
+        color_mask    = 1 << stream::color,
+        depth_mask    = 1 << stream::depth,
+        infrared_mask = 1 << stream::infrared,
+        all_mask      = color_mask | depth_mask | infrared_mask
+    };
+
+    // Codec
+    enum codec : int32_t
+    {
+        raw  = 0, // as is (k4a_image_format_t)
+        rvl  = 1, // lossless 16-bit (depth, infrared)
+        jpeg = 2  // motion jpeg (passthrough when device delivers MJPG)
+    };
+
+    // Request
+    struct request
+    {
+        uint32_t magic;
+        uint32_t streams;
+        uint32_t max_fps; // 0 = as fast as possible
+        uint32_t reserved;
+    };
+
+    // Frame Header
+    struct frame_header
+    {
+        uint32_t magic;
+        uint32_t streams;
+        uint64_t frame_number;
+        int64_t  capture_timestamp_nsec; // steady clock of server (latency on same host)
+        int64_t  send_timestamp_nsec;
+    };
+
+    // Image Header
+    struct image_header
+    {
+        int32_t  codec;
+        int32_t  format;
+        int32_t  width;
+        int32_t  height;
+        int64_t  device_timestamp_usec;
+        uint64_t size;
+        uint64_t raw_size;
+    };
+
+    // Get Steady Clock Timestamp
+    inline int64_t now_nsec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+}
+
+#endif // __PROTOCOL__
@@ -0,0 +1,127 @@
+#include "receiver.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+// Constructor
+receiver::receiver( const std::string& host, const uint16_t port, const uint32_t max_fps )
+    : stream_client( host, port, protocol::stream_mask::color_mask | protocol::stream_mask::depth_mask, max_fps ),
+      latency( 0.0 ),
+      max_latency( 0.0 ),
+      start( std::chrono::steady_clock::now() )
+{
+}
+
+// Destructor
+receiver::~receiver()
+{
+    // Report Statistics
+    report_statistics();
+
+    // Close Window
+    cv::destroyAllWindows();
+}
+
+// Run
+void receiver::run()
+{
+    // Main Loop
+    while( true ){
+        // Update
+        if( !update() ){
+            break;
+        }
+
+        // Draw
+        draw();
+
+        // Show
+        show();
+
+        // Wait Key
+        constexpr int32_t delay = 1;
+        const int32_t key = cv::waitKey( delay );
+        if( key == 'q' ){
+            break;
+        }
+    }
+}
+
+// Update
+bool receiver::update()
+{
+    // Receive Frame
+    if( !stream_client.receive( frame ) ){
+        return false;
+    }
+
+    latency += frame.latency;
+    max_latency = std::max( max_latency, frame.latency );
+
+    // Report Statistics every 100 Frames
+    if( stream_client.get_received_frames() % 100 == 0 ){
+        report_statistics();
+    }
+
+    return true;
+}
+
+// Report Statistics
+inline void receiver::report_statistics()
+{
+    const uint64_t frames = stream_client.get_received_frames();
+    if( frames == 0 ){
+        return;
+    }
+
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    std::cout << "frames "    << frames
+              << ", fps "     << frames / elapsed
+              << ", Mbps "    << stream_client.get_received_bytes() * 8.0 / elapsed / 1000000.0
+              << ", decode "  << stream_client.get_decode_time() << " ms"
+              << ", latency " << latency / frames << " ms (max " << max_latency << " ms)" << std::endl;
+}
+
+// Draw
+void receiver::draw()
+{
+    // Color
+    color = frame.images[protocol::stream::color];
+
+    // Scaling Depth
+    if( !frame.images[protocol::stream::depth].empty() ){
+        frame.images[protocol::stream::depth].convertTo( depth, CV_8U, -255.0 / 5000.0, 255.0 );
+    }
+}
+
+// Show
+void receiver::show()
+{
+    // Show Color
+    show_color();
+
+    // Show Depth
+    show_depth();
+}
+
+// Show Color
+inline void receiver::show_color()
+{
+    if( color.empty() ){
+        return;
+    }
+
+    // Show Image
+    cv::imshow( "color (stream)", color );
+}
+
+// Show Depth
+inline void receiver::show_depth()
+{
+    if( depth.empty() ){
+        return;
+    }
+
+    // Show Image
+    cv::imshow( "depth (stream)", depth );
+}
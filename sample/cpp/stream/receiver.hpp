@@ -0,0 +1,59 @@
+#ifndef __RECEIVER__
+#define __RECEIVER__
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <string>
+
+#include "client.hpp"
+
+class receiver
+{
+private:
+    // Client
+    client stream_client;
+    client::frame frame;
+
+    // Color
+    cv::Mat color;
+
+    // Depth
+    cv::Mat depth;
+
+    // Statistics
+    double latency;
+    double max_latency;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    // Constructor
+    receiver( const std::string& host, const uint16_t port = protocol::default_port, const uint32_t max_fps = 0 );
+
+    // Destructor
+    ~receiver();
+
+    // Run
+    void run();
+
+    // Update
+    bool update();
+
+    // Draw
+    void draw();
+
+    // Show
+    void show();
+
+private:
+    // Report Statistics
+    void report_statistics();
+
+    // Show Color
+    void show_color();
+
+    // Show Depth
+    void show_depth();
+};
+
+#endif // __RECEIVER__
@@ -0,0 +1,295 @@
+#include "server.hpp"
+#include "codec.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include <cstring>
+#include <iostream>
+
+// Constructor
+server::server( const uint16_t port )
+    : listener( network::socket::listen( port ) ),
+      running( true ),
+      pending_timestamp( 0 ),
+      frame_number( 0 ),
+      encoded_frames( 0 ),
+      skipped_frames( 0 ),
+      raw_bytes( 0 ),
+      encoded_bytes( 0 ),
+      encode_time( 0.0 )
+{
+    // Start Threads
+    accept_thread = std::thread( &server::accept, this );
+    encode_thread = std::thread( &server::encode, this );
+}
+
+// Destructor
+server::~server()
+{
+    // Stop Encoder
+    {
+        std::lock_guard<std::mutex> lock( encode_mutex );
+        running = false;
+    }
+    encode_condition.notify_all();
+    encode_thread.join();
+
+    // Stop Accepting
+    listener.shutdown();
+    #ifdef _WIN32
+    listener.close();
+    #endif
+    accept_thread.join();
+
+    // Stop Sessions
+    std::lock_guard<std::mutex> lock( sessions_mutex );
+    for( std::shared_ptr<session>& client : sessions ){
+        {
+            std::lock_guard<std::mutex> lock( client->mutex );
+            client->running = false;
+        }
+        client->condition.notify_all();
+        client->socket.shutdown();
+        client->thread.join();
+    }
+
+    // Report Statistics
+    report();
+}
+
+// Publish
+void server::publish( const k4a::capture& capture )
+{
+    {
+        std::lock_guard<std::mutex> lock( encode_mutex );
+        if( pending_capture ){
+            // Encoder is behind, replace with newer capture
+            skipped_frames++;
+        }
+        pending_capture = capture;
+        pending_timestamp = protocol::now_nsec();
+    }
+    encode_condition.notify_one();
+}
+
+// Get Number of Clients
+size_t server::get_num_clients()
+{
+    std::lock_guard<std::mutex> lock( sessions_mutex );
+    return sessions.size();
+}
+
+// Accept
+void server::accept()
+{
+    while( running ){
+        // Wait Client
+        network::socket socket = listener.accept();
+        if( !socket.is_valid() ){
+            break;
+        }
+
+        // Start Session
+        std::shared_ptr<session> client = std::make_shared<session>( std::move( socket ) );
+        std::lock_guard<std::mutex> lock( sessions_mutex );
+        client->thread = std::thread( &server::send, this, client );
+        sessions.push_back( client );
+    }
+}
+
+// Encode
+void server::encode()
+{
+    while( true ){
+        // Wait Capture
+        k4a::capture capture;
+        int64_t timestamp = 0;
+        {
+            std::unique_lock<std::mutex> lock( encode_mutex );
+            encode_condition.wait( lock, [&](){ return pending_capture || !running; } );
+            if( !running ){
+                break;
+            }
+            capture = std::move( pending_capture );
+            pending_capture.reset();
+            timestamp = pending_timestamp;
+        }
+
+        // Encode Once for All Clients
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::shared_ptr<const packet> packet = encode_capture( capture, timestamp );
+        encode_time += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+        capture.reset();
+
+        // Distribute
+        distribute( packet );
+    }
+}
+
+// Encode Capture
+std::shared_ptr<server::packet> server::encode_capture( const k4a::capture& capture, const int64_t timestamp )
+{
+    std::shared_ptr<packet> frame = std::make_shared<packet>();
+    frame->header.magic                  = protocol::magic;
+    frame->header.streams                = 0;
+    frame->header.frame_number           = ++frame_number;
+    frame->header.capture_timestamp_nsec = timestamp;
+    frame->header.send_timestamp_nsec    = 0;
+
+    const k4a::image images[protocol::stream::count] = { capture.get_color_image(), capture.get_depth_image(), capture.get_ir_image() };
+    for( uint32_t i = 0; i < protocol::stream::count; i++ ){
+        std::memset( &frame->images[i], 0, sizeof( protocol::image_header ) );
+        if( !images[i].handle() ){
+            continue;
+        }
+
+        encode_image( images[i], frame->images[i], frame->payloads[i] );
+        frame->header.streams |= 1 << i;
+        raw_bytes     += frame->images[i].raw_size;
+        encoded_bytes += frame->images[i].size;
+    }
+
+    encoded_frames++;
+    return frame;
+}
+
+// Encode Image
+void server::encode_image( const k4a::image& image, protocol::image_header& header, std::vector<uint8_t>& payload )
+{
+    header.format                = image.get_format();
+    header.width                 = image.get_width_pixels();
+    header.height                = image.get_height_pixels();
+    header.device_timestamp_usec = image.get_device_timestamp().count();
+    header.raw_size              = static_cast<uint64_t>( header.width ) * header.height * ( header.format == k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG ? 4 : image.get_stride_bytes() / header.width );
+
+    uint8_t* buffer = const_cast<uint8_t*>( image.get_buffer() );
+    switch( image.get_format() ){
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+        {
+            // Passthrough Compressed Color
+            header.codec = protocol::codec::jpeg;
+            payload.assign( buffer, buffer + image.get_size() );
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+        {
+            // NOTE: This is lossy. Configure device with MJPG to avoid re-encoding.
+            const cv::Mat bgra( header.height, header.width, CV_8UC4, buffer, image.get_stride_bytes() );
+            const std::vector<int32_t> parameters = { cv::IMWRITE_JPEG_QUALITY, 90 };
+            cv::imencode( ".jpg", bgra, payload, parameters );
+            header.codec = protocol::codec::jpeg;
+            break;
+        }
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16:
+        case k4a_image_format_t::K4A_IMAGE_FORMAT_IR16:
+        {
+            // Lossless Depth/Infrared
+            header.codec = protocol::codec::rvl;
+            codec::encode_rvl( reinterpret_cast<const uint16_t*>( buffer ), static_cast<size_t>( header.width ) * header.height, payload );
+            break;
+        }
+        default:
+        {
+            header.codec = protocol::codec::raw;
+            payload.assign( buffer, buffer + image.get_size() );
+            break;
+        }
+    }
+
+    header.size = payload.size();
+}
+
+// Distribute
+void server::distribute( const std::shared_ptr<const packet>& packet )
+{
+    std::lock_guard<std::mutex> lock( sessions_mutex );
+    for( std::vector<std::shared_ptr<session>>::iterator it = sessions.begin(); it != sessions.end(); ){
+        std::shared_ptr<session>& client = *it;
+
+        // Remove Disconnected Session
+        if( !client->running ){
+            client->thread.join();
+            std::cout << "client disconnected (sent " << client->sent_frames << " frames, dropped " << client->dropped_frames << " frames, " << client->sent_bytes / ( 1024.0 * 1024.0 ) << " MB)" << std::endl;
+            it = sessions.erase( it );
+            continue;
+        }
+
+        // Replace Pending Frame (slow client receives latest frame only)
+        {
+            std::lock_guard<std::mutex> lock( client->mutex );
+            if( client->pending ){
+                client->dropped_frames++;
+            }
+            client->pending = packet;
+        }
+        client->condition.notify_one();
+        ++it;
+    }
+}
+
+// Send
+void server::send( const std::shared_ptr<session> client )
+{
+    // Receive Request
+    if( !client->socket.receive( &client->request, sizeof( protocol::request ) ) || client->request.magic != protocol::magic ){
+        client->running = false;
+        return;
+    }
+
+    const std::chrono::nanoseconds interval( client->request.max_fps ? 1000000000 / client->request.max_fps : 0 );
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while( true ){
+        // Per-Client Pacing
+        if( interval.count() ){
+            std::this_thread::sleep_until( next );
+            next = std::max( next + interval, std::chrono::steady_clock::now() - interval );
+        }
+
+        // Wait Latest Frame
+        std::shared_ptr<const packet> frame;
+        {
+            std::unique_lock<std::mutex> lock( client->mutex );
+            client->condition.wait( lock, [&](){ return client->pending || !client->running; } );
+            if( !client->running ){
+                break;
+            }
+            frame = std::move( client->pending );
+            client->pending.reset();
+        }
+
+        // Send Requested Streams
+        protocol::frame_header header = frame->header;
+        header.streams &= client->request.streams;
+        header.send_timestamp_nsec = protocol::now_nsec();
+
+        bool result = client->socket.send( &header, sizeof( header ) );
+        uint64_t bytes = sizeof( header );
+        for( uint32_t i = 0; i < protocol::stream::count && result; i++ ){
+            if( header.streams & ( 1 << i ) ){
+                result = client->socket.send( &frame->images[i], sizeof( protocol::image_header ) ) && client->socket.send( frame->payloads[i].data(), frame->payloads[i].size() );
+                bytes += sizeof( protocol::image_header ) + frame->payloads[i].size();
+            }
+        }
+
+        if( !result ){
+            break;
+        }
+
+        client->sent_frames++;
+        client->sent_bytes += bytes;
+    }
+
+    client->running = false;
+}
+
+// Report
+void server::report()
+{
+    if( !encoded_frames ){
+        return;
+    }
+
+    std::cout << "encoded " << encoded_frames << " frames (skipped " << skipped_frames << "), "
+              << encode_time / encoded_frames << " ms/frame, compression "
+              << static_cast<double>( raw_bytes ) / std::max<uint64_t>( encoded_bytes, 1 ) << ":1" << std::endl;
+}
@@ -0,0 +1,103 @@
+#ifndef __SERVER__
+#define __SERVER__
+
+#include <k4a/k4a.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "protocol.hpp"
+#include "socket.hpp"
+
+class server
+{
+private:
+    // Encoded Frame (shared by all sessions)
+    struct packet
+    {
+        protocol::frame_header header;
+        protocol::image_header images[protocol::stream::count];
+        std::vector<uint8_t> payloads[protocol::stream::count];
+    };
+
+    // Client Session
+    struct session
+    {
+        network::socket socket;
+        protocol::request request;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::shared_ptr<const packet> pending;
+        std::atomic<bool> running;
+        uint64_t sent_frames;
+        uint64_t dropped_frames;
+        uint64_t sent_bytes;
+
+        session( network::socket&& socket )
+            : socket( std::move( socket ) ), request(), running( true ), sent_frames( 0 ), dropped_frames( 0 ), sent_bytes( 0 )
+        {
+        }
+    };
+
+    // Network
+    network::socket listener;
+    std::thread accept_thread;
+    std::mutex sessions_mutex;
+    std::vector<std::shared_ptr<session>> sessions;
+    std::atomic<bool> running;
+
+    // Encoder
+    std::thread encode_thread;
+    std::mutex encode_mutex;
+    std::condition_variable encode_condition;
+    k4a::capture pending_capture;
+    int64_t pending_timestamp;
+    uint64_t frame_number;
+    uint64_t encoded_frames;
+    uint64_t skipped_frames;
+    uint64_t raw_bytes;
+    uint64_t encoded_bytes;
+    double encode_time;
+
+public:
+    // Constructor
+    server( const uint16_t port = protocol::default_port );
+
+    // Destructor
+    ~server();
+
+    // Publish Capture (never blocks on encoding or network)
+    void publish( const k4a::capture& capture );
+
+    // Get Number of Connected Clients
+    size_t get_num_clients();
+
+private:
+    // Accept Clients
+    void accept();
+
+    // Encode Captures
+    void encode();
+
+    // Send Frames to Client
+    void send( const std::shared_ptr<session> client );
+
+    // Encode Capture
+    std::shared_ptr<packet> encode_capture( const k4a::capture& capture, const int64_t timestamp );
+
+    // Encode Image
+    void encode_image( const k4a::image& image, protocol::image_header& header, std::vector<uint8_t>& payload );
+
+    // Distribute Packet to Sessions
+    void distribute( const std::shared_ptr<const packet>& packet );
+
+    // Report Statistics
+    void report();
+};
+
+#endif // __SERVER__
@@ -0,0 +1,223 @@
+#ifndef __SOCKET__
+#define __SOCKET__
+
+#include <k4a/k4a.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int socket_t;
+#define INVALID_SOCKET ( -1 )
+#endif
+
+/*
+ This is minimal TCP socket wrapper for Windows (Winsock) and POSIX.
+*/
+
+namespace network
+{
+    // Initialize Socket Library (once per process)
+    inline void startup()
+    {
+        #ifdef _WIN32
+        static const bool initialized = [](){
+            WSADATA data;
+            return WSAStartup( MAKEWORD( 2, 2 ), &data ) == 0;
+        }();
+        if( !initialized ){
+            throw k4a::error( "Failed to initialize socket library!" );
+        }
+        #endif
+    }
+
+    // TCP Socket
+    class socket
+    {
+    private:
+        socket_t handle;
+
+    public:
+        // Constructor
+        explicit socket( const socket_t handle = INVALID_SOCKET )
+            : handle( handle )
+        {
+        }
+
+        // Move Constructor
+        socket( socket&& other )
+            : handle( other.handle )
+        {
+            other.handle = INVALID_SOCKET;
+        }
+
+        // Move Assignment
+        socket& operator=( socket&& other )
+        {
+            if( this != &other ){
+                close();
+                handle = other.handle;
+                other.handle = INVALID_SOCKET;
+            }
+            return *this;
+        }
+
+        // Destructor
+        ~socket()
+        {
+            close();
+        }
+
+        // Check Valid
+        bool is_valid() const
+        {
+            return handle != INVALID_SOCKET;
+        }
+
+        // Listen
+        static socket listen( const uint16_t port )
+        {
+            startup();
+
+            socket server( ::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP ) );
+            if( !server.is_valid() ){
+                throw k4a::error( "Failed to create socket!" );
+            }
+
+            const int32_t reuse = 1;
+            setsockopt( server.handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuse ), sizeof( reuse ) );
+
+            sockaddr_in address = {};
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl( INADDR_ANY );
+            address.sin_port        = htons( port );
+            if( ::bind( server.handle, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 || ::listen( server.handle, SOMAXCONN ) != 0 ){
+                throw k4a::error( "Failed to listen port!" );
+            }
+
+            return server;
+        }
+
+        // Connect
+        static socket connect( const std::string& host, const uint16_t port )
+        {
+            startup();
+
+            addrinfo hints = {};
+            hints.ai_family   = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_protocol = IPPROTO_TCP;
+
+            addrinfo* result = nullptr;
+            if( getaddrinfo( host.c_str(), std::to_string( port ).c_str(), &hints, &result ) != 0 || !result ){
+                throw k4a::error( "Failed to resolve host!" );
+            }
+
+            socket client( ::socket( result->ai_family, result->ai_socktype, result->ai_protocol ) );
+            const bool connected = client.is_valid() && ::connect( client.handle, result->ai_addr, static_cast<int32_t>( result->ai_addrlen ) ) == 0;
+            freeaddrinfo( result );
+            if( !connected ){
+                throw k4a::error( "Failed to connect host!" );
+            }
+
+            client.set_no_delay();
+            return client;
+        }
+
+        // Accept (returns invalid socket if server was closed)
+        socket accept()
+        {
+            socket client( ::accept( handle, nullptr, nullptr ) );
+            if( client.is_valid() ){
+                client.set_no_delay();
+            }
+            return client;
+        }
+
+        // Send All Bytes
+        bool send( const void* data, const size_t size )
+        {
+            const char* buffer = static_cast<const char*>( data );
+            size_t sent = 0;
+            while( sent < size ){
+                const int32_t chunk = static_cast<int32_t>( std::min<size_t>( size - sent, 1 << 30 ) );
+                #ifdef MSG_NOSIGNAL
+                const int32_t result = static_cast<int32_t>( ::send( handle, buffer + sent, chunk, MSG_NOSIGNAL ) );
+                #else
+                const int32_t result = static_cast<int32_t>( ::send( handle, buffer + sent, chunk, 0 ) );
+                #endif
+                if( result <= 0 ){
+                    return false;
+                }
+                sent += result;
+            }
+            return true;
+        }
+
+        // Receive All Bytes
+        bool receive( void* data, const size_t size )
+        {
+            char* buffer = static_cast<char*>( data );
+            size_t received = 0;
+            while( received < size ){
+                const int32_t chunk = static_cast<int32_t>( std::min<size_t>( size - received, 1 << 30 ) );
+                const int32_t result = static_cast<int32_t>( ::recv( handle, buffer + received, chunk, 0 ) );
+                if( result <= 0 ){
+                    return false;
+                }
+                received += result;
+            }
+            return true;
+        }
+
+        // Shutdown (unblocks pending accept/send/receive of other threads)
+        void shutdown()
+        {
+            if( is_valid() ){
+                #ifdef _WIN32
+                ::shutdown( handle, SD_BOTH );
+                #else
+                ::shutdown( handle, SHUT_RDWR );
+                #endif
+            }
+        }
+
+        // Close
+        void close()
+        {
+            if( is_valid() ){
+                #ifdef _WIN32
+                closesocket( handle );
+                #else
+                ::close( handle );
+                #endif
+                handle = INVALID_SOCKET;
+            }
+        }
+
+    private:
+        socket( const socket& ) = delete;
+        socket& operator=( const socket& ) = delete;
+
+        // Disable Nagle Algorithm for Low Latency
+        void set_no_delay()
+        {
+            const int32_t no_delay = 1;
+            setsockopt( handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>( &no_delay ), sizeof( no_delay ) );
+        }
+    };
+}
+
+#endif // __SOCKET__
@@ -0,0 +1,138 @@
+#include "benchmark.hpp"
+#include "hugepage.hpp"
+
+#include <k4a/k4a.hpp>
+#include <k4arecord/playback.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Frame Buffers of Conversion and Transformation Stages
+    struct stages
+    {
+        hugepage::frame_buffer decoded_buffer;
+        hugepage::frame_buffer color_buffer;
+        hugepage::frame_buffer transformed_color_buffer;
+        hugepage::frame_buffer transformed_depth_buffer;
+
+        cv::Mat decoded;
+        k4a::image color_image;
+        k4a::image transformed_color_image;
+        k4a::image transformed_depth_image;
+    };
+
+    // Convert Color Image to BGRA Image
+    void convert_color( const k4a::image& source, stages& target, const hugepage::backing type )
+    {
+        const int32_t width = source.get_width_pixels();
+        const int32_t height = source.get_height_pixels();
+        hugepage::create_image( target.color_image, target.color_buffer, K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, type );
+        cv::Mat color( height, width, CV_8UC4, target.color_image.get_buffer(), target.color_image.get_stride_bytes() );
+
+        uint8_t* buffer = const_cast<uint8_t*>( source.get_buffer() );
+        switch( source.get_format() )
+        {
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_MJPG:
+            {
+                // Decode into Frame Buffer (cv::imdecode reuses destination of same size and type)
+                hugepage::create_mat( target.decoded, target.decoded_buffer, cv::Size( width, height ), CV_8UC3, type );
+                cv::imdecode( cv::Mat( 1, static_cast<int32_t>( source.get_size() ), CV_8UC1, buffer ), cv::IMREAD_COLOR, &target.decoded );
+                cv::cvtColor( target.decoded, color, cv::COLOR_BGR2BGRA );
+                break;
+            }
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_NV12:
+                cv::cvtColor( cv::Mat( height + height / 2, width, CV_8UC1, buffer, source.get_stride_bytes() ), color, cv::COLOR_YUV2BGRA_NV12 );
+                break;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_YUY2:
+                cv::cvtColor( cv::Mat( height, width, CV_8UC2, buffer, source.get_stride_bytes() ), color, cv::COLOR_YUV2BGRA_YUY2 );
+                break;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                cv::Mat( height, width, CV_8UC4, buffer, source.get_stride_bytes() ).copyTo( color );
+                break;
+            default:
+                throw k4a::error( "Failed to convert this format!" );
+        }
+    }
+
+    // Transform Images between Cameras into Frame Buffers
+    void transform( const k4a::transformation& transformation, const k4a::image& depth_image, stages& target, const hugepage::backing type )
+    {
+        const k4a::image& color_image = target.color_image;
+        hugepage::create_image( target.transformed_color_image, target.transformed_color_buffer, K4A_IMAGE_FORMAT_COLOR_BGRA32, depth_image.get_width_pixels(), depth_image.get_height_pixels(), type );
+        transformation.color_image_to_depth_camera( depth_image, color_image, &target.transformed_color_image );
+
+        hugepage::create_image( target.transformed_depth_image, target.transformed_depth_buffer, K4A_IMAGE_FORMAT_DEPTH16, color_image.get_width_pixels(), color_image.get_height_pixels(), type );
+        transformation.depth_image_to_color_camera( depth_image, &target.transformed_depth_image );
+    }
+}
+
+// Benchmark Frame Buffer Backings
+void benchmark_hugepages( const std::string& file, const uint32_t frames )
+{
+    // Open Playback
+    k4a::playback playback = k4a::playback::open( file.c_str() );
+    const k4a_record_configuration_t configuration = playback.get_record_configuration();
+    if( !configuration.color_track_enabled || !configuration.depth_track_enabled ){
+        throw k4a::error( "Failed to benchmark (recording needs color and depth tracks)!" );
+    }
+
+    // Create Transformation
+    const k4a::calibration calibration = playback.get_calibration();
+    k4a::transformation transformation( calibration );
+
+    std::cout << "color    : " << calibration.color_camera_calibration.resolution_width << "x" << calibration.color_camera_calibration.resolution_height << std::endl;
+    std::cout << "system   : " << hugepage::get_system_status() << std::endl;
+
+    const std::vector<hugepage::backing> backings = { hugepage::backing::heap, hugepage::backing::pages, hugepage::backing::transparent, hugepage::backing::hugetlb };
+    for( const hugepage::backing type : backings ){
+        // Rewind Playback
+        playback.seek_timestamp( std::chrono::microseconds( 0 ), K4A_PLAYBACK_SEEK_BEGIN );
+
+        stages target;
+        hugepage::memory_counters counters;
+        double time = 0.0;
+        uint32_t count = 0;
+
+        k4a::capture capture;
+        while( count <= frames && playback.get_next_capture( &capture ) ){
+            const k4a::image color_image = capture.get_color_image();
+            const k4a::image depth_image = capture.get_depth_image();
+            if( !color_image.handle() || !depth_image.handle() ){
+                continue;
+            }
+
+            // Conversion and Transformation (first frame allocates frame buffers and is excluded as warm-up)
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            counters.start();
+            convert_color( color_image, target, type );
+            transform( transformation, depth_image, target, type );
+            counters.stop();
+            const double elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+            if( !count ){
+                counters.reset();
+            }
+            else{
+                time += elapsed;
+            }
+            count++;
+        }
+
+        if( count < 2 ){
+            std::cout << "no color and depth frames in " << file << std::endl;
+            break;
+        }
+
+        // Report
+        const uint32_t measured = count - 1;
+        const hugepage::backing actual = ( type == hugepage::backing::heap ) ? type : target.color_buffer.get_backing();
+        std::cout << hugepage::describe( type ) << " (" << hugepage::describe( actual ) << ") : " << time / measured << " ms/frame" << std::endl;
+        counters.report( std::cout, "    " + hugepage::describe( type ), measured );
+    }
+
+    // Close Playback
+    playback.close();
+}
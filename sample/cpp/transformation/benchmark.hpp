@@ -0,0 +1,11 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <cstdint>
+#include <string>
+
+// Benchmark Frame Buffer Backings on Color Conversion and Transformation of Recorded Color and Depth Tracks (2160p recommended)
+// Each backing (heap, pages, transparent, hugetlb) runs same frames, reports time, page faults and dTLB load misses per frame.
+void benchmark_hugepages( const std::string& file, const uint32_t frames = 100 );
+
+#endif // __BENCHMARK__
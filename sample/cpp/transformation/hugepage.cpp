@@ -0,0 +1,401 @@
+#include "hugepage.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#if defined( _WIN32 )
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define PSAPI_VERSION 2
+#include <psapi.h>
+#elif defined( __linux__ )
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Round Up to Multiple of Alignment
+    size_t round_up( const size_t value, const size_t alignment )
+    {
+        return ( value + alignment - 1 ) / alignment * alignment;
+    }
+
+    // Read First Line of File (empty if not exists)
+    std::string read_line( const std::string& file )
+    {
+        std::ifstream stream( file );
+        std::string line;
+        std::getline( stream, line );
+        return line;
+    }
+
+    // Get Bytes per Pixel of Image Format
+    int32_t get_bytes_per_pixel( const k4a_image_format_t format )
+    {
+        switch( format )
+        {
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32:
+                return 4;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_DEPTH16:
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_IR16:
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_CUSTOM16:
+                return 2;
+            case k4a_image_format_t::K4A_IMAGE_FORMAT_CUSTOM8:
+                return 1;
+            default:
+                throw k4a::error( "Failed to create image on frame buffer for this format!" );
+        }
+    }
+
+    // Read Page Faults of Process
+    void read_faults( uint64_t& minor, uint64_t& major )
+    {
+        minor = 0;
+        major = 0;
+        #if defined( _WIN32 )
+        PROCESS_MEMORY_COUNTERS counters;
+        if( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ){
+            minor = counters.PageFaultCount;
+        }
+        #elif defined( __linux__ )
+        rusage usage;
+        if( getrusage( RUSAGE_SELF, &usage ) == 0 ){
+            minor = static_cast<uint64_t>( usage.ru_minflt );
+            major = static_cast<uint64_t>( usage.ru_majflt );
+        }
+        #endif
+    }
+
+    // Read Counter
+    uint64_t read_counter( const int32_t descriptor )
+    {
+        uint64_t value = 0;
+        #if defined( __linux__ )
+        if( descriptor >= 0 && read( descriptor, &value, sizeof( value ) ) != sizeof( value ) ){
+            value = 0;
+        }
+        #endif
+        return value;
+    }
+}
+
+namespace hugepage
+{
+    // Parse Backing
+    backing parse( const std::string& text )
+    {
+        if( text == "heap" ){
+            return backing::heap;
+        }
+        if( text == "pages" ){
+            return backing::pages;
+        }
+        if( text == "transparent" ){
+            return backing::transparent;
+        }
+        if( text == "hugetlb" ){
+            return backing::hugetlb;
+        }
+        throw k4a::error( "Failed to parse backing \"" + text + "\" (heap, pages, transparent, hugetlb)!" );
+    }
+
+    // Get Name of Backing
+    std::string describe( const backing type )
+    {
+        switch( type )
+        {
+            case backing::heap:
+                return "heap";
+            case backing::pages:
+                return "pages";
+            case backing::transparent:
+                return "transparent";
+            case backing::hugetlb:
+                return "hugetlb";
+        }
+        return "unknown";
+    }
+
+    // Get Huge Page Size
+    size_t get_huge_page_size()
+    {
+        #if defined( _WIN32 )
+        const size_t large = GetLargePageMinimum();
+        return large ? large : 2 * 1024 * 1024;
+        #else
+        // "Hugepagesize:    2048 kB"
+        std::ifstream stream( "/proc/meminfo" );
+        std::string line;
+        while( std::getline( stream, line ) ){
+            if( line.compare( 0, 13, "Hugepagesize:" ) == 0 ){
+                return static_cast<size_t>( std::stoull( line.substr( 13 ) ) ) * 1024;
+            }
+        }
+        return 2 * 1024 * 1024;
+        #endif
+    }
+
+    // Get Status of Huge Pages on System
+    std::string get_system_status()
+    {
+        #if defined( __linux__ )
+        std::ostringstream stream;
+        const std::string enabled = read_line( "/sys/kernel/mm/transparent_hugepage/enabled" );
+        const std::string reserved = read_line( "/proc/sys/vm/nr_hugepages" );
+        stream << "transparent huge pages: " << ( enabled.empty() ? "unavailable" : enabled ) << ", ";
+        stream << "reserved huge pages: " << ( reserved.empty() ? "0" : reserved ) << " x " << get_huge_page_size() / 1024 << " KB";
+        return stream.str();
+        #elif defined( _WIN32 )
+        return "large page minimum: " + std::to_string( GetLargePageMinimum() / 1024 ) + " KB (needs SeLockMemoryPrivilege)";
+        #else
+        return "huge pages unavailable";
+        #endif
+    }
+
+    // Frame Buffer
+    frame_buffer::frame_buffer()
+        : data( nullptr ),
+          mapping( nullptr ),
+          size( 0 ),
+          length( 0 ),
+          request( backing::heap ),
+          type( backing::heap )
+    {
+    }
+
+    frame_buffer::~frame_buffer()
+    {
+        free();
+    }
+
+    // Free
+    void frame_buffer::free()
+    {
+        if( !mapping ){
+            return;
+        }
+
+        #if defined( _WIN32 )
+        VirtualFree( mapping, 0, MEM_RELEASE );
+        #elif defined( __linux__ )
+        munmap( mapping, length );
+        #else
+        std::free( mapping );
+        #endif
+
+        data = nullptr;
+        mapping = nullptr;
+        size = 0;
+        length = 0;
+    }
+
+    // Allocate
+    void frame_buffer::allocate( const size_t bytes, const backing requested )
+    {
+        // Free Previous Buffer
+        free();
+
+        request = requested;
+        type = ( requested == backing::heap ) ? backing::pages : requested;
+        if( !bytes ){
+            return;
+        }
+
+        const size_t huge_page = get_huge_page_size();
+
+        #if defined( _WIN32 )
+        // Large Pages (fall back to normal pages, no transparent huge pages on Windows)
+        if( type == backing::hugetlb ){
+            length = round_up( bytes, huge_page );
+            mapping = VirtualAlloc( nullptr, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+        }
+        if( !mapping ){
+            type = backing::pages;
+            length = bytes;
+            mapping = VirtualAlloc( nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+        }
+        data = mapping;
+        #elif defined( __linux__ )
+        // Explicit Huge Pages (fails if not enough pages are reserved)
+        if( type == backing::hugetlb ){
+            length = round_up( bytes, huge_page );
+            void* mapped = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+            if( mapped != MAP_FAILED ){
+                mapping = mapped;
+                data = mapped;
+            }
+            else{
+                type = backing::transparent;
+            }
+        }
+
+        // Transparent Huge Pages (mapping is over-allocated to align start of data to huge page)
+        if( type == backing::transparent ){
+            length = round_up( bytes, huge_page ) + huge_page;
+            void* mapped = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+            if( mapped != MAP_FAILED ){
+                mapping = mapped;
+                data = reinterpret_cast<void*>( round_up( reinterpret_cast<uintptr_t>( mapped ), huge_page ) );
+                if( madvise( data, round_up( bytes, huge_page ), MADV_HUGEPAGE ) != 0 ){
+                    type = backing::pages;
+                }
+            }
+        }
+
+        // Normal Pages
+        if( !mapping ){
+            type = backing::pages;
+            length = bytes;
+            void* mapped = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+            if( mapped != MAP_FAILED ){
+                mapping = mapped;
+                data = mapped;
+            }
+        }
+        #else
+        type = backing::pages;
+        length = bytes;
+        mapping = std::malloc( length );
+        data = mapping;
+        #endif
+
+        if( !data ){
+            mapping = nullptr;
+            length = 0;
+            throw std::bad_alloc();
+        }
+        size = bytes;
+
+        // Fault in Pages from Calling Thread (no page faults in steady state)
+        std::memset( data, 0, bytes );
+    }
+
+    // Create Mat on Buffer
+    void create_mat( cv::Mat& mat, frame_buffer& buffer, const cv::Size& size, const int32_t type, const backing requested )
+    {
+        // New Allocation per Frame (baseline)
+        if( requested == backing::heap ){
+            mat = cv::Mat( size, type );
+            return;
+        }
+
+        if( mat.data && mat.data == buffer.get_data() && mat.size() == size && mat.type() == type ){
+            return;
+        }
+
+        const size_t bytes = static_cast<size_t>( size.area() ) * CV_ELEM_SIZE( type );
+        if( buffer.get_size() < bytes || buffer.get_requested() != requested ){
+            mat.release();
+            buffer.allocate( bytes, requested );
+        }
+        mat = cv::Mat( size, type, buffer.get_data() );
+    }
+
+    // Create Image on Buffer
+    void create_image( k4a::image& image, frame_buffer& buffer, const k4a_image_format_t format, const int32_t width, const int32_t height, const backing requested )
+    {
+        const int32_t stride = width * get_bytes_per_pixel( format );
+
+        // New Allocation per Frame (baseline)
+        if( requested == backing::heap ){
+            image = k4a::image::create( format, width, height, stride );
+            return;
+        }
+
+        if( image.handle() && image.get_buffer() == buffer.get_data() && image.get_format() == format && image.get_width_pixels() == width && image.get_height_pixels() == height ){
+            return;
+        }
+
+        const size_t bytes = static_cast<size_t>( stride ) * height;
+        if( buffer.get_size() < bytes || buffer.get_requested() != requested ){
+            image.reset();
+            buffer.allocate( bytes, requested );
+        }
+
+        // Image does not own buffer (no release callback)
+        image = k4a::image::create_from_buffer( format, width, height, stride, static_cast<uint8_t*>( buffer.get_data() ), bytes, nullptr, nullptr );
+    }
+
+    // Memory Counters
+    memory_counters::memory_counters()
+        : tlb_descriptor( -1 ),
+          minor_faults( 0 ),
+          major_faults( 0 ),
+          tlb_misses( 0 ),
+          start_minor( 0 ),
+          start_major( 0 ),
+          start_tlb( 0 )
+    {
+        #if defined( __linux__ )
+        // Open dTLB Load Miss Counter of Calling Thread (user space)
+        perf_event_attr attribute;
+        std::memset( &attribute, 0, sizeof( attribute ) );
+        attribute.type = PERF_TYPE_HW_CACHE;
+        attribute.size = sizeof( attribute );
+        attribute.config = PERF_COUNT_HW_CACHE_DTLB | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+        attribute.exclude_kernel = 1;
+        attribute.exclude_hv = 1;
+        tlb_descriptor = static_cast<int32_t>( syscall( SYS_perf_event_open, &attribute, 0, -1, -1, 0 ) );
+        #endif
+    }
+
+    memory_counters::~memory_counters()
+    {
+        #if defined( __linux__ )
+        if( tlb_descriptor >= 0 ){
+            close( tlb_descriptor );
+        }
+        #endif
+    }
+
+    // Start Measurement
+    void memory_counters::start()
+    {
+        read_faults( start_minor, start_major );
+        start_tlb = read_counter( tlb_descriptor );
+    }
+
+    // Stop Measurement
+    void memory_counters::stop()
+    {
+        uint64_t minor, major;
+        read_faults( minor, major );
+        minor_faults += minor - start_minor;
+        major_faults += major - start_major;
+        tlb_misses += read_counter( tlb_descriptor ) - start_tlb;
+    }
+
+    // Reset Accumulated Counts
+    void memory_counters::reset()
+    {
+        minor_faults = 0;
+        major_faults = 0;
+        tlb_misses = 0;
+    }
+
+    // Report Counts per Frame
+    void memory_counters::report( std::ostream& stream, const std::string& name, const uint64_t frames ) const
+    {
+        const double count = static_cast<double>( frames ? frames : 1 );
+        stream << name << " : " << frames << " frames, "
+               << minor_faults / count << " minor faults/frame, "
+               << major_faults / count << " major faults/frame, ";
+        if( has_tlb_misses() ){
+            stream << tlb_misses / count << " dTLB load misses/frame";
+        }
+        else{
+            stream << "dTLB load misses n/a (perf_event_open not permitted)";
+        }
+        stream << std::endl;
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef __HUGEPAGE__
+#define __HUGEPAGE__
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <k4a/k4a.hpp>
+#include <opencv2/opencv.hpp>
+
+/*
+ This is huge page backed frame buffers for large (4K) color pipelines.
+
+ hugepage::frame_buffer buffer;
+ hugepage::create_mat( mat, buffer, size, CV_8UC4, hugepage::backing::transparent );       // cv::Mat on buffer
+ hugepage::create_image( image, buffer, K4A_IMAGE_FORMAT_DEPTH16, width, height, backing ); // k4a::image on buffer
+
+ 3840x2160 BGRA frame is ~33 MB. Deep copy into new cv::Mat per frame allocates with mmap (above malloc threshold)
+ and faults ~8100 pages of 4 KB every frame, and every pass over frame walks as many TLB entries.
+ Frame buffer is allocated once and reused, so that steady state has no page faults,
+ and it is backed by huge pages (2 MB), so that frame needs ~17 TLB entries.
+
+ backing::heap        : new allocation per frame (default of sample, baseline)
+ backing::pages       : reused buffer of normal pages
+ backing::transparent : reused buffer of transparent huge pages (2 MB aligned, madvise( MADV_HUGEPAGE ))
+ backing::hugetlb     : reused buffer of explicit huge pages (MAP_HUGETLB, needs reserved pages in /proc/sys/vm/nr_hugepages)
+                        (Windows: MEM_LARGE_PAGES, needs SeLockMemoryPrivilege)
+ If huge pages are not available, buffer falls back to next backing (hugetlb -> transparent -> pages).
+
+ k4a::image created on buffer does not own memory, image must be released before buffer.
+*/
+
+namespace hugepage
+{
+    // Backing of Frame Buffer
+    enum class backing
+    {
+        heap,
+        pages,
+        transparent,
+        hugetlb
+    };
+
+    // Parse Backing ( "heap", "pages", "transparent", "hugetlb" )
+    backing parse( const std::string& text );
+
+    // Get Name of Backing
+    std::string describe( const backing type );
+
+    // Get Huge Page Size [bytes] (2 MB if unknown)
+    size_t get_huge_page_size();
+
+    // Get Status of Huge Pages on System (transparent huge pages mode, reserved huge pages)
+    std::string get_system_status();
+
+    // Frame Buffer
+    class frame_buffer
+    {
+    private:
+        void* data;      // aligned data
+        void* mapping;   // start of mapping
+        size_t size;     // requested bytes
+        size_t length;   // mapped bytes
+        backing request; // requested backing
+        backing type;    // actual backing (after fallback)
+
+    public:
+        frame_buffer();
+        ~frame_buffer();
+        frame_buffer( const frame_buffer& ) = delete;
+        frame_buffer& operator=( const frame_buffer& ) = delete;
+
+        // Allocate (previous buffer is freed, pages are faulted in by calling thread)
+        void allocate( const size_t bytes, const backing requested );
+
+        // Free
+        void free();
+
+        void* get_data() const { return data; }
+        size_t get_size() const { return size; }
+        backing get_requested() const { return request; }
+        backing get_backing() const { return type; }
+    };
+
+    // Create Mat on Buffer (reallocates only if size, type or backing changed, backing::heap creates new Mat every call)
+    void create_mat( cv::Mat& mat, frame_buffer& buffer, const cv::Size& size, const int32_t type, const backing requested );
+
+    // Create Image on Buffer (reallocates only if size, format or backing changed, backing::heap creates new image every call)
+    void create_image( k4a::image& image, frame_buffer& buffer, const k4a_image_format_t format, const int32_t width, const int32_t height, const backing requested );
+
+    // Memory Counters (page faults of process, dTLB load misses of calling thread)
+    class memory_counters
+    {
+    private:
+        int32_t tlb_descriptor;
+        uint64_t minor_faults;
+        uint64_t major_faults;
+        uint64_t tlb_misses;
+        uint64_t start_minor;
+        uint64_t start_major;
+        uint64_t start_tlb;
+
+    public:
+        memory_counters();
+        ~memory_counters();
+        memory_counters( const memory_counters& ) = delete;
+        memory_counters& operator=( const memory_counters& ) = delete;
+
+        // Start Measurement
+        void start();
+
+        // Stop Measurement (accumulates since start)
+        void stop();
+
+        // Reset Accumulated Counts
+        void reset();
+
+        // TLB Misses are Available (needs perf_event_paranoid <= 2 on Linux)
+        bool has_tlb_misses() const { return tlb_descriptor >= 0; }
+
+        uint64_t get_minor_faults() const { return minor_faults; }
+        uint64_t get_major_faults() const { return major_faults; }
+        uint64_t get_tlb_misses() const { return tlb_misses; }
+
+        // Report Counts per Frame
+        void report( std::ostream& stream, const std::string& name, const uint64_t frames ) const;
+    };
+}
+
+#endif // __HUGEPAGE__
@@ -1,11 +1,16 @@
 #include "kinect.hpp"
 #include "util.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 
 // Constructor
-kinect::kinect( const uint32_t index )
-    : device_index( index )
+kinect::kinect( const uint32_t index, const hugepage::backing frame_backing, const k4a_color_resolution_t color_resolution )
+    : device_index( index ),
+      color_resolution( color_resolution ),
+      frame_backing( frame_backing ),
+      counted_frames( 0 )
 {
     // Initialize
     initialize();
@@ -39,12 +44,15 @@ inline void kinect::initialize_sensor()
     // Start Cameras with Configuration
     device_configuration = K4A_DEVICE_CONFIG_INIT_DISABLE_ALL;
     device_configuration.color_format             = k4a_image_format_t::K4A_IMAGE_FORMAT_COLOR_BGRA32;
-    device_configuration.color_resolution         = k4a_color_resolution_t::K4A_COLOR_RESOLUTION_720P;
+    device_configuration.color_resolution         = color_resolution;
     device_configuration.depth_mode               = k4a_depth_mode_t::K4A_DEPTH_MODE_NFOV_UNBINNED;
     device_configuration.synchronized_images_only = true;
     device_configuration.wired_sync_mode          = k4a_wired_sync_mode_t::K4A_WIRED_SYNC_MODE_STANDALONE;
     device.start_cameras( &device_configuration );
 
+    // Create Capture Poller
+    poller = capture_poller( &device, device_configuration.camera_fps );
+
     // Get Calibration
     calibration = device.get_calibration( device_configuration.depth_mode, device_configuration.color_resolution );
 
@@ -55,6 +63,18 @@ inline void kinect::initialize_sensor()
 // Finalize
 void kinect::finalize()
 {
+    // Report Capture Statistics
+    poller.report( std::cout );
+    loop.report( std::cout );
+
+    // Report Frame Buffers
+    std::cout << "frame buffers : " << hugepage::describe( frame_backing );
+    if( frame_backing != hugepage::backing::heap ){
+        std::cout << " (" << hugepage::describe( color_buffer.get_backing() ) << ")";
+    }
+    std::cout << ", " << hugepage::get_system_status() << std::endl;
+    counters.report( std::cout, "update and draw", counted_frames );
+
     // Destroy Transformation
     transformation.destroy();
 
@@ -72,18 +92,33 @@ void kinect::finalize()
 void kinect::run()
 {
     // Main Loop
+    bool updated = false;
     while( true ){
-        // Update
-        update();
+        // Update (as soon as next frame is ready)
+        counters.start();
+        if( update() ){
+            // Draw
+            draw();
+            counters.stop();
+            counted_frames++;
+
+            loop.count_frame();
+            updated = true;
+        }
 
-        // Draw
-        draw();
+        // Refresh UI at fixed rate independent from frame rate
+        if( !loop.is_ui_due() ){
+            continue;
+        }
 
         // Show
-        show();
+        if( updated ){
+            show();
+            updated = false;
+        }
 
         // Wait Key
-        constexpr int32_t delay = 30;
+        constexpr int32_t delay = 1;
         const int32_t key = cv::waitKey( delay );
         if( key == 'q' ){
             break;
@@ -92,10 +127,12 @@ void kinect::run()
 }
 
 // Update
-void kinect::update()
+bool kinect::update()
 {
     // Update Frame
-    update_frame();
+    if( !update_frame() ){
+        return false;
+    }
 
     // Update Color
     update_color();
@@ -108,17 +145,16 @@ void kinect::update()
 
     // Release Capture Handle
     capture.reset();
+
+    return true;
 }
 
 // Update Frame
-inline void kinect::update_frame()
+inline bool kinect::update_frame()
 {
-    // Get Capture Frame
-    constexpr std::chrono::milliseconds time_out( K4A_WAIT_INFINITE );
-    const bool result = device.get_capture( &capture, time_out );
-    if( !result ){
-        this->~kinect();
-    }
+    // Poll Capture Frame (waits until next frame or UI refresh is due)
+    const std::chrono::milliseconds time_out = std::min( poller.get_adaptive_time_out(), loop.get_time_out() );
+    return poller.poll( &capture, time_out ) == capture_poller::status::ready;
 }
 
 // Update Color
@@ -142,11 +178,13 @@ inline void kinect::update_transformation()
         return;
     }
 
-    // Transform Color Image to Depth Camera
-    transformed_color_image = transformation.color_image_to_depth_camera( depth_image, color_image );
+    // Transform Color Image to Depth Camera (into frame buffer)
+    hugepage::create_image( transformed_color_image, transformed_color_buffer, K4A_IMAGE_FORMAT_COLOR_BGRA32, depth_image.get_width_pixels(), depth_image.get_height_pixels(), frame_backing );
+    transformation.color_image_to_depth_camera( depth_image, color_image, &transformed_color_image );
 
-    // Transform Depth Image to Color Camera
-    transformed_depth_image = transformation.depth_image_to_color_camera( depth_image );
+    // Transform Depth Image to Color Camera (into frame buffer)
+    hugepage::create_image( transformed_depth_image, transformed_depth_buffer, K4A_IMAGE_FORMAT_DEPTH16, color_image.get_width_pixels(), color_image.get_height_pixels(), frame_backing );
+    transformation.depth_image_to_color_camera( depth_image, &transformed_depth_image );
 }
 
 // Draw
@@ -169,8 +207,9 @@ inline void kinect::draw_color()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    color = k4a::get_mat( color_image );
+    // Get cv::Mat from k4a::image (copy into frame buffer)
+    hugepage::create_mat( color, color_buffer, cv::Size( color_image.get_width_pixels(), color_image.get_height_pixels() ), CV_8UC4, frame_backing );
+    k4a::get_mat( color_image, false ).copyTo( color );
 
     // Release Color Image Handle
     color_image.reset();
@@ -183,8 +222,9 @@ inline void kinect::draw_depth()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    depth = k4a::get_mat( depth_image );
+    // Get cv::Mat from k4a::image (copy into frame buffer)
+    hugepage::create_mat( depth, depth_buffer, cv::Size( depth_image.get_width_pixels(), depth_image.get_height_pixels() ), CV_16UC1, frame_backing );
+    k4a::get_mat( depth_image, false ).copyTo( depth );
 
     // Release Depth Image Handle
     depth_image.reset();
@@ -197,9 +237,10 @@ inline void kinect::draw_transformation()
         return;
     }
 
-    // Get cv::Mat from k4a::image
-    transformed_color = k4a::get_mat( transformed_color_image );
-    transformed_depth = k4a::get_mat( transformed_depth_image );
+    // Get cv::Mat from k4a::image (transformed images are already in frame buffers, no copy)
+    const bool deep_copy = ( frame_backing == hugepage::backing::heap );
+    transformed_color = k4a::get_mat( transformed_color_image, deep_copy );
+    transformed_depth = k4a::get_mat( transformed_depth_image, deep_copy );
 
     // Release Transformed Image Handle
     transformed_color_image.reset();
@@ -4,6 +4,10 @@
 #include <k4a/k4a.hpp>
 #include <opencv2/opencv.hpp>
 
+#include "poller.hpp"
+#include "scheduler.hpp"
+#include "hugepage.hpp"
+
 class kinect
 {
 private:
@@ -14,6 +18,18 @@ private:
     k4a::transformation transformation;
     k4a_device_configuration_t device_configuration;
     uint32_t device_index;
+    k4a_color_resolution_t color_resolution;
+    capture_poller poller;
+    scheduler loop;
+
+    // Frame Buffers (declared before images and mats on them, so that they are released later)
+    hugepage::backing frame_backing;
+    hugepage::frame_buffer color_buffer;
+    hugepage::frame_buffer depth_buffer;
+    hugepage::frame_buffer transformed_color_buffer;
+    hugepage::frame_buffer transformed_depth_buffer;
+    hugepage::memory_counters counters;
+    uint64_t counted_frames;
 
     // Color
     k4a::image color_image;
@@ -31,7 +47,7 @@ private:
 
 public:
     // Constructor
-    kinect( const uint32_t index = K4A_DEVICE_DEFAULT );
+    kinect( const uint32_t index = K4A_DEVICE_DEFAULT, const hugepage::backing frame_backing = hugepage::backing::heap, const k4a_color_resolution_t color_resolution = K4A_COLOR_RESOLUTION_720P );
 
     // Destructor
     ~kinect();
@@ -40,7 +56,7 @@ public:
     void run();
 
     // Update
-    void update();
+    bool update();
 
     // Draw
     void draw();
@@ -59,7 +75,7 @@ private:
     void finalize();
 
     // Update Frame
-    void update_frame();
+    bool update_frame();
 
     // Update Color
     void update_color();
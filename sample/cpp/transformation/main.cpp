@@ -1,17 +1,57 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "kinect.hpp"
+#include "benchmark.hpp"
+
+namespace
+{
+    // Parse Color Resolution ( "720p", "1080p", "1440p", "1536p", "2160p", "3072p" )
+    k4a_color_resolution_t parse_resolution( const std::string& text )
+    {
+        if( text == "720p" ){
+            return K4A_COLOR_RESOLUTION_720P;
+        }
+        if( text == "1080p" ){
+            return K4A_COLOR_RESOLUTION_1080P;
+        }
+        if( text == "1440p" ){
+            return K4A_COLOR_RESOLUTION_1440P;
+        }
+        if( text == "1536p" ){
+            return K4A_COLOR_RESOLUTION_1536P;
+        }
+        if( text == "2160p" ){
+            return K4A_COLOR_RESOLUTION_2160P;
+        }
+        if( text == "3072p" ){
+            return K4A_COLOR_RESOLUTION_3072P;
+        }
+        throw k4a::error( "Failed to parse color resolution \"" + text + "\"!" );
+    }
+}
 
 int main( int argc, char* argv[] )
 {
     try{
-        kinect kinect;
-        kinect.run();
+        const std::string mode = ( argc > 1 ) ? argv[1] : "live";
+        if( mode == "benchmark" ){
+            // Recorded Color and Depth Tracks without Device (2160p recommended)
+            const std::string file = ( argc > 2 ) ? argv[2] : "../file.mkv";
+            benchmark_hugepages( file );
+        }
+        else{
+            // Device with Frame Buffer Backing and Color Resolution (e.g. "live transparent 2160p")
+            const hugepage::backing backing = ( argc > 2 ) ? hugepage::parse( argv[2] ) : hugepage::backing::heap;
+            const k4a_color_resolution_t resolution = ( argc > 3 ) ? parse_resolution( argv[3] ) : K4A_COLOR_RESOLUTION_720P;
+            kinect kinect( K4A_DEVICE_DEFAULT, backing, resolution );
+            kinect.run();
+        }
     }
     catch( const k4a::error& error ){
         std::cout << error.what() << std::endl;
     }
 
     return 0;
-}
\ No newline at end of file
+}